@@ -0,0 +1,162 @@
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+#include "arena.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const size_t ARENA_ALIGNMENT = alignof(std::max_align_t);
+
+static inline size_t arena_align(size_t size) {
+	return (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+/*************************************************************************************************/
+struct WarGrey::SCADA::Arena::Chunk {
+	Arena::Chunk* next;
+};
+
+struct WarGrey::SCADA::Arena::Record {
+	Arena* owner;
+	Arena::Record* next;
+};
+
+static const size_t ARENA_CHUNK_HEADER_SIZE = arena_align(sizeof(void*));
+static const size_t ARENA_RECORD_HEADER_SIZE = arena_align(sizeof(void*) * 2);
+
+/*************************************************************************************************/
+Arena::Arena(size_t record_size, size_t records_per_chunk)
+	: record_size(record_size), records_per_chunk((records_per_chunk == 0U) ? 1U : records_per_chunk)
+	, head_chunk(nullptr), cursor_chunk(nullptr), cursor_index(0U), free_records(nullptr), releasing(false)
+	, chunk_count(0U), used(0U), peak(0U), allocations(0U), recycles(0U), releases(0U) {
+	this->record_stride = ARENA_RECORD_HEADER_SIZE + arena_align(record_size);
+}
+
+Arena::~Arena() {
+	Arena::Chunk* chunk = this->head_chunk;
+
+	while (chunk != nullptr) {
+		Arena::Chunk* next = chunk->next;
+
+		std::free(chunk);
+		chunk = next;
+	}
+}
+
+void* Arena::allocate() {
+	Arena::Record* record = this->free_records;
+
+	if (record != nullptr) {
+		this->free_records = record->next;
+	} else {
+		if ((this->cursor_chunk == nullptr) || (this->cursor_index >= this->records_per_chunk)) {
+			Arena::Chunk* next = ((this->cursor_chunk == nullptr) ? this->head_chunk : this->cursor_chunk->next);
+
+			if (next == nullptr) {
+				next = this->make_chunk();
+			}
+
+			this->cursor_chunk = next;
+			this->cursor_index = 0U;
+		}
+
+		record = reinterpret_cast<Arena::Record*>(reinterpret_cast<char*>(this->cursor_chunk)
+			+ ARENA_CHUNK_HEADER_SIZE + this->record_stride * this->cursor_index);
+
+		this->cursor_index += 1U;
+	}
+
+	record->owner = this;
+	record->next = nullptr;
+
+	this->used += 1U;
+	this->allocations += 1U;
+
+	if (this->used > this->peak) {
+		this->peak = this->used;
+	}
+
+	return reinterpret_cast<char*>(record) + ARENA_RECORD_HEADER_SIZE;
+}
+
+void Arena::recycle(void* r) {
+	if (r != nullptr) {
+		Arena::Record* record = reinterpret_cast<Arena::Record*>(reinterpret_cast<char*>(r) - ARENA_RECORD_HEADER_SIZE);
+
+		if ((record->owner != nullptr) && (!record->owner->releasing)) {
+			record->owner->unsafe_recycle(record);
+		}
+	}
+}
+
+void Arena::begin_release() {
+	this->releasing = true;
+}
+
+void Arena::release() {
+	/** NOTE
+	 * All records handed out become invalid, clients should have already destructed them.
+	 * The chunks are kept for the next round, so that rebuilding planets do not bother the system allocator.
+	 */
+
+	this->cursor_chunk = nullptr;
+	this->cursor_index = 0U;
+	this->free_records = nullptr;
+	this->releasing = false;
+	this->used = 0U;
+	this->releases += 1U;
+}
+
+void Arena::fill_statistics(ArenaStatistics* stats) {
+	if (stats != nullptr) {
+		stats->record_size = this->record_size;
+		stats->chunk_count = this->chunk_count;
+		stats->capacity = this->chunk_count * this->records_per_chunk;
+		stats->used = this->used;
+		stats->peak = this->peak;
+		stats->allocations = this->allocations;
+		stats->recycles = this->recycles;
+		stats->releases = this->releases;
+	}
+}
+
+void Arena::unsafe_recycle(Arena::Record* record) {
+	record->owner = nullptr; // avoid double recycling
+	record->next = this->free_records;
+	this->free_records = record;
+
+	if (this->used > 0U) {
+		this->used -= 1U;
+	}
+
+	this->recycles += 1U;
+}
+
+Arena::Chunk* Arena::make_chunk() {
+	void* memory = std::malloc(ARENA_CHUNK_HEADER_SIZE + this->record_stride * this->records_per_chunk);
+	Arena::Chunk* chunk = nullptr;
+
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	chunk = static_cast<Arena::Chunk*>(memory);
+	chunk->next = nullptr;
+
+	if (this->head_chunk == nullptr) {
+		this->head_chunk = chunk;
+	} else {
+		Arena::Chunk* tail = this->head_chunk;
+
+		while (tail->next != nullptr) {
+			tail = tail->next;
+		}
+
+		tail->next = chunk;
+	}
+
+	this->chunk_count += 1U;
+
+	return chunk;
+}
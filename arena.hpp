@@ -0,0 +1,67 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	private struct ArenaStatistics {
+		size_t record_size;
+		size_t chunk_count;
+		size_t capacity;          // records that the reserved chunks can hold
+		size_t used;              // records currently handed out
+		size_t peak;              // maximum of `used` since the arena was created
+		size_t allocations;       // total `allocate()` calls
+		size_t recycles;          // total records returned one by one
+		size_t releases;          // total bulk releases
+	};
+
+	/** NOTE
+	 * Fixed-size record arena for small per-graphlet records such as the `GraphletInfo`.
+	 *
+	 * Records are carved out of chunks and returned to a free list one by one,
+	 *  or all at once with `release()` which just rewinds the cursor and keeps the chunks for reuse.
+	 * Every record remembers its owner, so that `Arena::recycle()` can be used in class-specific `operator delete`.
+	 *
+	 * Owners that destruct all records before releasing them call `begin_release()` first,
+	 *  then recycling does nothing until `release()`, since the free list is about to be dropped anyway.
+	 */
+	private class Arena {
+	public:
+		~Arena() noexcept;
+		Arena(size_t record_size, size_t records_per_chunk = 64U);
+
+	public:
+		void* allocate();
+		void begin_release();
+		void release();
+		void fill_statistics(WarGrey::SCADA::ArenaStatistics* stats);
+
+	public:
+		static void recycle(void* record);
+
+	private:
+		struct Chunk;
+		struct Record;
+
+	private:
+		void unsafe_recycle(WarGrey::SCADA::Arena::Record* record);
+		WarGrey::SCADA::Arena::Chunk* make_chunk();
+
+	private:
+		size_t record_size;
+		size_t record_stride;
+		size_t records_per_chunk;
+
+	private:
+		WarGrey::SCADA::Arena::Chunk* head_chunk;
+		WarGrey::SCADA::Arena::Chunk* cursor_chunk;
+		size_t cursor_index;
+		WarGrey::SCADA::Arena::Record* free_records;
+		bool releasing;
+
+	private:
+		size_t chunk_count;
+		size_t used;
+		size_t peak;
+		size_t allocations;
+		size_t recycles;
+		size_t releases;
+	};
+}
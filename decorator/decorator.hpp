@@ -4,8 +4,10 @@
 #include "object.hpp"
 #include "syslog.hpp"
 
+#include "drawing/scene.hpp"
+
 namespace WarGrey::SCADA {
-	private class IPlanetDecorator abstract {
+	private class IPlanetDecorator abstract : public WarGrey::SCADA::IDrawingSceneDecorator {
 	public:
 		virtual ~IPlanetDecorator() noexcept {}
 
@@ -31,6 +33,8 @@ namespace WarGrey::SCADA {
 			Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds,
 			float x, float y, float width, float height, bool selected) {}
 
+		// NOTE: the portable counterparts of the drawing hooks are `render_*()`, see "drawing/scene.hpp".
+
 	public:
 		virtual void update(long long count, long long interval, long long uptime) {}
 		virtual void on_active_planet_changed(IPlanet* master) {}
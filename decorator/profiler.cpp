@@ -0,0 +1,42 @@
+#include "decorator/profiler.hpp"
+
+#include "string.hpp"
+#include "text.hpp"
+#include "brushes.hxx"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::Text;
+using namespace Microsoft::Graphics::Canvas::Brushes;
+
+ProfilerDecorator::ProfilerDecorator(FrameProfiler* profiler, unsigned int top_count, float font_size)
+	: profiler(profiler), top_count(top_count) {
+	this->font = make_text_format("Consolas", font_size);
+	this->background = Colours::make(0x000000, 0.64);
+}
+
+void ProfilerDecorator::draw_after(CanvasDrawingSession^ ds, float Width, float Height) {
+	if ((this->profiler != nullptr) && this->profiler->is_enabled()) {
+		size_t n = this->profiler->fill_hotspots(&this->hotspots, this->top_count);
+		float lineheight = this->font->FontSize * 1.2F;
+		float width = this->font->FontSize * 38.0F; // roughly 64 monospaced columns
+		float x = Width - width;
+		float y = 0.0F;
+
+		ds->FillRectangle(x, y, width, lineheight * float(n + 1), this->background);
+		ds->DrawText(L"class           phase        count   avg(us)   p95(us)   max(us)", x, y, Colours::GhostWhite, this->font);
+
+		for (size_t idx = 0; idx < n; idx++) {
+			ProfileHotspot& hot = this->hotspots[idx];
+			double avg = double(hot.histogram.total) / double(hot.histogram.count) / 10.0;
+			double p95 = double(profile_histogram_percentile(hot.histogram, 0.95)) / 10.0;
+			double max = double(hot.histogram.max) / 10.0;
+
+			y += lineheight;
+			ds->DrawText(make_wstring(L"%-15S %-10S %7llu %9.1lf %9.1lf %9.1lf",
+				profile_class_name(hot.kind), profile_phase_name(hot.phase), hot.histogram.count, avg, p95, max),
+				x, y, ((idx == 0) ? Colours::Firebrick : Colours::GhostWhite), this->font);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "decorator/decorator.hpp"
+#include "profiler.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The overlay lists the graphlet classes that eat the most of the frame budget since the profiler was reset,
+	 *  a class may appear once per phase, times of planets include their graphlets.
+	 */
+	private class ProfilerDecorator : public virtual WarGrey::SCADA::IPlanetDecorator {
+	public:
+		ProfilerDecorator(WarGrey::SCADA::FrameProfiler* profiler, unsigned int top_count = 8U, float font_size = 12.0F);
+
+	public:
+		void draw_after(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float Width, float Height) override;
+
+	private:
+		WarGrey::SCADA::FrameProfiler* profiler;
+		std::vector<WarGrey::SCADA::ProfileHotspot> hotspots;
+		Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ font;
+		Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ background;
+		unsigned int top_count;
+	};
+}
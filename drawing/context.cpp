@@ -0,0 +1,248 @@
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#include "drawing/context.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const float drawing_flatness_tolerance = 0.25F;
+static const float drawing_pi = 3.14159265358979F;
+
+static std::atomic<unsigned long long> drawing_path_serial(0ULL);
+
+static inline unsigned long long next_revision() {
+	return (drawing_path_serial += 1ULL);
+}
+
+static size_t arc_segments(float rx, float ry, float sweep) {
+	float r = std::fmax(std::fabs(rx), std::fabs(ry));
+	size_t n = 4U;
+
+	if (r > drawing_flatness_tolerance) {
+		float step = 2.0F * std::acos(1.0F - drawing_flatness_tolerance / r);
+
+		n = std::max(n, size_t(std::ceil(std::fabs(sweep) / step)));
+	}
+
+	return std::min(n, size_t(1024U));
+}
+
+/*************************************************************************************************/
+DrawingColor WarGrey::SCADA::drawing_color(unsigned int rgb, float alpha) {
+	return DrawingColor{
+		float((rgb >> 16) & 0xFFU) / 255.0F,
+		float((rgb >> 8) & 0xFFU) / 255.0F,
+		float(rgb & 0xFFU) / 255.0F,
+		alpha };
+}
+
+DrawingMatrix WarGrey::SCADA::drawing_identity() {
+	return DrawingMatrix{ 1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F };
+}
+
+DrawingMatrix WarGrey::SCADA::drawing_translation(float dx, float dy) {
+	return DrawingMatrix{ 1.0F, 0.0F, 0.0F, 1.0F, dx, dy };
+}
+
+DrawingMatrix WarGrey::SCADA::drawing_scale(float sx, float sy) {
+	return DrawingMatrix{ sx, 0.0F, 0.0F, sy, 0.0F, 0.0F };
+}
+
+DrawingMatrix WarGrey::SCADA::drawing_rotation(float radians, float cx, float cy) {
+	float c = std::cos(radians);
+	float s = std::sin(radians);
+
+	return DrawingMatrix{ c, s, -s, c, cx - cx * c + cy * s, cy - cx * s - cy * c };
+}
+
+DrawingMatrix WarGrey::SCADA::drawing_multiply(const DrawingMatrix& a, const DrawingMatrix& b) {
+	return DrawingMatrix{
+		a.m11 * b.m11 + a.m12 * b.m21, a.m11 * b.m12 + a.m12 * b.m22,
+		a.m21 * b.m11 + a.m22 * b.m21, a.m21 * b.m12 + a.m22 * b.m22,
+		a.dx * b.m11 + a.dy * b.m21 + b.dx, a.dx * b.m12 + a.dy * b.m22 + b.dy };
+}
+
+DrawingPoint WarGrey::SCADA::drawing_apply(const DrawingMatrix& m, float x, float y) {
+	return DrawingPoint{ x * m.m11 + y * m.m21 + m.dx, x * m.m12 + y * m.m22 + m.dy };
+}
+
+/*************************************************************************************************/
+DrawingPath::DrawingPath(DrawingFillRule rule) : rule(rule), serial(next_revision()), persistent(false) {}
+
+void DrawingPath::move_to(float x, float y) {
+	this->paths.push_back(DrawingPath::Figure{ { DrawingPoint{ x, y } }, false });
+	this->serial = next_revision();
+}
+
+void DrawingPath::line_to(float x, float y) {
+	this->current_figure()->points.push_back(DrawingPoint{ x, y });
+	this->serial = next_revision();
+}
+
+void DrawingPath::arc_to(float cx, float cy, float rx, float ry, float start, float sweep) {
+	size_t n = arc_segments(rx, ry, sweep);
+	DrawingPath::Figure* figure = this->current_figure();
+
+	for (size_t i = ((figure->points.size() > 0) ? 1U : 0U); i <= n; i++) {
+		float theta = start + sweep * float(i) / float(n);
+
+		figure->points.push_back(DrawingPoint{ cx + rx * std::cos(theta), cy + ry * std::sin(theta) });
+	}
+
+	this->serial = next_revision();
+}
+
+void DrawingPath::close() {
+	if (!this->paths.empty()) {
+		this->paths.back().closed = true;
+		this->serial = next_revision();
+	}
+}
+
+void DrawingPath::add_rectangle(float x, float y, float width, float height) {
+	this->move_to(x, y);
+	this->line_to(x + width, y);
+	this->line_to(x + width, y + height);
+	this->line_to(x, y + height);
+	this->close();
+}
+
+void DrawingPath::add_rounded_rectangle(float x, float y, float width, float height, float rx, float ry) {
+	rx = std::fmin(std::fabs(rx), width * 0.5F);
+	ry = std::fmin(std::fabs(ry), height * 0.5F);
+
+	if ((rx <= 0.0F) || (ry <= 0.0F)) {
+		this->add_rectangle(x, y, width, height);
+	} else {
+		float hpi = drawing_pi * 0.5F;
+
+		this->move_to(x + rx, y);
+		this->arc_to(x + width - rx, y + ry, rx, ry, -hpi, hpi);
+		this->arc_to(x + width - rx, y + height - ry, rx, ry, 0.0F, hpi);
+		this->arc_to(x + rx, y + height - ry, rx, ry, hpi, hpi);
+		this->arc_to(x + rx, y + ry, rx, ry, drawing_pi, hpi);
+		this->close();
+	}
+}
+
+void DrawingPath::add_ellipse(float cx, float cy, float rx, float ry) {
+	this->paths.push_back(DrawingPath::Figure{ {}, false });
+	this->arc_to(cx, cy, rx, ry, 0.0F, drawing_pi * 2.0F);
+	this->close();
+}
+
+void DrawingPath::add_polygon(const DrawingPoint* vertices, size_t count) {
+	if (count > 0) {
+		this->move_to(vertices[0].x, vertices[0].y);
+
+		for (size_t i = 1; i < count; i++) {
+			this->line_to(vertices[i].x, vertices[i].y);
+		}
+
+		this->close();
+	}
+}
+
+DrawingRect DrawingPath::bounds() const {
+	float xmin = INFINITY;
+	float ymin = INFINITY;
+	float xmax = -INFINITY;
+	float ymax = -INFINITY;
+
+	for (auto figure = this->paths.begin(); figure != this->paths.end(); figure++) {
+		for (auto p = figure->points.begin(); p != figure->points.end(); p++) {
+			xmin = std::fmin(xmin, p->x);
+			ymin = std::fmin(ymin, p->y);
+			xmax = std::fmax(xmax, p->x);
+			ymax = std::fmax(ymax, p->y);
+		}
+	}
+
+	return ((xmin > xmax) ? DrawingRect{ 0.0F, 0.0F, 0.0F, 0.0F } : DrawingRect{ xmin, ymin, xmax - xmin, ymax - ymin });
+}
+
+bool DrawingPath::contains(float x, float y) const {
+	int winding = 0;
+
+	// NOTE: open figures are implicitly closed when filling, so do they when hit-testing.
+	for (auto figure = this->paths.begin(); figure != this->paths.end(); figure++) {
+		size_t n = figure->points.size();
+
+		for (size_t i = 0; i < n; i++) {
+			const DrawingPoint& p0 = figure->points[i];
+			const DrawingPoint& p1 = figure->points[(i + 1) % n];
+
+			if ((p0.y <= y) && (p1.y > y)) {
+				if ((p1.x - p0.x) * (y - p0.y) - (x - p0.x) * (p1.y - p0.y) > 0.0F) {
+					winding += 1;
+				}
+			} else if ((p0.y > y) && (p1.y <= y)) {
+				if ((p1.x - p0.x) * (y - p0.y) - (x - p0.x) * (p1.y - p0.y) < 0.0F) {
+					winding -= 1;
+				}
+			}
+		}
+	}
+
+	return ((this->rule == DrawingFillRule::EvenOdd) ? ((winding & 1) != 0) : (winding != 0));
+}
+
+DrawingPath::Figure* DrawingPath::current_figure() {
+	if (this->paths.empty()) {
+		this->paths.push_back(DrawingPath::Figure{ { DrawingPoint{ 0.0F, 0.0F } }, false });
+	}
+
+	return &this->paths.back();
+}
+
+/*************************************************************************************************/
+void IDrawingContext::fill_rectangle(float x, float y, float width, float height, const DrawingColor& color) {
+	DrawingPath path;
+
+	path.add_rectangle(x, y, width, height);
+	this->fill_path(path, color);
+}
+
+void IDrawingContext::stroke_rectangle(float x, float y, float width, float height, const DrawingColor& color, float thickness) {
+	DrawingPath path;
+
+	path.add_rectangle(x, y, width, height);
+	this->stroke_path(path, color, thickness);
+}
+
+void IDrawingContext::fill_ellipse(float cx, float cy, float rx, float ry, const DrawingColor& color) {
+	DrawingPath path;
+
+	path.add_ellipse(cx, cy, rx, ry);
+	this->fill_path(path, color);
+}
+
+void IDrawingContext::stroke_ellipse(float cx, float cy, float rx, float ry, const DrawingColor& color, float thickness) {
+	DrawingPath path;
+
+	path.add_ellipse(cx, cy, rx, ry);
+	this->stroke_path(path, color, thickness);
+}
+
+void IDrawingContext::draw_line(float x0, float y0, float x1, float y1, const DrawingColor& color, float thickness) {
+	DrawingPath path;
+
+	path.move_to(x0, y0);
+	path.line_to(x1, y1);
+	this->stroke_path(path, color, thickness);
+}
+
+void IDrawingContext::push_transform(const DrawingMatrix& m) {
+	DrawingMatrix current = this->get_transform();
+
+	this->transforms.push_back(current);
+	this->set_transform(drawing_multiply(m, current));
+}
+
+void IDrawingContext::pop_transform() {
+	if (!this->transforms.empty()) {
+		this->set_transform(this->transforms.back());
+		this->transforms.pop_back();
+	}
+}
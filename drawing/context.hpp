@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <string>
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The drawing context is a thin abstraction of the drawing calls that graphlets actually make,
+	 *  so that rendering, hit-testing and layout can also run without Win2D, say, on a build machine.
+	 *
+	 * Types here are plain C++ on purpose (no `private` visibility, no `abstract`, no hat handles),
+	 *  the Win2D adapter lives in "drawing/win2d.hpp".
+	 */
+	struct DrawingColor {
+		float r;
+		float g;
+		float b;
+		float a;
+	};
+
+	struct DrawingMatrix {
+		float m11; float m12;
+		float m21; float m22;
+		float dx;  float dy;
+	};
+
+	struct DrawingPoint {
+		float x;
+		float y;
+	};
+
+	struct DrawingRect {
+		float x;
+		float y;
+		float width;
+		float height;
+	};
+
+	enum class DrawingFillRule { NonZero, EvenOdd };
+
+	DrawingColor drawing_color(unsigned int rgb, float alpha = 1.0F);
+	DrawingMatrix drawing_identity();
+	DrawingMatrix drawing_translation(float dx, float dy);
+	DrawingMatrix drawing_scale(float sx, float sy);
+	DrawingMatrix drawing_rotation(float radians, float cx = 0.0F, float cy = 0.0F);
+	DrawingMatrix drawing_multiply(const DrawingMatrix& first, const DrawingMatrix& then);
+	DrawingPoint drawing_apply(const DrawingMatrix& m, float x, float y);
+
+	/************************************************************************************************/
+	class DrawingPath {
+	public:
+		DrawingPath(DrawingFillRule rule = DrawingFillRule::NonZero);
+
+	public:
+		void move_to(float x, float y);
+		void line_to(float x, float y);
+		void arc_to(float cx, float cy, float rx, float ry, float start_radians, float sweep_radians);
+		void close();
+
+	public:
+		void add_rectangle(float x, float y, float width, float height);
+		void add_rounded_rectangle(float x, float y, float width, float height, float rx, float ry);
+		void add_ellipse(float cx, float cy, float rx, float ry);
+		void add_polygon(const DrawingPoint* vertices, size_t count);
+
+	public:
+		DrawingRect bounds() const;
+		bool contains(float x, float y) const;
+		DrawingFillRule fill_rule() const { return this->rule; }
+
+	public:
+		/** NOTE
+		 * Curves are flattened as soon as they are added,
+		 *  every figure is a polyline, closed or not.
+		 */
+		struct Figure {
+			std::vector<DrawingPoint> points;
+			bool closed;
+		};
+
+		const std::vector<WarGrey::SCADA::DrawingPath::Figure>& figures() const { return this->paths; }
+
+	public:
+		/** NOTE
+		 * The revision changes whenever the path changes,
+		 *  backends that cache device-dependent geometries use it to tell whether theirs are still valid.
+		 */
+		unsigned long long revision() const { return this->serial; }
+
+		/** NOTE
+		 * Persistent paths are drawn over and over again (say, the shapes of graphlets),
+		 *  backends may freeze them into device-dependent resources, whereas one-shot paths are drawn as they are.
+		 */
+		void set_persistent(bool yes) { this->persistent = yes; }
+		bool is_persistent() const { return this->persistent; }
+
+	private:
+		WarGrey::SCADA::DrawingPath::Figure* current_figure();
+
+	private:
+		std::vector<WarGrey::SCADA::DrawingPath::Figure> paths;
+		DrawingFillRule rule;
+		unsigned long long serial;
+		bool persistent;
+	};
+
+	/************************************************************************************************/
+	struct DrawingFont {
+		std::wstring family;
+		float size;
+		bool bold;
+	};
+
+	struct DrawingImage {
+		unsigned int width;
+		unsigned int height;
+		std::vector<unsigned int> pixels; // premultiplied 0xAARRGGBB, row-major
+	};
+
+	class IDrawingContext {
+	public:
+		virtual ~IDrawingContext() noexcept {}
+
+	public:
+		virtual void clear(const DrawingColor& color) = 0;
+		virtual void fill_path(const DrawingPath& path, const DrawingColor& color) = 0;
+		virtual void stroke_path(const DrawingPath& path, const DrawingColor& color, float thickness) = 0;
+		virtual void draw_text(const std::wstring& text, float x, float y, const DrawingFont& font, const DrawingColor& color) = 0;
+		virtual DrawingRect measure_text(const std::wstring& text, const DrawingFont& font) = 0;
+		virtual void draw_image(const DrawingImage& image, float x, float y, float width, float height, float opacity = 1.0F) = 0;
+
+	public:
+		virtual void push_layer(const DrawingRect& clip, float opacity = 1.0F) = 0;
+		virtual void pop_layer() = 0;
+
+	public:
+		virtual void set_transform(const DrawingMatrix& m) = 0;
+		virtual DrawingMatrix get_transform() = 0;
+
+	public: // NOTE: groups mark the commands that belong to the same owner, say, a graphlet; they do not affect the output.
+		virtual void begin_group(const void* /* tag */) {}
+		virtual void end_group() {}
+
+	public:
+		void fill_rectangle(float x, float y, float width, float height, const DrawingColor& color);
+		void stroke_rectangle(float x, float y, float width, float height, const DrawingColor& color, float thickness = 1.0F);
+		void fill_ellipse(float cx, float cy, float rx, float ry, const DrawingColor& color);
+		void stroke_ellipse(float cx, float cy, float rx, float ry, const DrawingColor& color, float thickness = 1.0F);
+		void draw_line(float x0, float y0, float x1, float y1, const DrawingColor& color, float thickness = 1.0F);
+
+	public:
+		void push_transform(const DrawingMatrix& m); // `m` is applied before the current transform
+		void pop_transform();
+
+	private:
+		std::vector<WarGrey::SCADA::DrawingMatrix> transforms;
+	};
+}
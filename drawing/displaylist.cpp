@@ -0,0 +1,258 @@
+#include <map>
+
+#include "drawing/displaylist.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const unsigned long long fnv_offset_basis = 14695981039346656037ULL;
+static const unsigned long long fnv_prime = 1099511628211ULL;
+
+static inline unsigned long long fnv1a(unsigned long long digest, const void* data, size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (size_t i = 0; i < size; i++) {
+		digest = (digest ^ bytes[i]) * fnv_prime;
+	}
+
+	return digest;
+}
+
+static unsigned long long command_digest(const DrawingCommand& cmd) {
+	unsigned long long digest = fnv_offset_basis;
+	int type = int(cmd.type);
+
+	// NOTE: tags are excluded, they tell who draws rather than what is drawn.
+	digest = fnv1a(digest, &type, sizeof(type));
+	digest = fnv1a(digest, &cmd.color, sizeof(cmd.color));
+	digest = fnv1a(digest, &cmd.rect, sizeof(cmd.rect));
+	digest = fnv1a(digest, &cmd.transform, sizeof(cmd.transform));
+	digest = fnv1a(digest, &cmd.thickness, sizeof(cmd.thickness));
+
+	if (cmd.path != nullptr) {
+		DrawingFillRule rule = cmd.path->fill_rule();
+
+		digest = fnv1a(digest, &rule, sizeof(rule));
+
+		for (auto figure = cmd.path->figures().begin(); figure != cmd.path->figures().end(); figure++) {
+			digest = fnv1a(digest, figure->points.data(), figure->points.size() * sizeof(DrawingPoint));
+			digest = fnv1a(digest, &figure->closed, sizeof(figure->closed));
+		}
+	}
+
+	if (cmd.image != nullptr) {
+		digest = fnv1a(digest, &cmd.image->width, sizeof(cmd.image->width));
+		digest = fnv1a(digest, &cmd.image->height, sizeof(cmd.image->height));
+		digest = fnv1a(digest, cmd.image->pixels.data(), cmd.image->pixels.size() * sizeof(unsigned int));
+	}
+
+	if (cmd.type == DrawingCommandType::Text) {
+		digest = fnv1a(digest, cmd.text.data(), cmd.text.size() * sizeof(wchar_t));
+		digest = fnv1a(digest, cmd.font.family.data(), cmd.font.family.size() * sizeof(wchar_t));
+		digest = fnv1a(digest, &cmd.font.size, sizeof(cmd.font.size));
+		digest = fnv1a(digest, &cmd.font.bold, sizeof(cmd.font.bold));
+	}
+
+	return digest;
+}
+
+static DrawingCommand make_command(DrawingCommandType type) {
+	DrawingCommand cmd;
+
+	cmd.type = type;
+	cmd.color = DrawingColor{ 0.0F, 0.0F, 0.0F, 0.0F };
+	cmd.rect = DrawingRect{ 0.0F, 0.0F, 0.0F, 0.0F };
+	cmd.transform = drawing_identity();
+	cmd.thickness = 0.0F;
+	cmd.font = DrawingFont{ L"", 0.0F, false };
+	cmd.tag = nullptr;
+	cmd.digest = 0ULL;
+
+	return cmd;
+}
+
+/*************************************************************************************************/
+DisplayList::DisplayList(IDrawingContext* measurer) : measurer(measurer), transform(drawing_identity()) {}
+
+void DisplayList::clear(const DrawingColor& color) {
+	DrawingCommand cmd = make_command(DrawingCommandType::Clear);
+
+	cmd.color = color;
+	this->record(cmd);
+}
+
+void DisplayList::fill_path(const DrawingPath& path, const DrawingColor& color) {
+	this->fill_shared_path(std::make_shared<const DrawingPath>(path), color);
+}
+
+void DisplayList::stroke_path(const DrawingPath& path, const DrawingColor& color, float thickness) {
+	this->stroke_shared_path(std::make_shared<const DrawingPath>(path), color, thickness);
+}
+
+void DisplayList::draw_image(const DrawingImage& image, float x, float y, float width, float height, float opacity) {
+	this->draw_shared_image(std::make_shared<const DrawingImage>(image), x, y, width, height, opacity);
+}
+
+void DisplayList::fill_shared_path(std::shared_ptr<const DrawingPath> path, const DrawingColor& color) {
+	DrawingCommand cmd = make_command(DrawingCommandType::FillPath);
+
+	cmd.path = path;
+	cmd.color = color;
+	this->record(cmd);
+}
+
+void DisplayList::stroke_shared_path(std::shared_ptr<const DrawingPath> path, const DrawingColor& color, float thickness) {
+	DrawingCommand cmd = make_command(DrawingCommandType::StrokePath);
+
+	cmd.path = path;
+	cmd.color = color;
+	cmd.thickness = thickness;
+	this->record(cmd);
+}
+
+void DisplayList::draw_shared_image(std::shared_ptr<const DrawingImage> image, float x, float y, float width, float height, float opacity) {
+	DrawingCommand cmd = make_command(DrawingCommandType::Image);
+
+	cmd.image = image;
+	cmd.rect = DrawingRect{ x, y, width, height };
+	cmd.thickness = opacity;
+	this->record(cmd);
+}
+
+void DisplayList::draw_text(const std::wstring& text, float x, float y, const DrawingFont& font, const DrawingColor& color) {
+	DrawingCommand cmd = make_command(DrawingCommandType::Text);
+
+	cmd.text = text;
+	cmd.font = font;
+	cmd.color = color;
+	cmd.rect = DrawingRect{ x, y, 0.0F, 0.0F };
+	this->record(cmd);
+}
+
+DrawingRect DisplayList::measure_text(const std::wstring& text, const DrawingFont& font) {
+	DrawingRect box = DrawingRect{ 0.0F, 0.0F, 0.0F, 0.0F };
+
+	if (this->measurer != nullptr) {
+		box = this->measurer->measure_text(text, font);
+	}
+
+	return box;
+}
+
+void DisplayList::push_layer(const DrawingRect& clip, float opacity) {
+	DrawingCommand cmd = make_command(DrawingCommandType::PushLayer);
+
+	cmd.rect = clip;
+	cmd.thickness = opacity;
+	this->record(cmd);
+}
+
+void DisplayList::pop_layer() {
+	DrawingCommand cmd = make_command(DrawingCommandType::PopLayer);
+
+	this->record(cmd);
+}
+
+void DisplayList::set_transform(const DrawingMatrix& m) {
+	DrawingCommand cmd = make_command(DrawingCommandType::SetTransform);
+
+	cmd.transform = m;
+	this->transform = m;
+	this->record(cmd);
+}
+
+DrawingMatrix DisplayList::get_transform() {
+	return this->transform;
+}
+
+void DisplayList::begin_group(const void* tag) {
+	DrawingCommand cmd = make_command(DrawingCommandType::BeginGroup);
+
+	this->groups.push_back(tag);
+	this->record(cmd);
+}
+
+void DisplayList::end_group() {
+	DrawingCommand cmd = make_command(DrawingCommandType::EndGroup);
+
+	this->record(cmd);
+
+	if (!this->groups.empty()) {
+		this->groups.pop_back();
+	}
+}
+
+void DisplayList::replay(IDrawingContext* dc) const {
+	for (auto cmd = this->commands.begin(); cmd != this->commands.end(); cmd++) {
+		switch (cmd->type) {
+		case DrawingCommandType::Clear: dc->clear(cmd->color); break;
+		case DrawingCommandType::FillPath: dc->fill_path(*cmd->path, cmd->color); break;
+		case DrawingCommandType::StrokePath: dc->stroke_path(*cmd->path, cmd->color, cmd->thickness); break;
+		case DrawingCommandType::Text: dc->draw_text(cmd->text, cmd->rect.x, cmd->rect.y, cmd->font, cmd->color); break;
+		case DrawingCommandType::PushLayer: dc->push_layer(cmd->rect, cmd->thickness); break;
+		case DrawingCommandType::PopLayer: dc->pop_layer(); break;
+		case DrawingCommandType::SetTransform: dc->set_transform(cmd->transform); break;
+		case DrawingCommandType::BeginGroup: dc->begin_group(cmd->tag); break;
+		case DrawingCommandType::EndGroup: dc->end_group(); break;
+		case DrawingCommandType::Image: {
+			dc->draw_image(*cmd->image, cmd->rect.x, cmd->rect.y, cmd->rect.width, cmd->rect.height, cmd->thickness);
+		}; break;
+		}
+	}
+}
+
+void DisplayList::reset() {
+	this->commands.clear();
+	this->groups.clear();
+	this->transform = drawing_identity();
+}
+
+void DisplayList::record(DrawingCommand& cmd) {
+	cmd.tag = (this->groups.empty() ? nullptr : this->groups.back());
+	cmd.digest = command_digest(cmd);
+
+	this->commands.push_back(std::move(cmd));
+}
+
+/*************************************************************************************************/
+static void fold_display_list(const DisplayList& dl, std::vector<const void*>& order, std::map<const void*, unsigned long long>& digests) {
+	for (auto cmd = dl.items().begin(); cmd != dl.items().end(); cmd++) {
+		auto maybe_group = digests.find(cmd->tag);
+
+		if (maybe_group == digests.end()) {
+			order.push_back(cmd->tag);
+			digests.insert(std::make_pair(cmd->tag, fnv1a(fnv_offset_basis, &cmd->digest, sizeof(cmd->digest))));
+		} else {
+			maybe_group->second = fnv1a(maybe_group->second, &cmd->digest, sizeof(cmd->digest));
+		}
+	}
+}
+
+DisplayListDiff WarGrey::SCADA::diff_display_lists(const DisplayList& before, const DisplayList& after) {
+	std::vector<const void*> border, aorder;
+	std::map<const void*, unsigned long long> bdigests, adigests;
+	DisplayListDiff diff;
+
+	fold_display_list(before, border, bdigests);
+	fold_display_list(after, aorder, adigests);
+	diff.unchanged = 0U;
+
+	for (auto tag = aorder.begin(); tag != aorder.end(); tag++) {
+		auto maybe_before = bdigests.find(*tag);
+
+		if (maybe_before == bdigests.end()) {
+			diff.added.push_back(*tag);
+		} else if (maybe_before->second != adigests[*tag]) {
+			diff.changed.push_back(*tag);
+		} else {
+			diff.unchanged += 1U;
+		}
+	}
+
+	for (auto tag = border.begin(); tag != border.end(); tag++) {
+		if (adigests.find(*tag) == adigests.end()) {
+			diff.removed.push_back(*tag);
+		}
+	}
+
+	return diff;
+}
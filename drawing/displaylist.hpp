@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+
+#include "drawing/context.hpp"
+
+namespace WarGrey::SCADA {
+	enum class DrawingCommandType { Clear, FillPath, StrokePath, Text, Image, PushLayer, PopLayer, SetTransform, BeginGroup, EndGroup };
+
+	struct DrawingCommand {
+		WarGrey::SCADA::DrawingCommandType type;
+		WarGrey::SCADA::DrawingColor color;
+		WarGrey::SCADA::DrawingRect rect;         // also the position of texts and images
+		WarGrey::SCADA::DrawingMatrix transform;
+		float thickness;                          // also the opacity of layers and images
+		std::shared_ptr<const WarGrey::SCADA::DrawingPath> path;
+		std::shared_ptr<const WarGrey::SCADA::DrawingImage> image;
+		std::wstring text;
+		WarGrey::SCADA::DrawingFont font;
+		const void* tag;
+		unsigned long long digest;
+	};
+
+	struct DisplayListDiff {
+		std::vector<const void*> added;
+		std::vector<const void*> removed;
+		std::vector<const void*> changed;
+		size_t unchanged;
+	};
+
+	/** NOTE
+	 * A display list is a drawing context that records commands instead of drawing them,
+	 *  so that a frame can be replayed into another context later, or compared with the previous frame.
+	 *
+	 * Paths are shared rather than copied if they are recorded via `fill_shared_path()` or `stroke_shared_path()`,
+	 *  and images are always copied unless recorded via `draw_shared_image()`.
+	 */
+	class DisplayList : public WarGrey::SCADA::IDrawingContext {
+	public:
+		DisplayList(WarGrey::SCADA::IDrawingContext* measurer = nullptr);
+
+	public:
+		void clear(const WarGrey::SCADA::DrawingColor& color) override;
+		void fill_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color) override;
+		void stroke_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color, float thickness) override;
+		void draw_image(const WarGrey::SCADA::DrawingImage& image, float x, float y, float width, float height, float opacity = 1.0F) override;
+
+	public:
+		void draw_text(const std::wstring& text, float x, float y,
+			const WarGrey::SCADA::DrawingFont& font, const WarGrey::SCADA::DrawingColor& color) override;
+
+		WarGrey::SCADA::DrawingRect measure_text(const std::wstring& text, const WarGrey::SCADA::DrawingFont& font) override;
+
+	public:
+		void push_layer(const WarGrey::SCADA::DrawingRect& clip, float opacity = 1.0F) override;
+		void pop_layer() override;
+		void set_transform(const WarGrey::SCADA::DrawingMatrix& m) override;
+		WarGrey::SCADA::DrawingMatrix get_transform() override;
+		void begin_group(const void* tag) override;
+		void end_group() override;
+
+	public:
+		void fill_shared_path(std::shared_ptr<const WarGrey::SCADA::DrawingPath> path, const WarGrey::SCADA::DrawingColor& color);
+		void stroke_shared_path(std::shared_ptr<const WarGrey::SCADA::DrawingPath> path, const WarGrey::SCADA::DrawingColor& color, float thickness);
+		void draw_shared_image(std::shared_ptr<const WarGrey::SCADA::DrawingImage> image, float x, float y, float width, float height, float opacity = 1.0F);
+
+	public:
+		void replay(WarGrey::SCADA::IDrawingContext* dc) const;
+		void reset();
+		size_t size() const { return this->commands.size(); }
+		const std::vector<WarGrey::SCADA::DrawingCommand>& items() const { return this->commands; }
+
+	private:
+		void record(WarGrey::SCADA::DrawingCommand& cmd);
+
+	private:
+		std::vector<WarGrey::SCADA::DrawingCommand> commands;
+		std::vector<const void*> groups;
+		WarGrey::SCADA::IDrawingContext* measurer;
+		WarGrey::SCADA::DrawingMatrix transform;
+	};
+
+	/**
+	 * Commands are compared group by group, commands out of any group are considered as the group `nullptr`.
+	 */
+	WarGrey::SCADA::DisplayListDiff diff_display_lists(const WarGrey::SCADA::DisplayList& before, const WarGrey::SCADA::DisplayList& after);
+}
@@ -0,0 +1,689 @@
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include "drawing/mirror.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const unsigned int mirror_magic = 0x524D4242U; // "BBMR"
+static const unsigned char mirror_version = 1U;
+static const unsigned char mirror_keyframe = 0U;
+static const unsigned char mirror_delta = 1U;
+
+static const unsigned long long fnv_offset_basis = 14695981039346656037ULL;
+static const unsigned long long fnv_prime = 1099511628211ULL;
+
+static inline unsigned long long run_key(unsigned int tag_id, unsigned int occurrence) {
+	return (((unsigned long long)tag_id) << 16) | (occurrence & 0xFFFFU);
+}
+
+static inline const void* run_tag(unsigned long long key) {
+	return reinterpret_cast<const void*>(uintptr_t(key >> 16));
+}
+
+/*************************************************************************************************/
+static inline void write_u8(std::vector<unsigned char>& out, unsigned char v) {
+	out.push_back(v);
+}
+
+static inline void write_u32(std::vector<unsigned char>& out, unsigned int v) {
+	for (int i = 0; i < 4; i++) {
+		out.push_back((unsigned char)((v >> (i * 8)) & 0xFFU));
+	}
+}
+
+static inline void write_u64(std::vector<unsigned char>& out, unsigned long long v) {
+	write_u32(out, (unsigned int)(v & 0xFFFFFFFFULL));
+	write_u32(out, (unsigned int)(v >> 32));
+}
+
+static inline void write_f32(std::vector<unsigned char>& out, float v) {
+	unsigned int bits = 0U;
+
+	std::memcpy(&bits, &v, sizeof(float));
+	write_u32(out, bits);
+}
+
+static void write_string(std::vector<unsigned char>& out, const std::wstring& s) {
+	write_u32(out, (unsigned int)s.size());
+
+	for (auto ch = s.begin(); ch != s.end(); ch++) { // UTF-16 code units, as what `wchar_t` is on Windows
+		out.push_back((unsigned char)((*ch) & 0xFFU));
+		out.push_back((unsigned char)(((*ch) >> 8) & 0xFFU));
+	}
+}
+
+static void write_color(std::vector<unsigned char>& out, const DrawingColor& c) {
+	write_f32(out, c.r);
+	write_f32(out, c.g);
+	write_f32(out, c.b);
+	write_f32(out, c.a);
+}
+
+static void write_rect(std::vector<unsigned char>& out, const DrawingRect& r) {
+	write_f32(out, r.x);
+	write_f32(out, r.y);
+	write_f32(out, r.width);
+	write_f32(out, r.height);
+}
+
+static void write_path(std::vector<unsigned char>& out, const DrawingPath& path) {
+	write_u8(out, (unsigned char)path.fill_rule());
+	write_u32(out, (unsigned int)path.figures().size());
+
+	for (auto figure = path.figures().begin(); figure != path.figures().end(); figure++) {
+		write_u8(out, (figure->closed ? 1U : 0U));
+		write_u32(out, (unsigned int)figure->points.size());
+
+		for (auto p = figure->points.begin(); p != figure->points.end(); p++) {
+			write_f32(out, p->x);
+			write_f32(out, p->y);
+		}
+	}
+}
+
+static void write_command(std::vector<unsigned char>& out, const DrawingCommand& cmd) {
+	write_u8(out, (unsigned char)cmd.type);
+
+	switch (cmd.type) {
+	case DrawingCommandType::Clear: write_color(out, cmd.color); break;
+	case DrawingCommandType::FillPath: write_color(out, cmd.color); write_path(out, *cmd.path); break;
+	case DrawingCommandType::StrokePath: {
+		write_color(out, cmd.color);
+		write_f32(out, cmd.thickness);
+		write_path(out, *cmd.path);
+	}; break;
+	case DrawingCommandType::Text: {
+		write_color(out, cmd.color);
+		write_f32(out, cmd.rect.x);
+		write_f32(out, cmd.rect.y);
+		write_string(out, cmd.font.family);
+		write_f32(out, cmd.font.size);
+		write_u8(out, (cmd.font.bold ? 1U : 0U));
+		write_string(out, cmd.text);
+	}; break;
+	case DrawingCommandType::Image: {
+		write_rect(out, cmd.rect);
+		write_f32(out, cmd.thickness);
+		write_u32(out, cmd.image->width);
+		write_u32(out, cmd.image->height);
+
+		for (auto px = cmd.image->pixels.begin(); px != cmd.image->pixels.end(); px++) {
+			write_u32(out, (*px));
+		}
+	}; break;
+	case DrawingCommandType::PushLayer: write_rect(out, cmd.rect); write_f32(out, cmd.thickness); break;
+	case DrawingCommandType::SetTransform: {
+		write_f32(out, cmd.transform.m11); write_f32(out, cmd.transform.m12);
+		write_f32(out, cmd.transform.m21); write_f32(out, cmd.transform.m22);
+		write_f32(out, cmd.transform.dx); write_f32(out, cmd.transform.dy);
+	}; break;
+	case DrawingCommandType::PopLayer: case DrawingCommandType::BeginGroup: case DrawingCommandType::EndGroup: break;
+	}
+}
+
+/*************************************************************************************************/
+namespace {
+	class MirrorReader {
+	public:
+		MirrorReader(const unsigned char* data, size_t size) : data(data), size(size), cursor(0U), okay(true) {}
+
+	public:
+		bool good() { return this->okay; }
+		bool done() { return this->cursor >= this->size; }
+
+	public:
+		unsigned char u8() {
+			unsigned char v = 0U;
+
+			if (this->require(1U)) {
+				v = this->data[this->cursor];
+				this->cursor += 1U;
+			}
+
+			return v;
+		}
+
+		unsigned int u32() {
+			unsigned int v = 0U;
+
+			if (this->require(4U)) {
+				for (int i = 0; i < 4; i++) {
+					v |= ((unsigned int)this->data[this->cursor + i]) << (i * 8);
+				}
+
+				this->cursor += 4U;
+			}
+
+			return v;
+		}
+
+		unsigned long long u64() {
+			unsigned long long lo = this->u32();
+			unsigned long long hi = this->u32();
+
+			return (hi << 32) | lo;
+		}
+
+		float f32() {
+			unsigned int bits = this->u32();
+			float v = 0.0F;
+
+			std::memcpy(&v, &bits, sizeof(float));
+
+			return v;
+		}
+
+		std::wstring string() {
+			unsigned int n = this->u32();
+			std::wstring s;
+
+			if (this->require(size_t(n) * 2U)) {
+				for (unsigned int i = 0; i < n; i++) {
+					s.push_back((wchar_t)(this->data[this->cursor] | (this->data[this->cursor + 1] << 8)));
+					this->cursor += 2U;
+				}
+			}
+
+			return s;
+		}
+
+		DrawingColor color() {
+			float r = this->f32();
+			float g = this->f32();
+			float b = this->f32();
+			float a = this->f32();
+
+			return DrawingColor{ r, g, b, a };
+		}
+
+		DrawingRect rect() {
+			float x = this->f32();
+			float y = this->f32();
+			float w = this->f32();
+			float h = this->f32();
+
+			return DrawingRect{ x, y, w, h };
+		}
+
+		std::shared_ptr<const DrawingPath> path() {
+			auto path = std::make_shared<DrawingPath>(DrawingFillRule(this->u8()));
+			unsigned int figures = this->u32();
+
+			for (unsigned int f = 0; (f < figures) && this->okay; f++) {
+				bool closed = (this->u8() != 0U);
+				unsigned int n = this->u32();
+
+				if (this->require(size_t(n) * 8U)) {
+					for (unsigned int i = 0; i < n; i++) {
+						float x = this->f32();
+						float y = this->f32();
+
+						if (i == 0) {
+							path->move_to(x, y);
+						} else {
+							path->line_to(x, y);
+						}
+					}
+
+					if (closed) {
+						path->close();
+					}
+				}
+			}
+
+			return path;
+		}
+
+		std::shared_ptr<const DrawingImage> image() {
+			auto image = std::make_shared<DrawingImage>();
+
+			image->width = this->u32();
+			image->height = this->u32();
+
+			if (this->require(size_t(image->width) * size_t(image->height) * 4U)) {
+				image->pixels.resize(size_t(image->width) * size_t(image->height));
+
+				for (auto px = image->pixels.begin(); px != image->pixels.end(); px++) {
+					(*px) = this->u32();
+				}
+			}
+
+			return image;
+		}
+
+		const unsigned char* take(size_t n) {
+			const unsigned char* bytes = nullptr;
+
+			if (this->require(n)) {
+				bytes = this->data + this->cursor;
+				this->cursor += n;
+			}
+
+			return bytes;
+		}
+
+	private:
+		bool require(size_t n) {
+			if (this->okay && ((this->size - this->cursor) < n)) {
+				this->okay = false;
+			}
+
+			return this->okay;
+		}
+
+	private:
+		const unsigned char* data;
+		size_t size;
+		size_t cursor;
+		bool okay;
+	};
+}
+
+static bool replay_run(DisplayList& dl, const void* tag, const std::vector<unsigned char>& run) {
+	MirrorReader in(run.data(), run.size());
+
+	while (in.good() && (!in.done())) {
+		switch (DrawingCommandType(in.u8())) {
+		case DrawingCommandType::Clear: dl.clear(in.color()); break;
+		case DrawingCommandType::FillPath: {
+			DrawingColor color = in.color();
+
+			dl.fill_shared_path(in.path(), color);
+		}; break;
+		case DrawingCommandType::StrokePath: {
+			DrawingColor color = in.color();
+			float thickness = in.f32();
+
+			dl.stroke_shared_path(in.path(), color, thickness);
+		}; break;
+		case DrawingCommandType::Text: {
+			DrawingColor color = in.color();
+			float x = in.f32();
+			float y = in.f32();
+			DrawingFont font;
+
+			font.family = in.string();
+			font.size = in.f32();
+			font.bold = (in.u8() != 0U);
+			dl.draw_text(in.string(), x, y, font, color);
+		}; break;
+		case DrawingCommandType::Image: {
+			DrawingRect box = in.rect();
+			float opacity = in.f32();
+
+			dl.draw_shared_image(in.image(), box.x, box.y, box.width, box.height, opacity);
+		}; break;
+		case DrawingCommandType::PushLayer: {
+			DrawingRect clip = in.rect();
+
+			dl.push_layer(clip, in.f32());
+		}; break;
+		case DrawingCommandType::SetTransform: {
+			DrawingMatrix m;
+
+			m.m11 = in.f32(); m.m12 = in.f32();
+			m.m21 = in.f32(); m.m22 = in.f32();
+			m.dx = in.f32(); m.dy = in.f32();
+			dl.set_transform(m);
+		}; break;
+		case DrawingCommandType::PopLayer: dl.pop_layer(); break;
+		case DrawingCommandType::BeginGroup: dl.begin_group(tag); break;
+		case DrawingCommandType::EndGroup: dl.end_group(); break;
+		default: return false;
+		}
+	}
+
+	return in.good();
+}
+
+/*************************************************************************************************/
+MirrorEncoder::MirrorEncoder(unsigned int keyframe_interval)
+	: keyframe_interval((keyframe_interval == 0U) ? 1U : keyframe_interval), sequence(0U), next_tag_id(1U), keyframe_requested(true) {
+	std::memset(&this->statistics, 0, sizeof(MirrorStatistics));
+}
+
+void MirrorEncoder::encode(const DisplayList& frame, std::vector<unsigned char>* message) {
+	const std::vector<DrawingCommand>& commands = frame.items();
+	bool keyframe = (this->keyframe_requested.exchange(false) || ((this->sequence % this->keyframe_interval) == 0U));
+	std::map<unsigned long long, unsigned long long> digests;
+	std::map<unsigned int, unsigned int> occurrences;
+	size_t count_offset = 0U;
+	unsigned int run_count = 0U;
+	size_t i = 0U;
+
+	message->clear();
+	write_u32(*message, mirror_magic);
+	write_u8(*message, mirror_version);
+	write_u8(*message, (keyframe ? mirror_keyframe : mirror_delta));
+	write_u32(*message, this->sequence);
+	count_offset = message->size();
+	write_u32(*message, 0U);
+
+	while (i < commands.size()) {
+		unsigned int tid = this->tag_id(commands[i].tag);
+		unsigned long long key = run_key(tid, occurrences[tid]++);
+		unsigned long long digest = fnv_offset_basis;
+		size_t end = i;
+
+		while ((end < commands.size()) && (commands[end].tag == commands[i].tag)) {
+			digest = (digest ^ commands[end].digest) * fnv_prime;
+			end += 1U;
+		}
+
+		write_u64(*message, key);
+
+		{ // write the run or refer to the one that the viewer already has
+			auto maybe_digest = this->digests.find(key);
+
+			if ((!keyframe) && (maybe_digest != this->digests.end()) && (maybe_digest->second == digest)) {
+				write_u8(*message, 0U);
+				this->statistics.reused_runs += 1U;
+			} else {
+				this->buffer.clear();
+
+				for (size_t c = i; c < end; c++) {
+					write_command(this->buffer, commands[c]);
+				}
+
+				write_u8(*message, 1U);
+				write_u32(*message, (unsigned int)this->buffer.size());
+				message->insert(message->end(), this->buffer.begin(), this->buffer.end());
+			}
+		}
+
+		digests[key] = digest;
+		run_count += 1U;
+		i = end;
+	}
+
+	for (int b = 0; b < 4; b++) {
+		(*message)[count_offset + b] = (unsigned char)((run_count >> (b * 8)) & 0xFFU);
+	}
+
+	this->digests.swap(digests);
+	this->sequence += 1U;
+
+	this->statistics.frames += 1U;
+	this->statistics.runs += run_count;
+	this->statistics.bytes += message->size();
+
+	if (keyframe) {
+		this->statistics.keyframes += 1U;
+	}
+}
+
+void MirrorEncoder::send(const DisplayList& frame, IMirrorChannel* channel) {
+	std::vector<unsigned char> message;
+
+	this->encode(frame, &message);
+	channel->send(message.data(), message.size());
+}
+
+void MirrorEncoder::request_keyframe() {
+	this->keyframe_requested = true;
+}
+
+void MirrorEncoder::forget(const void* tag) {
+	// NOTE: ids are never reused, runs of the forgotten tag fall out of `digests` with the next frame
+	this->tag_ids.erase(tag);
+}
+
+void MirrorEncoder::fill_statistics(MirrorStatistics* stats) {
+	if (stats != nullptr) {
+		(*stats) = this->statistics;
+	}
+}
+
+unsigned int MirrorEncoder::tag_id(const void* tag) {
+	unsigned int id = 0U; // `nullptr`, commands out of any group
+
+	if (tag != nullptr) {
+		auto maybe_id = this->tag_ids.find(tag);
+
+		if (maybe_id == this->tag_ids.end()) {
+			id = this->next_tag_id++;
+			this->tag_ids.insert(std::make_pair(tag, id));
+		} else {
+			id = maybe_id->second;
+		}
+	}
+
+	return id;
+}
+
+/*************************************************************************************************/
+MirrorWorker::MirrorWorker(IMirrorChannel* channel, unsigned int keyframe_interval, size_t capacity)
+	: channel(channel), encoder(keyframe_interval), capacity((capacity == 0U) ? 1U : capacity), dropped(0ULL), stopping(false) {
+	std::memset(&this->statistics, 0, sizeof(MirrorStatistics));
+	this->worker = std::thread([this]() { this->run(); });
+}
+
+MirrorWorker::~MirrorWorker() {
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		this->stopping = true;
+	}
+
+	this->wakeup.notify_all();
+
+	if (this->worker.joinable()) {
+		this->worker.join();
+	}
+
+	for (DisplayList* frame : this->frames) {
+		delete frame;
+	}
+
+	for (DisplayList* frame : this->spares) {
+		delete frame;
+	}
+}
+
+DisplayList* MirrorWorker::post(DisplayList* frame) {
+	DisplayList* next = nullptr;
+
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		if (this->frames.size() >= this->capacity) {
+			this->spares.push_back(this->frames.front());
+			this->frames.pop_front();
+			this->dropped += 1ULL;
+		}
+
+		this->frames.push_back(frame);
+
+		if (!this->spares.empty()) {
+			next = this->spares.back();
+			this->spares.pop_back();
+		}
+	}
+
+	this->wakeup.notify_one();
+
+	if (next == nullptr) {
+		next = new DisplayList();
+	}
+
+	next->reset();
+
+	return next;
+}
+
+void MirrorWorker::forget(const void* tag) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	if (tag != nullptr) {
+		this->forgotten_tags.push_back(tag);
+	}
+}
+
+void MirrorWorker::request_keyframe() {
+	this->encoder.request_keyframe();
+}
+
+void MirrorWorker::fill_statistics(MirrorStatistics* stats) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	if (stats != nullptr) {
+		(*stats) = this->statistics;
+		stats->dropped = this->dropped;
+	}
+}
+
+void MirrorWorker::run() {
+	std::deque<DisplayList*> batch;
+	std::vector<const void*> tags;
+	std::vector<unsigned char> message;
+	bool stopping = false;
+
+	while (!stopping) {
+		{
+			std::unique_lock<std::mutex> lock(this->section);
+
+			this->wakeup.wait(lock, [this]() { return this->stopping || (!this->frames.empty()); });
+
+			stopping = this->stopping;
+			batch.swap(this->frames);
+			tags.swap(this->forgotten_tags);
+		}
+
+		for (DisplayList* frame : batch) {
+			if (!stopping) {
+				this->encoder.encode(*frame, &message);
+				this->channel->send(message.data(), message.size());
+
+				if (this->channel->needs_keyframe()) {
+					this->encoder.request_keyframe();
+				}
+			}
+		}
+
+		for (const void* tag : tags) {
+			this->encoder.forget(tag);
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(this->section);
+
+			this->spares.insert(this->spares.end(), batch.begin(), batch.end());
+			this->encoder.fill_statistics(&this->statistics);
+		}
+
+		batch.clear();
+		tags.clear();
+	}
+}
+
+/*************************************************************************************************/
+MirrorViewer::MirrorViewer() : sequence(0U), stale(true) {}
+
+void MirrorViewer::feed(const unsigned char* data, size_t size) {
+	size_t consumed = 0U;
+
+	this->pending.insert(this->pending.end(), data, data + size);
+
+	while ((this->pending.size() - consumed) >= 4U) {
+		const unsigned char* head = this->pending.data() + consumed;
+		size_t length = size_t(head[0]) | (size_t(head[1]) << 8) | (size_t(head[2]) << 16) | (size_t(head[3]) << 24);
+
+		if ((this->pending.size() - consumed - 4U) < length) {
+			break;
+		}
+
+		this->apply(head + 4, length);
+		consumed += 4U + length;
+	}
+
+	this->pending.erase(this->pending.begin(), this->pending.begin() + consumed);
+}
+
+bool MirrorViewer::apply(const unsigned char* message, size_t size) {
+	MirrorReader in(message, size);
+	std::map<unsigned long long, std::vector<unsigned char>> runs;
+	std::vector<unsigned long long> order;
+	bool okay = false;
+
+	if ((in.u32() == mirror_magic) && (in.u8() == mirror_version)) {
+		unsigned char kind = in.u8();
+		unsigned int seq = in.u32();
+		unsigned int count = in.u32();
+
+		okay = (in.good() && ((kind == mirror_keyframe) || (!this->stale)));
+
+		for (unsigned int r = 0; okay && (r < count); r++) {
+			unsigned long long key = in.u64();
+
+			if (in.u8() != 0U) {
+				unsigned int length = in.u32();
+				const unsigned char* bytes = in.take(length);
+
+				if (bytes != nullptr) {
+					runs[key].assign(bytes, bytes + length);
+				}
+			} else {
+				auto maybe_run = this->runs.find(key);
+
+				if (maybe_run != this->runs.end()) {
+					runs[key] = std::move(maybe_run->second);
+				} else {
+					okay = false; // the viewer joined late or lost a message
+				}
+			}
+
+			order.push_back(key);
+			okay = (okay && in.good());
+		}
+
+		if (okay) {
+			this->current.reset();
+
+			for (auto key = order.begin(); okay && (key != order.end()); key++) {
+				okay = replay_run(this->current, run_tag(*key), runs[*key]);
+			}
+
+			this->runs.swap(runs);
+			this->sequence = seq;
+		}
+	}
+
+	this->stale = !okay;
+
+	return okay;
+}
+
+void MirrorViewer::replay(IDrawingContext* dc) {
+	this->current.replay(dc);
+}
+
+void MirrorViewer::reset() {
+	this->runs.clear();
+	this->pending.clear();
+	this->current.reset();
+	this->sequence = 0U;
+	this->stale = true;
+}
+
+/*************************************************************************************************/
+LoopbackMirrorChannel::LoopbackMirrorChannel(MirrorViewer* viewer, MirrorEncoder* source) : viewer(viewer), source(source) {}
+
+void LoopbackMirrorChannel::send(const unsigned char* message, size_t size) {
+	unsigned char length[4] = {
+		(unsigned char)(size & 0xFFU), (unsigned char)((size >> 8) & 0xFFU),
+		(unsigned char)((size >> 16) & 0xFFU), (unsigned char)((size >> 24) & 0xFFU) };
+
+	// NOTE: go through the same framing as a real wire does
+	this->viewer->feed(length, sizeof(length));
+	this->viewer->feed(message, size);
+
+	if ((this->source != nullptr) && this->viewer->needs_keyframe()) {
+		this->source->request_keyframe();
+	}
+}
+
+bool LoopbackMirrorChannel::needs_keyframe() {
+	return this->viewer->needs_keyframe();
+}
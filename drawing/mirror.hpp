@@ -0,0 +1,139 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+#include "drawing/displaylist.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Mirroring streams recorded frames to viewers instead of pixels.
+	 *
+	 * A frame is split into runs of commands that belong to the same group (say, a graphlet),
+	 *  a delta message only carries the runs whose digests have changed since the previous frame,
+	 *  the others are referred by their keys and taken from the viewer's cache.
+	 *
+	 * Messages are framed with a 32-bit length prefix on the wire, all numbers are little-endian.
+	 */
+	struct MirrorStatistics {
+		unsigned long long frames;
+		unsigned long long keyframes;
+		unsigned long long runs;
+		unsigned long long reused_runs;
+		unsigned long long bytes;
+		unsigned long long dropped; // frames that were replaced by newer ones before being encoded
+	};
+
+	class IMirrorChannel {
+	public:
+		virtual ~IMirrorChannel() noexcept {}
+
+	public:
+		virtual void send(const unsigned char* message, size_t size) = 0;
+		virtual bool needs_keyframe() { return false; } // the viewer joined late or lost a message
+	};
+
+	class MirrorEncoder {
+	public:
+		MirrorEncoder(unsigned int keyframe_interval = 120U);
+
+	public:
+		void encode(const WarGrey::SCADA::DisplayList& frame, std::vector<unsigned char>* message);
+		void send(const WarGrey::SCADA::DisplayList& frame, WarGrey::SCADA::IMirrorChannel* channel);
+		void request_keyframe(); // any thread
+		void forget(const void* tag);
+		void fill_statistics(WarGrey::SCADA::MirrorStatistics* stats);
+
+	private:
+		unsigned int tag_id(const void* tag);
+
+	private:
+		std::map<const void*, unsigned int> tag_ids;
+		std::map<unsigned long long, unsigned long long> digests; // run key => run digest of the last frame
+		std::vector<unsigned char> buffer;
+		WarGrey::SCADA::MirrorStatistics statistics;
+		unsigned int keyframe_interval;
+		unsigned int sequence;
+		unsigned int next_tag_id;
+		std::atomic<bool> keyframe_requested;
+	};
+
+	/** NOTE
+	 * Encodes and sends frames in its own thread, so that the painting thread only records and posts them.
+	 *
+	 * At most `capacity` frames wait in the queue, the oldest ones are dropped when the channel cannot keep up,
+	 *  which is safe since deltas are always made against the last frame that has actually been encoded.
+	 * Tags are forgotten after the frames posted before them have been encoded.
+	 */
+	class MirrorWorker {
+	public:
+		~MirrorWorker() noexcept;
+		MirrorWorker(WarGrey::SCADA::IMirrorChannel* channel, unsigned int keyframe_interval = 120U, size_t capacity = 2U);
+
+	public:
+		WarGrey::SCADA::DisplayList* post(WarGrey::SCADA::DisplayList* frame); // returns an empty list to record the next frame
+		void forget(const void* tag);
+		void request_keyframe();
+		void fill_statistics(WarGrey::SCADA::MirrorStatistics* stats);
+
+	private:
+		void run();
+
+	private:
+		WarGrey::SCADA::IMirrorChannel* channel;
+		WarGrey::SCADA::MirrorEncoder encoder;
+		WarGrey::SCADA::MirrorStatistics statistics;
+		std::deque<WarGrey::SCADA::DisplayList*> frames;
+		std::vector<WarGrey::SCADA::DisplayList*> spares;
+		std::vector<const void*> forgotten_tags;
+		size_t capacity;
+		unsigned long long dropped;
+		bool stopping;
+
+	private:
+		std::mutex section;
+		std::condition_variable wakeup;
+		std::thread worker;
+	};
+
+	class MirrorViewer {
+	public:
+		MirrorViewer();
+
+	public:
+		void feed(const unsigned char* data, size_t size); // bytes received from a channel, framed or partial
+		bool apply(const unsigned char* message, size_t size);
+		void replay(WarGrey::SCADA::IDrawingContext* dc);
+		void reset(); // forget everything and wait for a keyframe
+
+	public:
+		bool needs_keyframe() { return this->stale; }
+		unsigned int last_sequence() { return this->sequence; }
+		const WarGrey::SCADA::DisplayList& frame() { return this->current; }
+
+	private:
+		std::map<unsigned long long, std::vector<unsigned char>> runs;
+		std::vector<unsigned char> pending;
+		WarGrey::SCADA::DisplayList current;
+		unsigned int sequence;
+		bool stale;
+	};
+
+	/************************************************************************************************/
+	class LoopbackMirrorChannel : public WarGrey::SCADA::IMirrorChannel {
+	public:
+		LoopbackMirrorChannel(WarGrey::SCADA::MirrorViewer* viewer, WarGrey::SCADA::MirrorEncoder* source = nullptr);
+
+	public:
+		void send(const unsigned char* message, size_t size) override;
+		bool needs_keyframe() override;
+
+	private:
+		WarGrey::SCADA::MirrorViewer* viewer;
+		WarGrey::SCADA::MirrorEncoder* source;
+	};
+}
@@ -0,0 +1,240 @@
+#include <ppltasks.h>
+
+#include "drawing/mirrorsocket.hpp"
+
+#include "time.hpp"
+#include "box.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Concurrency;
+
+using namespace Windows::Foundation;
+using namespace Windows::Networking;
+using namespace Windows::Networking::Sockets;
+using namespace Windows::Storage::Streams;
+
+static const unsigned int mirror_receiving_chunk = 64U * 1024U;
+static const unsigned char mirror_keyframe_request = 'K';
+
+static void wait_for_keyframe_requests(DataReader^ reader, std::shared_ptr<std::atomic<bool>> requested) {
+	create_task(reader->LoadAsync(1U)).then([=](task<unsigned int> loading) {
+		try {
+			if (loading.get() > 0U) {
+				while (reader->UnconsumedBufferLength > 0U) {
+					if (reader->ReadByte() == mirror_keyframe_request) {
+						requested->store(true);
+					}
+				}
+
+				wait_for_keyframe_requests(reader, requested);
+			}
+		} catch (Platform::Exception^) {
+			// NOTE: the socket has been closed, the writer will notice it too
+		}
+	});
+}
+
+/*************************************************************************************************/
+SocketMirrorChannel::SocketMirrorChannel(Platform::String^ host, Platform::String^ port, Syslog* logger, long long retry_ms)
+	: host(ref new HostName(host)), port(port), socket(nullptr), writer(nullptr)
+	, logger(logger), retry_ms(retry_ms), last_attempt(0LL) {
+	this->keyframe_requested = std::make_shared<std::atomic<bool>>(true);
+}
+
+SocketMirrorChannel::~SocketMirrorChannel() {
+	this->disconnect();
+}
+
+void SocketMirrorChannel::send(const unsigned char* message, size_t size) {
+	if ((this->socket != nullptr) || this->connect()) {
+		try {
+			// NOTE: `MirrorViewer::feed()` expects the 32-bit length prefix in little-endian
+			this->writer->WriteUInt32((unsigned int)size);
+			this->writer->WriteBytes(Platform::ArrayReference<unsigned char>(const_cast<unsigned char*>(message), (unsigned int)size));
+			create_task(this->writer->StoreAsync()).get();
+		} catch (Platform::Exception^ e) {
+			if (this->logger != nullptr) {
+				this->logger->log_message(Log::Warning, L"mirror: lost the viewer: %s", e->Message->Data());
+			}
+
+			this->disconnect();
+		}
+	}
+}
+
+bool SocketMirrorChannel::needs_keyframe() {
+	return this->keyframe_requested->exchange(false);
+}
+
+bool SocketMirrorChannel::connect() {
+	long long now = current_milliseconds();
+
+	if ((this->last_attempt == 0LL) || ((now - this->last_attempt) >= this->retry_ms)) {
+		StreamSocket^ socket = ref new StreamSocket();
+
+		this->last_attempt = now;
+
+		try {
+			// NOTE: the worker thread is not an STA thread, it is okay to wait here
+			create_task(socket->ConnectAsync(this->host, this->port)).get();
+
+			this->socket = socket;
+			this->writer = ref new DataWriter(socket->OutputStream);
+			this->writer->ByteOrder = ByteOrder::LittleEndian;
+			this->keyframe_requested->store(true);
+
+			{ // NOTE: the reading task only holds the flag, not the channel
+				DataReader^ reader = ref new DataReader(socket->InputStream);
+
+				reader->InputStreamOptions = InputStreamOptions::Partial;
+				wait_for_keyframe_requests(reader, this->keyframe_requested);
+			}
+
+			if (this->logger != nullptr) {
+				this->logger->log_message(Log::Info, L"mirror: connected to %s:%s", this->host->DisplayName->Data(), this->port->Data());
+			}
+		} catch (Platform::Exception^ e) {
+			if (this->logger != nullptr) {
+				this->logger->log_message(Log::Debug, L"mirror: failed to connect to %s:%s: %s",
+					this->host->DisplayName->Data(), this->port->Data(), e->Message->Data());
+			}
+		}
+	}
+
+	return (this->socket != nullptr);
+}
+
+void SocketMirrorChannel::disconnect() {
+	if (this->socket != nullptr) {
+		try {
+			this->writer->DetachStream();
+		} catch (Platform::Exception^) {}
+
+		delete this->socket; // NOTE: `Close()` in C++/CX, it also cancels the reading task
+		this->socket = nullptr;
+		this->writer = nullptr;
+	}
+}
+
+/*************************************************************************************************/
+MirrorListener::MirrorListener(Syslog* logger)
+	: listener(nullptr), peer(nullptr), logger(logger), bytes(0ULL), fresh(false) {}
+
+MirrorListener::~MirrorListener() {
+	if (this->listener != nullptr) {
+		delete this->listener;
+	}
+
+	if (this->peer != nullptr) {
+		delete this->peer;
+	}
+}
+
+void MirrorListener::listen(Platform::String^ port) {
+	MirrorListener^ self = this; // NOTE: lambdas capture `this` as a raw pointer
+
+	this->listener = ref new StreamSocketListener();
+	this->listener->ConnectionReceived += ref new TypedEventHandler<StreamSocketListener^, StreamSocketListenerConnectionReceivedEventArgs^>(
+		this, &MirrorListener::on_connection_received);
+
+	create_task(this->listener->BindServiceNameAsync(port)).then([=](task<void> binding) {
+		try {
+			binding.get();
+
+			if (self->logger != nullptr) {
+				self->logger->log_message(Log::Info, L"mirror: waiting for the display on port %s", port->Data());
+			}
+		} catch (Platform::Exception^ e) {
+			if (self->logger != nullptr) {
+				self->logger->log_message(Log::Error, L"mirror: failed to listen on port %s: %s", port->Data(), e->Message->Data());
+			}
+		}
+	});
+}
+
+void MirrorListener::replay(IDrawingContext* dc) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	this->viewer.replay(dc);
+	this->fresh = false;
+}
+
+bool MirrorListener::has_fresh_frame() {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	return this->fresh;
+}
+
+void MirrorListener::fill_statistics(unsigned int* sequence, unsigned long long* bytes) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	SET_BOX(sequence, this->viewer.last_sequence());
+	SET_BOX(bytes, this->bytes);
+}
+
+void MirrorListener::on_connection_received(StreamSocketListener^ listener, StreamSocketListenerConnectionReceivedEventArgs^ args) {
+	StreamSocket^ peer = args->Socket;
+	DataReader^ reader = ref new DataReader(peer->InputStream);
+	DataWriter^ writer = ref new DataWriter(peer->OutputStream);
+
+	reader->InputStreamOptions = InputStreamOptions::Partial;
+
+	{ // NOTE: a new display replaces the old one, and the viewer waits for its keyframe
+		std::unique_lock<std::mutex> lock(this->section);
+
+		if (this->peer != nullptr) {
+			delete this->peer;
+		}
+
+		this->peer = peer;
+		this->viewer.reset();
+	}
+
+	if (this->logger != nullptr) {
+		this->logger->log_message(Log::Info, L"mirror: the display %s connected", peer->Information->RemoteAddress->DisplayName->Data());
+	}
+
+	this->receive(peer, reader, writer);
+}
+
+void MirrorListener::receive(StreamSocket^ peer, DataReader^ reader, DataWriter^ writer) {
+	MirrorListener^ self = this;
+
+	create_task(reader->LoadAsync(mirror_receiving_chunk)).then([=](task<unsigned int> loading) {
+		try {
+			unsigned int size = loading.get();
+
+			if (size > 0U) {
+				std::vector<unsigned char> chunk(size);
+				bool needs_keyframe = false;
+
+				reader->ReadBytes(Platform::ArrayReference<unsigned char>(chunk.data(), size));
+
+				{
+					std::unique_lock<std::mutex> lock(self->section);
+
+					if (self->peer == peer) {
+						unsigned int sequence = self->viewer.last_sequence();
+
+						self->viewer.feed(chunk.data(), chunk.size());
+						self->bytes += size;
+						self->fresh = (self->fresh || (self->viewer.last_sequence() != sequence));
+						needs_keyframe = self->viewer.needs_keyframe();
+					}
+				}
+
+				if (needs_keyframe) {
+					writer->WriteByte(mirror_keyframe_request);
+					create_task(writer->StoreAsync()).wait();
+				}
+
+				self->receive(peer, reader, writer);
+			}
+		} catch (Platform::Exception^ e) {
+			if (self->logger != nullptr) {
+				self->logger->log_message(Log::Info, L"mirror: the display disconnected: %s", e->Message->Data());
+			}
+		}
+	});
+}
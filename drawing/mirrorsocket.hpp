@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+#include "drawing/mirror.hpp"
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Mirror messages travel over TCP with the same framing as `LoopbackMirrorChannel`,
+	 *  and the viewer answers a single byte whenever it needs a keyframe.
+	 *
+	 * The channel is used by the thread of `MirrorWorker` only, it connects on the first message,
+	 *  and reconnects at most once every `retry_ms` after the viewer has gone, asking for a keyframe for the new viewer.
+	 */
+	private class SocketMirrorChannel : public WarGrey::SCADA::IMirrorChannel {
+	public:
+		~SocketMirrorChannel() noexcept;
+		SocketMirrorChannel(Platform::String^ host, Platform::String^ port, WarGrey::SCADA::Syslog* logger = nullptr, long long retry_ms = 1000LL);
+
+	public:
+		void send(const unsigned char* message, size_t size) override;
+		bool needs_keyframe() override;
+
+	private:
+		bool connect();
+		void disconnect();
+
+	private:
+		Windows::Networking::HostName^ host;
+		Platform::String^ port;
+		Windows::Networking::Sockets::StreamSocket^ socket;
+		Windows::Storage::Streams::DataWriter^ writer;
+		std::shared_ptr<std::atomic<bool>> keyframe_requested; // shared with the reading task that may outlive the channel
+		WarGrey::SCADA::Syslog* logger;
+		long long retry_ms;
+		long long last_attempt;
+	};
+
+	/** NOTE
+	 * The receiving side, it accepts one viewer connection at a time and feeds a `MirrorViewer` with what it receives.
+	 * Bytes arrive in threads of the pool, so take the frame with `replay()` rather than touching the viewer.
+	 */
+	private ref class MirrorListener sealed {
+	internal:
+		MirrorListener(WarGrey::SCADA::Syslog* logger = nullptr);
+
+	public:
+		virtual ~MirrorListener();
+
+	internal:
+		void listen(Platform::String^ port);
+		void replay(WarGrey::SCADA::IDrawingContext* dc);
+		bool has_fresh_frame(); // whether a new frame has arrived since the last replay
+		void fill_statistics(unsigned int* sequence, unsigned long long* bytes);
+
+	private:
+		void on_connection_received(Windows::Networking::Sockets::StreamSocketListener^ listener,
+			Windows::Networking::Sockets::StreamSocketListenerConnectionReceivedEventArgs^ args);
+
+		void receive(Windows::Networking::Sockets::StreamSocket^ peer,
+			Windows::Storage::Streams::DataReader^ reader, Windows::Storage::Streams::DataWriter^ writer);
+
+	private:
+		Windows::Networking::Sockets::StreamSocketListener^ listener;
+		Windows::Networking::Sockets::StreamSocket^ peer;
+		WarGrey::SCADA::MirrorViewer viewer;
+		WarGrey::SCADA::Syslog* logger;
+		std::mutex section;
+		unsigned long long bytes;
+		bool fresh;
+	};
+}
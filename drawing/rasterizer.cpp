@@ -0,0 +1,488 @@
+#include <cmath>
+#include <cstdio>
+#include <cwctype>
+#include <algorithm>
+
+#include "drawing/rasterizer.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const float rasterizer_pi = 3.14159265358979F;
+
+struct ScanCrossing {
+	float x;
+	int direction;
+};
+
+static inline unsigned int clamp_channel(float v) {
+	return (unsigned int)(std::fmin(std::fmax(v, 0.0F), 1.0F) * 255.0F + 0.5F);
+}
+
+static inline unsigned int premultiplied_pixel(const DrawingColor& c, float opacity) {
+	float a = std::fmin(std::fmax(c.a * opacity, 0.0F), 1.0F);
+
+	return (clamp_channel(a) << 24) | (clamp_channel(c.r * a) << 16) | (clamp_channel(c.g * a) << 8) | clamp_channel(c.b * a);
+}
+
+static inline unsigned int scale_pixel(unsigned int px, float s) {
+	return (clamp_channel(float(px >> 24) / 255.0F * s) << 24)
+		| (clamp_channel(float((px >> 16) & 0xFFU) / 255.0F * s) << 16)
+		| (clamp_channel(float((px >> 8) & 0xFFU) / 255.0F * s) << 8)
+		| clamp_channel(float(px & 0xFFU) / 255.0F * s);
+}
+
+static float signed_area(const std::vector<DrawingPoint>& polygon) {
+	float area = 0.0F;
+	size_t n = polygon.size();
+
+	for (size_t i = 0; i < n; i++) {
+		const DrawingPoint& p0 = polygon[i];
+		const DrawingPoint& p1 = polygon[(i + 1) % n];
+
+		area += p0.x * p1.y - p1.x * p0.y;
+	}
+
+	return area * 0.5F;
+}
+
+static void push_oriented(std::vector<std::vector<DrawingPoint>>& polygons, std::vector<DrawingPoint>&& polygon) {
+	// NOTE: stroke pieces must share the same orientation, otherwise overlaps cancel out under the nonzero rule
+	if (signed_area(polygon) < 0.0F) {
+		std::reverse(polygon.begin(), polygon.end());
+	}
+
+	polygons.push_back(std::move(polygon));
+}
+
+static void push_stroke_joint(std::vector<std::vector<DrawingPoint>>& polygons, const DrawingPoint& p, float radius) {
+	size_t n = std::max(size_t(8U), std::min(size_t(std::ceil(radius * rasterizer_pi)), size_t(64U)));
+	std::vector<DrawingPoint> disc;
+
+	for (size_t i = 0; i < n; i++) {
+		float theta = 2.0F * rasterizer_pi * float(i) / float(n);
+
+		disc.push_back(DrawingPoint{ p.x + radius * std::cos(theta), p.y + radius * std::sin(theta) });
+	}
+
+	push_oriented(polygons, std::move(disc));
+}
+
+static void push_stroke_segment(std::vector<std::vector<DrawingPoint>>& polygons, const DrawingPoint& p0, const DrawingPoint& p1, float half) {
+	float dx = p1.x - p0.x;
+	float dy = p1.y - p0.y;
+	float length = std::sqrt(dx * dx + dy * dy);
+
+	if (length > 0.0F) {
+		float nx = -dy / length * half;
+		float ny = dx / length * half;
+
+		push_oriented(polygons, std::vector<DrawingPoint>{
+			DrawingPoint{ p0.x + nx, p0.y + ny }, DrawingPoint{ p1.x + nx, p1.y + ny },
+			DrawingPoint{ p1.x - nx, p1.y - ny }, DrawingPoint{ p0.x - nx, p0.y - ny } });
+	}
+}
+
+static DrawingMatrix invert(const DrawingMatrix& m, bool* okay) {
+	float det = m.m11 * m.m22 - m.m12 * m.m21;
+	DrawingMatrix inv = drawing_identity();
+
+	(*okay) = (std::fabs(det) > 1e-12F);
+
+	if (*okay) {
+		inv.m11 = m.m22 / det;
+		inv.m12 = -m.m12 / det;
+		inv.m21 = -m.m21 / det;
+		inv.m22 = m.m11 / det;
+		inv.dx = (m.m21 * m.dy - m.m22 * m.dx) / det;
+		inv.dy = (m.m12 * m.dx - m.m11 * m.dy) / det;
+	}
+
+	return inv;
+}
+
+/*************************************************************************************************/
+SoftwareDrawingContext::SoftwareDrawingContext(unsigned int width, unsigned int height, unsigned int samples)
+	: transform(drawing_identity()), width(width), height(height), samples(std::max(samples, 1U)) {
+	SoftwareDrawingContext::Layer surface;
+
+	surface.buffer.width = width;
+	surface.buffer.height = height;
+	surface.buffer.pixels.assign(size_t(width) * size_t(height), 0U);
+	surface.buffer_x = 0;
+	surface.buffer_y = 0;
+	surface.target = 0U;
+	surface.clip_x0 = 0;
+	surface.clip_y0 = 0;
+	surface.clip_x1 = int(width);
+	surface.clip_y1 = int(height);
+	surface.opacity = 1.0F;
+
+	this->layers.push_back(std::move(surface));
+	this->coverage.assign(size_t(width) + 1U, 0.0F);
+}
+
+void SoftwareDrawingContext::clear(const DrawingColor& color) {
+	SoftwareDrawingContext::Layer* layer = this->top_layer();
+	unsigned int px = premultiplied_pixel(color, 1.0F);
+
+	for (int y = layer->clip_y0; y < layer->clip_y1; y++) {
+		unsigned int* row = this->pixel_address(layer->clip_x0, y);
+
+		std::fill(row, row + (layer->clip_x1 - layer->clip_x0), px);
+	}
+}
+
+void SoftwareDrawingContext::fill_path(const DrawingPath& path, const DrawingColor& color) {
+	SoftwareDrawingContext::Polygons polygons;
+
+	for (auto figure = path.figures().begin(); figure != path.figures().end(); figure++) {
+		std::vector<DrawingPoint> polygon;
+
+		for (auto p = figure->points.begin(); p != figure->points.end(); p++) {
+			polygon.push_back(drawing_apply(this->transform, p->x, p->y));
+		}
+
+		if (polygon.size() > 2) {
+			polygons.push_back(std::move(polygon));
+		}
+	}
+
+	this->rasterize(polygons, path.fill_rule(), color);
+}
+
+void SoftwareDrawingContext::stroke_path(const DrawingPath& path, const DrawingColor& color, float thickness) {
+	SoftwareDrawingContext::Polygons pieces;
+	SoftwareDrawingContext::Polygons polygons;
+	float half = thickness * 0.5F;
+
+	for (auto figure = path.figures().begin(); figure != path.figures().end(); figure++) {
+		size_t n = figure->points.size();
+		size_t segments = (figure->closed ? n : ((n > 0) ? n - 1 : 0));
+
+		for (size_t i = 0; i < segments; i++) {
+			push_stroke_segment(pieces, figure->points[i], figure->points[(i + 1) % n], half);
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (figure->closed || ((i > 0) && (i + 1 < n))) {
+				push_stroke_joint(pieces, figure->points[i], half);
+			}
+		}
+	}
+
+	for (auto piece = pieces.begin(); piece != pieces.end(); piece++) {
+		std::vector<DrawingPoint> polygon;
+
+		for (auto p = piece->begin(); p != piece->end(); p++) {
+			polygon.push_back(drawing_apply(this->transform, p->x, p->y));
+		}
+
+		polygons.push_back(std::move(polygon));
+	}
+
+	this->rasterize(polygons, DrawingFillRule::NonZero, color);
+}
+
+void SoftwareDrawingContext::draw_image(const DrawingImage& image, float x, float y, float width, float height, float opacity) {
+	SoftwareDrawingContext::Layer* layer = this->top_layer();
+	DrawingMatrix local = drawing_multiply(drawing_translation(x, y), this->transform);
+	bool invertible = false;
+	DrawingMatrix inverse = invert(local, &invertible);
+
+	if (invertible && (image.width > 0) && (image.height > 0) && (width > 0.0F) && (height > 0.0F)) {
+		DrawingPoint corners[4] = {
+			drawing_apply(local, 0.0F, 0.0F), drawing_apply(local, width, 0.0F),
+			drawing_apply(local, width, height), drawing_apply(local, 0.0F, height) };
+		float xmin = corners[0].x, xmax = corners[0].x, ymin = corners[0].y, ymax = corners[0].y;
+		float sx = float(image.width) / width;
+		float sy = float(image.height) / height;
+
+		for (int i = 1; i < 4; i++) {
+			xmin = std::fmin(xmin, corners[i].x);
+			xmax = std::fmax(xmax, corners[i].x);
+			ymin = std::fmin(ymin, corners[i].y);
+			ymax = std::fmax(ymax, corners[i].y);
+		}
+
+		int px0 = std::max(int(std::floor(xmin)), layer->clip_x0);
+		int px1 = std::min(int(std::ceil(xmax)), layer->clip_x1);
+
+		for (int py = std::max(int(std::floor(ymin)), layer->clip_y0); (px0 < px1) && (py < std::min(int(std::ceil(ymax)), layer->clip_y1)); py++) {
+			unsigned int* row = this->pixel_address(px0, py);
+
+			for (int px = px0; px < px1; px++) {
+				DrawingPoint src = drawing_apply(inverse, float(px) + 0.5F, float(py) + 0.5F);
+
+				if ((src.x >= 0.0F) && (src.y >= 0.0F) && (src.x < width) && (src.y < height)) {
+					unsigned int ix = std::min((unsigned int)(src.x * sx), image.width - 1);
+					unsigned int iy = std::min((unsigned int)(src.y * sy), image.height - 1);
+
+					this->blend(row + (px - px0), image.pixels[size_t(iy) * image.width + ix], opacity);
+				}
+			}
+		}
+	}
+}
+
+void SoftwareDrawingContext::draw_text(const std::wstring& text, float x, float y, const DrawingFont& font, const DrawingColor& color) {
+	float advance = font.size * (font.bold ? 0.55F : 0.5F);
+	float line_height = font.size * 1.2F;
+	float cx = x;
+	DrawingPath cells;
+
+	for (auto ch = text.begin(); ch != text.end(); ch++) {
+		if ((*ch) == L'\n') {
+			cx = x;
+			y += line_height;
+		} else {
+			if (!std::iswspace(*ch)) {
+				cells.add_rectangle(cx + advance * 0.1F, y + font.size * 0.3F, advance * 0.8F, font.size * 0.75F);
+			}
+
+			cx += advance;
+		}
+	}
+
+	this->fill_path(cells, color);
+}
+
+DrawingRect SoftwareDrawingContext::measure_text(const std::wstring& text, const DrawingFont& font) {
+	float advance = font.size * (font.bold ? 0.55F : 0.5F);
+	size_t columns = 0U;
+	size_t lines = 1U;
+	size_t current = 0U;
+
+	for (auto ch = text.begin(); ch != text.end(); ch++) {
+		if ((*ch) == L'\n') {
+			lines += 1U;
+			current = 0U;
+		} else {
+			current += 1U;
+			columns = std::max(columns, current);
+		}
+	}
+
+	return DrawingRect{ 0.0F, 0.0F, advance * float(columns), font.size * 1.2F * float(lines) };
+}
+
+void SoftwareDrawingContext::push_layer(const DrawingRect& clip, float opacity) {
+	SoftwareDrawingContext::Layer* parent = this->top_layer();
+	SoftwareDrawingContext::Layer layer;
+	DrawingPoint corners[4] = {
+		drawing_apply(this->transform, clip.x, clip.y), drawing_apply(this->transform, clip.x + clip.width, clip.y),
+		drawing_apply(this->transform, clip.x + clip.width, clip.y + clip.height), drawing_apply(this->transform, clip.x, clip.y + clip.height) };
+	float xmin = corners[0].x, xmax = corners[0].x, ymin = corners[0].y, ymax = corners[0].y;
+
+	for (int i = 1; i < 4; i++) {
+		xmin = std::fmin(xmin, corners[i].x);
+		xmax = std::fmax(xmax, corners[i].x);
+		ymin = std::fmin(ymin, corners[i].y);
+		ymax = std::fmax(ymax, corners[i].y);
+	}
+
+	layer.clip_x0 = std::max(int(std::floor(xmin)), parent->clip_x0);
+	layer.clip_y0 = std::max(int(std::floor(ymin)), parent->clip_y0);
+	layer.clip_x1 = std::max(std::min(int(std::ceil(xmax)), parent->clip_x1), layer.clip_x0);
+	layer.clip_y1 = std::max(std::min(int(std::ceil(ymax)), parent->clip_y1), layer.clip_y0);
+	layer.opacity = std::fmin(std::fmax(opacity, 0.0F), 1.0F);
+
+	if (layer.opacity < 1.0F) {
+		layer.buffer.width = (unsigned int)(layer.clip_x1 - layer.clip_x0);
+		layer.buffer.height = (unsigned int)(layer.clip_y1 - layer.clip_y0);
+		layer.buffer.pixels.assign(size_t(layer.buffer.width) * size_t(layer.buffer.height), 0U);
+		layer.buffer_x = layer.clip_x0;
+		layer.buffer_y = layer.clip_y0;
+		layer.target = this->layers.size();
+	} else {
+		// NOTE: opaque layers only clip, they draw into the buffer of the parent directly
+		layer.buffer.width = 0U;
+		layer.buffer.height = 0U;
+		layer.buffer_x = 0;
+		layer.buffer_y = 0;
+		layer.target = parent->target;
+	}
+
+	this->layers.push_back(std::move(layer));
+}
+
+void SoftwareDrawingContext::pop_layer() {
+	if (this->layers.size() > 1) {
+		size_t index = this->layers.size() - 1U;
+		SoftwareDrawingContext::Layer layer = std::move(this->layers.back());
+
+		this->layers.pop_back();
+
+		if (layer.target == index) {
+			for (int y = layer.clip_y0; y < layer.clip_y1; y++) {
+				const unsigned int* src = layer.buffer.pixels.data() + size_t(y - layer.buffer_y) * layer.buffer.width;
+				unsigned int* dest = this->pixel_address(layer.clip_x0, y);
+
+				for (int x = 0; x < layer.clip_x1 - layer.clip_x0; x++) {
+					if (src[x] != 0U) {
+						this->blend(dest + x, src[x], layer.opacity);
+					}
+				}
+			}
+		}
+	}
+}
+
+void SoftwareDrawingContext::set_transform(const DrawingMatrix& m) {
+	this->transform = m;
+}
+
+DrawingMatrix SoftwareDrawingContext::get_transform() {
+	return this->transform;
+}
+
+const DrawingImage& SoftwareDrawingContext::surface() {
+	return this->layers.front().buffer;
+}
+
+unsigned int SoftwareDrawingContext::pixel(unsigned int x, unsigned int y) {
+	unsigned int px = 0U;
+
+	if ((x < this->width) && (y < this->height)) {
+		px = this->layers.front().buffer.pixels[size_t(y) * this->width + x];
+	}
+
+	return px;
+}
+
+bool SoftwareDrawingContext::save_ppm(const char* path) {
+	FILE* ppm = std::fopen(path, "wb");
+	bool okay = (ppm != nullptr);
+
+	if (okay) {
+		const std::vector<unsigned int>& pixels = this->layers.front().buffer.pixels;
+
+		// NOTE: premultiplied pixels over black are exactly the color channels
+		std::fprintf(ppm, "P6\n%u %u\n255\n", this->width, this->height);
+
+		for (auto px = pixels.begin(); px != pixels.end(); px++) {
+			unsigned char rgb[3] = {
+				(unsigned char)(((*px) >> 16) & 0xFFU),
+				(unsigned char)(((*px) >> 8) & 0xFFU),
+				(unsigned char)((*px) & 0xFFU) };
+
+			std::fwrite(rgb, 1, sizeof(rgb), ppm);
+		}
+
+		okay = (std::fclose(ppm) == 0);
+	}
+
+	return okay;
+}
+
+/*************************************************************************************************/
+void SoftwareDrawingContext::rasterize(const SoftwareDrawingContext::Polygons& polygons, DrawingFillRule rule, const DrawingColor& color) {
+	SoftwareDrawingContext::Layer* layer = this->top_layer();
+	unsigned int src = premultiplied_pixel(color, 1.0F);
+	float ymin = INFINITY;
+	float ymax = -INFINITY;
+	std::vector<ScanCrossing> crossings;
+
+	for (auto polygon = polygons.begin(); polygon != polygons.end(); polygon++) {
+		for (auto p = polygon->begin(); p != polygon->end(); p++) {
+			ymin = std::fmin(ymin, p->y);
+			ymax = std::fmax(ymax, p->y);
+		}
+	}
+
+	if ((src != 0U) && (ymin < ymax)) {
+		int y0 = std::max(int(std::floor(ymin)), layer->clip_y0);
+		int y1 = std::min(int(std::ceil(ymax)), layer->clip_y1);
+		float clip_x0 = float(layer->clip_x0);
+		float clip_x1 = float(layer->clip_x1);
+		float weight = 1.0F / float(this->samples);
+
+		for (int y = y0; y < y1; y++) {
+			int span_x0 = layer->clip_x1;
+			int span_x1 = layer->clip_x0;
+
+			for (unsigned int s = 0; s < this->samples; s++) {
+				float sy = float(y) + (float(s) + 0.5F) * weight;
+				int winding = 0;
+
+				crossings.clear();
+				for (auto polygon = polygons.begin(); polygon != polygons.end(); polygon++) {
+					size_t n = polygon->size();
+
+					for (size_t i = 0; i < n; i++) {
+						const DrawingPoint& p0 = (*polygon)[i];
+						const DrawingPoint& p1 = (*polygon)[(i + 1) % n];
+
+						if ((p0.y <= sy) != (p1.y <= sy)) {
+							float t = (sy - p0.y) / (p1.y - p0.y);
+
+							crossings.push_back(ScanCrossing{ p0.x + (p1.x - p0.x) * t, ((p1.y > p0.y) ? 1 : -1) });
+						}
+					}
+				}
+
+				std::sort(crossings.begin(), crossings.end(),
+					[](const ScanCrossing& a, const ScanCrossing& b) { return a.x < b.x; });
+
+				for (size_t i = 0; i + 1 < crossings.size(); i++) {
+					winding += crossings[i].direction;
+
+					if ((rule == DrawingFillRule::EvenOdd) ? ((winding & 1) != 0) : (winding != 0)) {
+						float xa = std::fmax(crossings[i].x, clip_x0);
+						float xb = std::fmin(crossings[i + 1].x, clip_x1);
+
+						if (xa < xb) {
+							int px0 = int(std::floor(xa));
+							int px1 = int(std::ceil(xb));
+
+							for (int px = px0; px < px1; px++) {
+								float overlap = std::fmin(xb, float(px + 1)) - std::fmax(xa, float(px));
+
+								this->coverage[px] += overlap * weight;
+							}
+
+							span_x0 = std::min(span_x0, px0);
+							span_x1 = std::max(span_x1, px1);
+						}
+					}
+				}
+			}
+
+			if (span_x0 < span_x1) {
+				unsigned int* row = this->pixel_address(span_x0, y);
+
+				for (int px = span_x0; px < span_x1; px++) {
+					if (this->coverage[px] > 0.0F) {
+						this->blend(row + (px - span_x0), src, std::fmin(this->coverage[px], 1.0F));
+						this->coverage[px] = 0.0F;
+					}
+				}
+			}
+		}
+	}
+}
+
+void SoftwareDrawingContext::blend(unsigned int* dest, unsigned int src, float coverage) {
+	unsigned int s = ((coverage >= 1.0F) ? src : scale_pixel(src, coverage));
+	float inverse = 1.0F - float(s >> 24) / 255.0F;
+
+	if (inverse <= 0.0F) {
+		(*dest) = s;
+	} else {
+		unsigned int d = (*dest);
+
+		(*dest) = ((std::min(255U, (s >> 24) + (unsigned int)(float(d >> 24) * inverse + 0.5F))) << 24)
+			| ((std::min(255U, ((s >> 16) & 0xFFU) + (unsigned int)(float((d >> 16) & 0xFFU) * inverse + 0.5F))) << 16)
+			| ((std::min(255U, ((s >> 8) & 0xFFU) + (unsigned int)(float((d >> 8) & 0xFFU) * inverse + 0.5F))) << 8)
+			| (std::min(255U, (s & 0xFFU) + (unsigned int)(float(d & 0xFFU) * inverse + 0.5F)));
+	}
+}
+
+unsigned int* SoftwareDrawingContext::pixel_address(int x, int y) {
+	SoftwareDrawingContext::Layer* target = &this->layers[this->top_layer()->target];
+
+	return target->buffer.pixels.data() + size_t(y - target->buffer_y) * target->buffer.width + size_t(x - target->buffer_x);
+}
+
+SoftwareDrawingContext::Layer* SoftwareDrawingContext::top_layer() {
+	return &this->layers.back();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "drawing/context.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Headless software rasterizer, it renders into premultiplied 32-bit pixels with
+	 *  nonzero/even-odd scanline filling and `samples` sub-scanlines per pixel row for anti-aliasing.
+	 *
+	 * It aims at pixel tests and frame-time benchmarks of the layout, not at matching Direct2D bit by bit:
+	 *  strokes have flat caps and round joins, and texts are greeked into glyph cells since no font engine is involved.
+	 */
+	class SoftwareDrawingContext : public WarGrey::SCADA::IDrawingContext {
+	public:
+		SoftwareDrawingContext(unsigned int width, unsigned int height, unsigned int samples = 4U);
+
+	public:
+		void clear(const WarGrey::SCADA::DrawingColor& color) override;
+		void fill_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color) override;
+		void stroke_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color, float thickness) override;
+		void draw_image(const WarGrey::SCADA::DrawingImage& image, float x, float y, float width, float height, float opacity = 1.0F) override;
+
+	public:
+		void draw_text(const std::wstring& text, float x, float y,
+			const WarGrey::SCADA::DrawingFont& font, const WarGrey::SCADA::DrawingColor& color) override;
+
+		WarGrey::SCADA::DrawingRect measure_text(const std::wstring& text, const WarGrey::SCADA::DrawingFont& font) override;
+
+	public:
+		void push_layer(const WarGrey::SCADA::DrawingRect& clip, float opacity = 1.0F) override;
+		void pop_layer() override;
+
+	public:
+		void set_transform(const WarGrey::SCADA::DrawingMatrix& m) override;
+		WarGrey::SCADA::DrawingMatrix get_transform() override;
+
+	public:
+		const WarGrey::SCADA::DrawingImage& surface();
+		unsigned int pixel(unsigned int x, unsigned int y);
+		bool save_ppm(const char* path);
+
+	private:
+		struct Layer {
+			WarGrey::SCADA::DrawingImage buffer; // only translucent layers own buffers, which just cover their clips
+			int buffer_x;
+			int buffer_y;
+			size_t target;                       // the index of the layer whose buffer is drawn into
+			int clip_x0;
+			int clip_y0;
+			int clip_x1;
+			int clip_y1;
+			float opacity;
+		};
+
+		typedef std::vector<std::vector<WarGrey::SCADA::DrawingPoint>> Polygons;
+
+	private:
+		void rasterize(const Polygons& polygons, WarGrey::SCADA::DrawingFillRule rule, const WarGrey::SCADA::DrawingColor& color);
+		void blend(unsigned int* dest, unsigned int src, float coverage);
+		unsigned int* pixel_address(int x, int y);
+		WarGrey::SCADA::SoftwareDrawingContext::Layer* top_layer();
+
+	private:
+		std::vector<WarGrey::SCADA::SoftwareDrawingContext::Layer> layers;
+		std::vector<float> coverage;
+		WarGrey::SCADA::DrawingMatrix transform;
+		unsigned int width;
+		unsigned int height;
+		unsigned int samples;
+	};
+}
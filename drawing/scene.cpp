@@ -0,0 +1,112 @@
+#include <cmath>
+
+#include "drawing/scene.hpp"
+
+using namespace WarGrey::SCADA;
+
+static inline bool scene_item_culled(const DrawingSceneItem& item, const DrawingRect& viewport) {
+	float margin = std::fabs(item.width) + std::fabs(item.height); // NOTE: rotated items may reach their diagonals
+
+	if (item.radians == 0.0F) {
+		margin = 0.0F;
+	}
+
+	return (((item.x - margin) >= (viewport.x + viewport.width)) || ((item.x + item.width + margin) <= viewport.x)
+		|| ((item.y - margin) >= (viewport.y + viewport.height)) || ((item.y + item.height + margin) <= viewport.y));
+}
+
+/*************************************************************************************************/
+DrawingScene::DrawingScene() : viewport_set(false) {
+	this->background = drawing_color(0x000000, 0.0F);
+	this->selection_color = drawing_color(0x1E90FF);
+	this->viewport = DrawingRect{ 0.0F, 0.0F, 0.0F, 0.0F };
+	this->background_corner_radius = 0.0F;
+}
+
+void DrawingScene::set_background(const DrawingColor& color, float corner_radius) {
+	this->background = color;
+	this->background_corner_radius = corner_radius;
+}
+
+void DrawingScene::set_selection_color(const DrawingColor& color) {
+	this->selection_color = color;
+}
+
+void DrawingScene::set_viewport(float x, float y, float width, float height) {
+	this->viewport = DrawingRect{ x, y, width, height };
+	this->viewport_set = true;
+}
+
+void DrawingScene::push_decorator(IDrawingSceneDecorator* decorator) {
+	this->decorators.push_back(decorator);
+}
+
+void DrawingScene::push_item(const DrawingSceneItem& item) {
+	this->items.push_back(item);
+}
+
+void DrawingScene::reset() {
+	this->items.clear();
+	this->decorators.clear();
+	this->viewport_set = false;
+}
+
+size_t DrawingScene::render(IDrawingContext* dc, float Width, float Height) {
+	DrawingRect viewport = (this->viewport_set ? this->viewport : DrawingRect{ 0.0F, 0.0F, Width, Height });
+	size_t rendered = 0U;
+
+	if (this->background.a > 0.0F) {
+		DrawingPath shape;
+
+		shape.add_rounded_rectangle(0.0F, 0.0F, Width, Height, this->background_corner_radius, this->background_corner_radius);
+		dc->fill_path(shape, this->background);
+	}
+
+	for (IDrawingSceneDecorator* decorator : this->decorators) {
+		decorator->render_before(dc, Width, Height);
+	}
+
+	for (auto item = this->items.begin(); item != this->items.end(); item++) {
+		if (!scene_item_culled(*item, viewport)) {
+			if (item->radians != 0.0F) {
+				dc->push_transform(drawing_rotation(item->radians, item->x + item->width * 0.5F, item->y + item->height * 0.5F));
+			}
+
+			dc->begin_group(item->self);
+			dc->push_layer(DrawingRect{ item->x, item->y, item->width, item->height }, item->alpha);
+
+			for (IDrawingSceneDecorator* decorator : this->decorators) {
+				decorator->render_before_item(item->self, dc, item->x, item->y, item->width, item->height, item->selected);
+			}
+
+			if (item->ready) {
+				item->self->render(dc, item->x, item->y, item->width, item->height);
+			} else {
+				item->self->render_progress(dc, item->x, item->y, item->width, item->height);
+			}
+
+			for (IDrawingSceneDecorator* decorator : this->decorators) {
+				decorator->render_after_item(item->self, dc, item->x, item->y, item->width, item->height, item->selected);
+			}
+
+			if (item->selected) {
+				dc->stroke_rectangle(item->x + 0.5F, item->y + 0.5F, item->width - 1.0F, item->height - 1.0F, this->selection_color);
+			}
+
+			dc->pop_layer();
+			dc->end_group();
+
+			if (item->radians != 0.0F) {
+				dc->pop_transform();
+			}
+
+			rendered += 1U;
+		}
+	}
+
+	for (IDrawingSceneDecorator* decorator : this->decorators) {
+		decorator->render_after(dc, Width, Height);
+	}
+
+	return rendered;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "drawing/context.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Anything that is able to draw itself into a drawing context, say, sprites and graphlets.
+	 */
+	class IDrawingRenderable {
+	public:
+		virtual ~IDrawingRenderable() noexcept {}
+
+	public:
+		virtual void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) {}
+		virtual void render_progress(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) {}
+	};
+
+	class IDrawingSceneDecorator {
+	public:
+		virtual ~IDrawingSceneDecorator() noexcept {}
+
+	public:
+		virtual void render_before(WarGrey::SCADA::IDrawingContext* dc, float Width, float Height) {}
+		virtual void render_after(WarGrey::SCADA::IDrawingContext* dc, float Width, float Height) {}
+
+		virtual void render_before_item(WarGrey::SCADA::IDrawingRenderable* item, WarGrey::SCADA::IDrawingContext* dc,
+			float x, float y, float width, float height, bool selected) {}
+
+		virtual void render_after_item(WarGrey::SCADA::IDrawingRenderable* item, WarGrey::SCADA::IDrawingContext* dc,
+			float x, float y, float width, float height, bool selected) {}
+	};
+
+	struct DrawingSceneItem {
+		WarGrey::SCADA::IDrawingRenderable* self;
+		float x;
+		float y;
+		float width;
+		float height;
+		float radians;
+		float alpha;
+		bool ready;
+		bool selected;
+	};
+
+	/** NOTE
+	 * The portable counterpart of the drawing loop of planets:
+	 *  the owner collects its items in z-order, and the scene renders them with the same rules as the Win2D loop,
+	 *  that is, culling, rotating, clipping, progress of unready items, decorators and selections.
+	 *
+	 * Every item is rendered in a group tagged with itself, see `DisplayList`.
+	 */
+	class DrawingScene {
+	public:
+		DrawingScene();
+
+	public:
+		void set_background(const WarGrey::SCADA::DrawingColor& color, float corner_radius = 0.0F);
+		void set_selection_color(const WarGrey::SCADA::DrawingColor& color);
+		void set_viewport(float x, float y, float width, float height); // items out of it are culled
+		void push_decorator(WarGrey::SCADA::IDrawingSceneDecorator* decorator);
+		void push_item(const WarGrey::SCADA::DrawingSceneItem& item);
+		void reset();
+
+	public:
+		size_t render(WarGrey::SCADA::IDrawingContext* dc, float Width, float Height); // returns the number of rendered items
+
+	private:
+		std::vector<WarGrey::SCADA::DrawingSceneItem> items;
+		std::vector<WarGrey::SCADA::IDrawingSceneDecorator*> decorators;
+		WarGrey::SCADA::DrawingColor background;
+		WarGrey::SCADA::DrawingColor selection_color;
+		WarGrey::SCADA::DrawingRect viewport;
+		float background_corner_radius;
+		bool viewport_set;
+	};
+}
@@ -0,0 +1,249 @@
+#include <cmath>
+#include <algorithm>
+
+#include "drawing/win2d.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Windows::UI;
+using namespace Windows::UI::Text;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Numerics;
+using namespace Windows::Graphics::DirectX;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::Text;
+using namespace Microsoft::Graphics::Canvas::Brushes;
+using namespace Microsoft::Graphics::Canvas::Geometry;
+
+static const size_t geometry_cache_limit = 1024U;
+
+static inline Color win2d_color(const DrawingColor& c) {
+	auto channel = [](float v) { return (unsigned char)(std::fmin(std::fmax(v, 0.0F), 1.0F) * 255.0F + 0.5F); };
+
+	return ColorHelper::FromArgb(channel(c.a), channel(c.r), channel(c.g), channel(c.b));
+}
+
+static CanvasTextFormat^ win2d_text_format(const DrawingFont& font) {
+	CanvasTextFormat^ format = ref new CanvasTextFormat();
+
+	format->FontFamily = ref new Platform::String(font.family.c_str());
+	format->FontSize = font.size;
+	format->FontWeight = (font.bold ? FontWeights::Bold : FontWeights::Normal);
+	format->WordWrapping = CanvasWordWrapping::NoWrap;
+
+	return format;
+}
+
+static CanvasGeometry^ win2d_geometry(ICanvasResourceCreator^ device, const DrawingPath& path) {
+	CanvasPathBuilder^ pb = ref new CanvasPathBuilder(device);
+
+	pb->SetFilledRegionDetermination((path.fill_rule() == DrawingFillRule::EvenOdd)
+		? CanvasFilledRegionDetermination::Alternate
+		: CanvasFilledRegionDetermination::Winding);
+
+	for (auto figure = path.figures().begin(); figure != path.figures().end(); figure++) {
+		if (!figure->points.empty()) {
+			pb->BeginFigure(figure->points[0].x, figure->points[0].y);
+
+			for (size_t i = 1; i < figure->points.size(); i++) {
+				pb->AddLine(figure->points[i].x, figure->points[i].y);
+			}
+
+			pb->EndFigure(figure->closed ? CanvasFigureLoop::Closed : CanvasFigureLoop::Open);
+		}
+	}
+
+	return CanvasGeometry::CreatePath(pb);
+}
+
+static DrawingColor gradient_color(const Platform::Array<CanvasGradientStop>^ stops, float opacity) {
+	float r = 0.0F;
+	float g = 0.0F;
+	float b = 0.0F;
+	float a = 0.0F;
+	float n = float(std::max(stops->Length, 1U)) * 255.0F;
+
+	for (unsigned int i = 0; i < stops->Length; i++) {
+		r += float(stops[i].Color.R);
+		g += float(stops[i].Color.G);
+		b += float(stops[i].Color.B);
+		a += float(stops[i].Color.A);
+	}
+
+	return DrawingColor{ r / n, g / n, b / n, a / n * opacity };
+}
+
+/*************************************************************************************************/
+DrawingColor WarGrey::SCADA::drawing_color(ICanvasBrush^ brush) {
+	CanvasSolidColorBrush^ solid = dynamic_cast<CanvasSolidColorBrush^>(brush);
+	CanvasLinearGradientBrush^ linear = dynamic_cast<CanvasLinearGradientBrush^>(brush);
+	CanvasRadialGradientBrush^ radial = dynamic_cast<CanvasRadialGradientBrush^>(brush);
+	DrawingColor color = drawing_color(0x000000U, 0.0F);
+
+	if (solid != nullptr) {
+		color = DrawingColor{
+			float(solid->Color.R) / 255.0F, float(solid->Color.G) / 255.0F, float(solid->Color.B) / 255.0F,
+			float(solid->Color.A) / 255.0F * solid->Opacity };
+	} else if (linear != nullptr) {
+		color = gradient_color(linear->Stops, linear->Opacity);
+	} else if (radial != nullptr) {
+		color = gradient_color(radial->Stops, radial->Opacity);
+	}
+
+	return color;
+}
+
+DrawingFont WarGrey::SCADA::drawing_font(CanvasTextFormat^ font) {
+	DrawingFont df = { L"Segoe UI", 12.0F, false };
+
+	if (font != nullptr) {
+		df.family = font->FontFamily->Data();
+		df.size = font->FontSize;
+		df.bold = (font->FontWeight.Weight >= FontWeights::SemiBold.Weight);
+	}
+
+	return df;
+}
+
+std::shared_ptr<DrawingPath> WarGrey::SCADA::drawing_path(CanvasGeometry^ g) {
+	std::shared_ptr<DrawingPath> path = std::make_shared<DrawingPath>(DrawingFillRule::NonZero);
+
+	if (g != nullptr) {
+		Platform::Array<CanvasTriangleVertices>^ triangles = g->Tessellate();
+
+		for (unsigned int i = 0; i < triangles->Length; i++) {
+			float2 v1 = triangles[i].Vertex1;
+			float2 v2 = triangles[i].Vertex2;
+			float2 v3 = triangles[i].Vertex3;
+
+			// NOTE: triangles never overlap, orienting them the same way keeps their shared edges seamless under the nonzero rule
+			path->move_to(v1.x, v1.y);
+
+			if ((v2.x - v1.x) * (v3.y - v1.y) - (v3.x - v1.x) * (v2.y - v1.y) >= 0.0F) {
+				path->line_to(v2.x, v2.y);
+				path->line_to(v3.x, v3.y);
+			} else {
+				path->line_to(v3.x, v3.y);
+				path->line_to(v2.x, v2.y);
+			}
+
+			path->close();
+		}
+	}
+
+	path->set_persistent(true);
+
+	return path;
+}
+
+/*************************************************************************************************/
+Win2DDrawingContext::Win2DDrawingContext(CanvasDrawingSession^ ds) : ds(ds) {}
+
+void Win2DDrawingContext::attach(CanvasDrawingSession^ ds) {
+	while (!this->layers.empty()) {
+		this->pop_layer();
+	}
+
+	if ((this->ds != nullptr) && (ds != nullptr) && (this->ds->Device != ds->Device)) {
+		// NOTE: cached geometries belong to the device that creates them
+		this->geometries.clear();
+	}
+
+	this->ds = ds;
+}
+
+void Win2DDrawingContext::clear_geometry_cache() {
+	this->geometries.clear();
+}
+
+void Win2DDrawingContext::clear(const DrawingColor& color) {
+	this->ds->Clear(win2d_color(color));
+}
+
+void Win2DDrawingContext::fill_path(const DrawingPath& path, const DrawingColor& color) {
+	if (path.is_persistent()) {
+		this->ds->DrawCachedGeometry(this->cached_geometry(path, 0.0F), win2d_color(color));
+	} else {
+		this->ds->FillGeometry(win2d_geometry(this->ds, path), win2d_color(color));
+	}
+}
+
+void Win2DDrawingContext::stroke_path(const DrawingPath& path, const DrawingColor& color, float thickness) {
+	if (path.is_persistent()) {
+		this->ds->DrawCachedGeometry(this->cached_geometry(path, thickness), win2d_color(color));
+	} else {
+		this->ds->DrawGeometry(win2d_geometry(this->ds, path), win2d_color(color), thickness);
+	}
+}
+
+void Win2DDrawingContext::draw_image(const DrawingImage& image, float x, float y, float width, float height, float opacity) {
+	if ((image.width > 0) && (image.height > 0)) {
+		// NOTE: premultiplied 0xAARRGGBB in little endian is exactly the byte order of B8G8R8A8
+		auto bytes = Platform::ArrayReference<unsigned char>(
+			reinterpret_cast<unsigned char*>(const_cast<unsigned int*>(image.pixels.data())),
+			(unsigned int)(image.pixels.size() * sizeof(unsigned int)));
+
+		CanvasBitmap^ bitmap = CanvasBitmap::CreateFromBytes(this->ds, bytes,
+			image.width, image.height, DirectXPixelFormat::B8G8R8A8UIntNormalized);
+
+		this->ds->DrawImage(bitmap, Rect(x, y, width, height), bitmap->Bounds, opacity);
+	}
+}
+
+void Win2DDrawingContext::draw_text(const std::wstring& text, float x, float y, const DrawingFont& font, const DrawingColor& color) {
+	this->ds->DrawText(ref new Platform::String(text.c_str()), x, y, win2d_color(color), win2d_text_format(font));
+}
+
+DrawingRect Win2DDrawingContext::measure_text(const std::wstring& text, const DrawingFont& font) {
+	CanvasTextLayout^ layout = ref new CanvasTextLayout(this->ds,
+		ref new Platform::String(text.c_str()), win2d_text_format(font), 0.0F, 0.0F);
+	Rect box = layout->LayoutBounds;
+
+	return DrawingRect{ box.X, box.Y, box.Width, box.Height };
+}
+
+void Win2DDrawingContext::push_layer(const DrawingRect& clip, float opacity) {
+	this->layers.push_back(this->ds->CreateLayer(opacity, Rect(clip.x, clip.y, clip.width, clip.height)));
+}
+
+void Win2DDrawingContext::pop_layer() {
+	if (!this->layers.empty()) {
+		CanvasActiveLayer^ layer = this->layers.back();
+
+		this->layers.pop_back();
+		delete layer; // it is the way to close the layer
+	}
+}
+
+void Win2DDrawingContext::set_transform(const DrawingMatrix& m) {
+	this->ds->Transform = float3x2(m.m11, m.m12, m.m21, m.m22, m.dx, m.dy);
+}
+
+DrawingMatrix Win2DDrawingContext::get_transform() {
+	float3x2 m = this->ds->Transform;
+
+	return DrawingMatrix{ m.m11, m.m12, m.m21, m.m22, m.m31, m.m32 };
+}
+
+CanvasCachedGeometry^ Win2DDrawingContext::cached_geometry(const DrawingPath& path, float thickness) {
+	auto key = std::make_pair(path.revision(), thickness);
+	auto maybe_geometry = this->geometries.find(key);
+	CanvasCachedGeometry^ geometry = nullptr;
+
+	if (maybe_geometry != this->geometries.end()) {
+		geometry = maybe_geometry->second;
+	} else {
+		CanvasGeometry^ g = win2d_geometry(this->ds, path);
+
+		if (this->geometries.size() >= geometry_cache_limit) {
+			// revisions only grow, the oldest ones are the least likely to be used again
+			this->geometries.erase(this->geometries.begin());
+		}
+
+		geometry = ((thickness > 0.0F) ? CanvasCachedGeometry::CreateStroke(g, thickness) : CanvasCachedGeometry::CreateFill(g));
+		this->geometries.insert(std::make_pair(key, geometry));
+	}
+
+	return geometry;
+}
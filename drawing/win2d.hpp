@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "drawing/context.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Graphlets keep their Win2D resources, these conversions let them render the same things into portable contexts.
+	 *
+	 * Solid brushes are converted exactly, gradient brushes are approximated with the average of their stops;
+	 * geometries are tessellated into persistent paths, so do it once rather than in every frame.
+	 */
+	WarGrey::SCADA::DrawingColor drawing_color(Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ brush);
+	WarGrey::SCADA::DrawingFont drawing_font(Microsoft::Graphics::Canvas::Text::CanvasTextFormat^ font);
+	std::shared_ptr<WarGrey::SCADA::DrawingPath> drawing_path(Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ g);
+
+	/** NOTE
+	 * The Win2D implementation of the drawing context,
+	 *  persistent paths are frozen into cached geometries keyed by their revisions,
+	 *  so that the same context can be attached to the drawing session of every frame without rebuilding them.
+	 */
+	private class Win2DDrawingContext : public WarGrey::SCADA::IDrawingContext {
+	public:
+		Win2DDrawingContext(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds = nullptr);
+
+	public:
+		void attach(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds);
+		void clear_geometry_cache();
+
+	public:
+		void clear(const WarGrey::SCADA::DrawingColor& color) override;
+		void fill_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color) override;
+		void stroke_path(const WarGrey::SCADA::DrawingPath& path, const WarGrey::SCADA::DrawingColor& color, float thickness) override;
+		void draw_image(const WarGrey::SCADA::DrawingImage& image, float x, float y, float width, float height, float opacity = 1.0F) override;
+
+	public:
+		void draw_text(const std::wstring& text, float x, float y,
+			const WarGrey::SCADA::DrawingFont& font, const WarGrey::SCADA::DrawingColor& color) override;
+
+		WarGrey::SCADA::DrawingRect measure_text(const std::wstring& text, const WarGrey::SCADA::DrawingFont& font) override;
+
+	public:
+		void push_layer(const WarGrey::SCADA::DrawingRect& clip, float opacity = 1.0F) override;
+		void pop_layer() override;
+
+	public:
+		void set_transform(const WarGrey::SCADA::DrawingMatrix& m) override;
+		WarGrey::SCADA::DrawingMatrix get_transform() override;
+
+	private:
+		Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^ cached_geometry(
+			const WarGrey::SCADA::DrawingPath& path, float thickness);
+
+	private:
+		Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds;
+		std::vector<Microsoft::Graphics::Canvas::CanvasActiveLayer^> layers;
+		std::map<std::pair<unsigned long long, float>, Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^> geometries;
+	};
+}
@@ -6,6 +6,13 @@ namespace WarGrey::SCADA {
     class IPlanetDecorator;
 
 	class ISprite;
+	class IDrawingContext;
+	class IMirrorChannel;
+	class MirrorEncoder;
+	class MirrorWorker;
+	struct MirrorStatistics;
+	class DisplayList;
+	class FrameProfiler;
     class IGraphlet;
 	class IKeyboard;
 
@@ -16,6 +16,9 @@ Shapelet::Shapelet(CanvasGeometry^ shape, ICanvasBrush^ color, CanvasSolidColorB
 	, float thickness, CanvasStrokeStyle^ style) : color(color), border_color(bcolor) {
 	this->surface = geometry_freeze(shape);
 	this->border = geometry_draft(shape, thickness, style);
+	this->shape = shape;
+	this->style = style;
+	this->thickness = thickness;
 
 	this->box = shape->ComputeBounds();
 	this->border_box = shape->ComputeStrokeBounds(thickness);
@@ -82,6 +85,28 @@ void Shapelet::draw(CanvasDrawingSession^ ds, float x, float y, float Width, flo
 	}
 }
 
+void Shapelet::render(IDrawingContext* dc, float x, float y, float Width, float Height) {
+	float ox, oy;
+
+	this->fill_shape_origin(&ox, &oy);
+
+	if (this->surface_path == nullptr) { // NOTE: tessellating is not cheap, and not all shapes are rendered portably
+		this->surface_path = drawing_path(this->shape);
+		this->border_path = drawing_path((this->style == nullptr)
+			? this->shape->Stroke(this->thickness)
+			: this->shape->Stroke(this->thickness, this->style));
+	}
+
+	dc->push_transform(drawing_translation(x - ox, y - oy));
+	dc->fill_path(*this->surface_path, drawing_color(this->color));
+
+	if (this->border_color != nullptr) {
+		dc->fill_path(*this->border_path, drawing_color(this->border_color));
+	}
+
+	dc->pop_transform();
+}
+
 /*************************************************************************************************/
 Shiplet::Shiplet(float length, float radius, unsigned int border_color, float thickness)
 	: Shiplet(length, radius, nullptr, Colours::make(border_color), thickness) {}
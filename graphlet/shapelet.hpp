@@ -9,6 +9,8 @@
 #include "brushes.hxx"
 #include "geometry.hpp"
 
+#include "drawing/win2d.hpp"
+
 namespace WarGrey::SCADA {
 	private class Shapelet : public virtual WarGrey::SCADA::IGraphlet {
 	public:
@@ -22,6 +24,7 @@ namespace WarGrey::SCADA {
 		void construct() override;
 		void fill_extent(float x, float y, float* w = nullptr, float* h = nullptr) override;
 		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float Width, float Height) override;
+		void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) override;
 
 	public:
 		void set_color(unsigned int color);
@@ -40,6 +43,13 @@ namespace WarGrey::SCADA {
 		Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ border_color;
 		Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ color;
 
+	private:
+		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ shape;
+		Microsoft::Graphics::Canvas::Geometry::CanvasStrokeStyle^ style;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> surface_path;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> border_path;
+		float thickness;
+
 	private:
 		Windows::Foundation::Rect border_box;
 		Windows::Foundation::Rect box;
@@ -218,6 +228,22 @@ namespace WarGrey::SCADA {
 			}
 		}
 
+		void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) override {
+			auto subpath = this->subpaths.begin();
+			auto subcolor = this->subcolors.begin();
+
+			WarGrey::SCADA::Shapelet::render(dc, x, y, Width, Height);
+
+			dc->push_transform(WarGrey::SCADA::drawing_translation(x, y));
+			while (subpath != this->subpaths.end()) {
+				dc->fill_path(*(*subpath), WarGrey::SCADA::drawing_color(*subcolor));
+
+				subpath++;
+				subcolor++;
+			}
+			dc->pop_transform();
+		}
+
 	public:
 		void fill_stepsize(float* xstep, float* ystep) {
 			this->turtle->fill_stepsize(xstep, ystep);
@@ -258,6 +284,7 @@ namespace WarGrey::SCADA {
 
 		void clear_subtacks() {
 			this->subtracks.clear();
+			this->subpaths.clear();
 			this->subcolors.clear();
 		}
 
@@ -294,9 +321,12 @@ namespace WarGrey::SCADA {
 		void push_subtrack(Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ track
 			, Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ color) {
 			float shape_x, shape_y;
+			Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ subtrack;
 
 			this->fill_shape_origin(&shape_x, &shape_y);
-			this->subtracks.push_back(geometry_freeze(geometry_translate(track, -shape_x, -shape_y)));
+			subtrack = geometry_translate(track, -shape_x, -shape_y);
+			this->subtracks.push_back(geometry_freeze(subtrack));
+			this->subpaths.push_back(WarGrey::SCADA::drawing_path(subtrack));
 			this->subcolors.push_back(color);
 		}
 
@@ -307,6 +337,7 @@ namespace WarGrey::SCADA {
 
 	private:
 		std::list<Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^> subtracks;
+		std::list<std::shared_ptr<WarGrey::SCADA::DrawingPath>> subpaths;
 		std::list<Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^> subcolors;
 	};
 }
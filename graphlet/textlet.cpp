@@ -8,6 +8,8 @@
 
 #include "paint.hpp"
 
+#include "drawing/win2d.hpp"
+
 using namespace WarGrey::SCADA;
 
 using namespace Windows::Foundation;
@@ -228,6 +230,23 @@ void ITextlet::draw(CanvasDrawingSession^ ds, float x, float y, float Width, flo
 	}
 }
 
+void ITextlet::render(IDrawingContext* dc, float x, float y, float Width, float Height) {
+	if (this->text_layout != nullptr) {
+		if (this->text_color == nullptr) {
+			this->set_color();
+		}
+
+		this->render_text(dc, x, y, this->text_color);
+	}
+}
+
+void ITextlet::render_text(IDrawingContext* dc, float x, float y, ICanvasBrush^ color) {
+	// NOTE: portable texts have no per-character styles, subscripts are rendered as the normal text
+	if (this->raw != nullptr) {
+		dc->draw_text(this->raw->Data(), x, y, drawing_font(this->text_font), drawing_color(color));
+	}
+}
+
 /*************************************************************************************************/
 Labellet::Labellet(const wchar_t *fmt, ...) {
 	VSWPRINT(label, fmt);
@@ -583,6 +602,84 @@ void IEditorlet::draw(CanvasDrawingSession^ ds, float x, float y, float Width, f
 	}
 }
 
+void IEditorlet::render(IDrawingContext* dc, float x, float y, float Width, float Height) {
+	DimensionStyle style = this->get_style();
+	Platform::String^ ntext = this->number;
+	TextExtent nbox = this->number_box;
+	TextExtent label_box;
+	float tspace, bspace, height, base_y;
+	float number_region_x = 0.0F;
+	float number_x = -nbox.width;
+
+	fill_vmetrics(this->text_layout, this->number09_box, this->unit_box, &label_box, &tspace, &bspace, &height);
+	base_y = y + height;
+
+	if (this->text_layout != nullptr) {
+		float region_width = std::fmaxf(label_box.width, style.minimize_label_width);
+		float label_x = x + (region_width - label_box.width) * style.label_xfraction;
+
+		if (style.label_background_color != nullptr) {
+			dc->fill_rectangle(x, y, region_width, height, drawing_color(style.label_background_color));
+		}
+
+		this->render_text(dc, label_x, base_y - label_box.height, style.label_color);
+
+		if (style.label_border_color != nullptr) {
+			dc->stroke_rectangle(x + 0.5F, y + 0.5F, region_width - 1.0F, height - 1.0F, drawing_color(style.label_border_color));
+		}
+
+		x += (region_width + style.number_leading_space);
+		number_region_x = x;
+	}
+
+	if (this->has_caret()) {
+		nbox = this->caret_box;
+		ntext = this->input_number;
+	}
+
+	{ // render number
+		float region_width = std::fmaxf(nbox.width, style.minimize_number_width);
+		float padding_x = ((style.number_border_color != nullptr) ? 1.0F : 0.0F);
+
+		if (style.number_background_color != nullptr) {
+			dc->fill_rectangle(x, y, region_width, height, drawing_color(style.number_background_color));
+		}
+
+		if (ntext != nullptr) {
+			number_x = x + (region_width - nbox.width) * style.number_xfraction + padding_x;
+			dc->draw_text(ntext->Data(), number_x, base_y - this->number_box.height,
+				drawing_font(style.number_font), drawing_color(style.number_color));
+		}
+
+		if (style.number_border_color != nullptr) {
+			dc->stroke_rectangle(x + 0.5F, y + 0.5F, region_width - 1.0F, height - 1.0F, drawing_color(style.number_border_color));
+		}
+
+		x += region_width;
+	}
+
+	if (this->unit_layout != nullptr) {
+		x += style.number_trailing_space;
+
+		if (style.unit_background_color != nullptr) {
+			dc->fill_rectangle(x, y, unit_box.width, height, drawing_color(style.unit_background_color));
+		}
+
+		dc->draw_text(this->unit->Data(), x, base_y - unit_box.height, drawing_font(style.unit_font), drawing_color(style.unit_color));
+
+		if (style.unit_border_color != nullptr) {
+			dc->stroke_rectangle(x + 0.5F, y + 0.5F, unit_box.width - 1.0F, height - 1.0F, drawing_color(style.unit_border_color));
+		}
+	}
+
+	if (this->flashing) {
+		float padding_x = 3.0F;
+		float caret_x = std::fmaxf(number_region_x + padding_x, number_x + nbox.width);
+
+		dc->draw_line(caret_x, y + padding_x, caret_x, y + height - padding_x, drawing_color(style.caret_color));
+	}
+}
+
 /*************************************************************************************************/
 Dimensionlet::Dimensionlet(DimensionState default_state, DimensionStyle& default_style, Platform::String^ unit
 	, Platform::String^ label, Platform::String^ subscript)
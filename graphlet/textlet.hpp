@@ -78,10 +78,14 @@ namespace WarGrey::SCADA {
 		void fill_extent(float x, float y, float* w = nullptr, float* h = nullptr) override;
 		void fill_margin(float x, float y, float* t = nullptr, float* r = nullptr, float* b = nullptr, float* l = nullptr) override;
 		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float Width, float Height) override;
+		void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) override;
 
 	protected:
 		virtual void on_font_changed() {}
 
+	protected:
+		void render_text(WarGrey::SCADA::IDrawingContext* dc, float x, float y, Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ color);
+
 	protected:
 		void set_layout_font_size(int char_idx, int char_count);
 		void set_layout_font_size(int char_idx, int char_count, float size);
@@ -145,6 +149,7 @@ namespace WarGrey::SCADA {
 		void fill_extent(float x, float y, float* w = nullptr, float* h = nullptr) override;
 		void fill_margin(float x, float y, float* t = nullptr, float* r = nullptr, float* b = nullptr, float* l = nullptr) override;
 		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float Width, float Height) override;
+		void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) override;
 
 	public:
 		bool on_key(Windows::System::VirtualKey key, bool wargrey_keyboard) override;
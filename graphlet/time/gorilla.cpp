@@ -0,0 +1,275 @@
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "graphlet/time/gorilla.hpp"
+
+using namespace WarGrey::SCADA;
+
+static inline unsigned int leading_zeros(unsigned long long x) { // `x` should not be 0
+#ifdef _MSC_VER
+	unsigned long idx;
+
+	_BitScanReverse64(&idx, x);
+
+	return 63U - (unsigned int)(idx);
+#else
+	return (unsigned int)(__builtin_clzll(x));
+#endif
+}
+
+static inline unsigned int trailing_zeros(unsigned long long x) { // `x` should not be 0
+#ifdef _MSC_VER
+	unsigned long idx;
+
+	_BitScanForward64(&idx, x);
+
+	return (unsigned int)(idx);
+#else
+	return (unsigned int)(__builtin_ctzll(x));
+#endif
+}
+
+static inline long long sign_extend(unsigned long long bits, unsigned int n) {
+	return (long long)(bits << (64U - n)) >> (64U - n);
+}
+
+static inline unsigned long long double_bits(double value) {
+	unsigned long long bits;
+
+	std::memcpy(&bits, &value, sizeof(double));
+
+	return bits;
+}
+
+static inline double bits_double(unsigned long long bits) {
+	double value;
+
+	std::memcpy(&value, &bits, sizeof(double));
+
+	return value;
+}
+
+/*************************************************************************************************/
+BitStream::BitStream() : count(0U) {}
+
+void BitStream::write(unsigned long long bits, unsigned int n) {
+	if (n > 0U) {
+		unsigned int offset = (unsigned int)(this->count % 64U);
+		unsigned int room = 64U - offset;
+
+		if (n < 64U) {
+			bits &= ((1ULL << n) - 1ULL);
+		}
+
+		if (offset == 0U) {
+			this->words.push_back(0ULL);
+		}
+
+		if (n <= room) {
+			this->words.back() |= (bits << (room - n));
+		} else {
+			this->words.back() |= (bits >> (n - room));
+			this->words.push_back(bits << (64U - (n - room)));
+		}
+
+		this->count += n;
+	}
+}
+
+void BitStream::clear() {
+	this->words.clear();
+	this->count = 0U;
+}
+
+void BitStream::shrink_to_fit() {
+	this->words.shrink_to_fit();
+}
+
+size_t BitStream::bit_count() const {
+	return this->count;
+}
+
+size_t BitStream::word_count() const {
+	return this->words.size();
+}
+
+size_t BitStream::memory_usage() const {
+	return this->words.capacity() * sizeof(unsigned long long);
+}
+
+unsigned long long BitStream::word_ref(size_t idx) const {
+	return this->words[idx];
+}
+
+const unsigned long long* BitStream::data() const {
+	return this->words.data();
+}
+
+/*************************************************************************************************/
+BitReader::BitReader(const BitStream* src) : words(src->data()), position(0U) {}
+BitReader::BitReader(const unsigned long long* words) : words(words), position(0U) {}
+
+unsigned long long BitReader::read(unsigned int n) {
+	unsigned long long bits = 0ULL;
+
+	if (n > 0U) {
+		size_t idx = this->position / 64U;
+		unsigned int offset = (unsigned int)(this->position % 64U);
+		unsigned int room = 64U - offset;
+		unsigned long long word = this->words[idx] << offset;
+
+		if (n <= room) {
+			bits = word >> (64U - n);
+		} else {
+			unsigned int rest = n - room;
+
+			bits = ((word >> offset) << rest) | (this->words[idx + 1U] >> (64U - rest));
+		}
+
+		this->position += n;
+	}
+
+	return bits;
+}
+
+bool BitReader::read_bit() {
+	return (this->read(1U) == 1ULL);
+}
+
+/*************************************************************************************************/
+TimepointEncoder::TimepointEncoder(BitStream* dest) : dest(dest), last(0LL), delta(0LL), count(0ULL) {}
+
+void TimepointEncoder::push(long long timepoint) {
+	if (this->count == 0ULL) {
+		this->dest->write((unsigned long long)(timepoint), 64U);
+	} else {
+		long long delta = timepoint - this->last;
+		long long dod = delta - this->delta;
+
+		if (dod == 0LL) {
+			this->dest->write(0b0ULL, 1U);
+		} else if ((dod >= -64LL) && (dod < 64LL)) {
+			this->dest->write(0b10ULL, 2U);
+			this->dest->write((unsigned long long)(dod), 7U);
+		} else if ((dod >= -256LL) && (dod < 256LL)) {
+			this->dest->write(0b110ULL, 3U);
+			this->dest->write((unsigned long long)(dod), 9U);
+		} else if ((dod >= -2048LL) && (dod < 2048LL)) {
+			this->dest->write(0b1110ULL, 4U);
+			this->dest->write((unsigned long long)(dod), 12U);
+		} else {
+			this->dest->write(0b1111ULL, 4U);
+			this->dest->write((unsigned long long)(dod), 64U);
+		}
+
+		this->delta = delta;
+	}
+
+	this->last = timepoint;
+	this->count += 1ULL;
+}
+
+TimepointDecoder::TimepointDecoder(const BitStream* src) : src(src), last(0LL), delta(0LL), count(0ULL) {}
+TimepointDecoder::TimepointDecoder(const unsigned long long* words) : src(words), last(0LL), delta(0LL), count(0ULL) {}
+
+long long TimepointDecoder::next() {
+	if (this->count == 0ULL) {
+		this->last = (long long)(this->src.read(64U));
+	} else {
+		long long dod = 0LL;
+
+		if (this->src.read_bit()) {
+			if (!this->src.read_bit()) {
+				dod = sign_extend(this->src.read(7U), 7U);
+			} else if (!this->src.read_bit()) {
+				dod = sign_extend(this->src.read(9U), 9U);
+			} else if (!this->src.read_bit()) {
+				dod = sign_extend(this->src.read(12U), 12U);
+			} else {
+				dod = (long long)(this->src.read(64U));
+			}
+		}
+
+		this->delta += dod;
+		this->last += this->delta;
+	}
+
+	this->count += 1ULL;
+
+	return this->last;
+}
+
+/*************************************************************************************************/
+ValueEncoder::ValueEncoder(BitStream* dest) : dest(dest), last(0ULL), leading(0U), trailing(0U), count(0ULL) {}
+
+void ValueEncoder::push(double value) {
+	unsigned long long bits = double_bits(value);
+
+	if (this->count == 0ULL) {
+		this->dest->write(bits, 64U);
+	} else {
+		unsigned long long xored = bits ^ this->last;
+
+		if (xored == 0ULL) {
+			this->dest->write(0b0ULL, 1U);
+		} else {
+			unsigned int leading = leading_zeros(xored);
+			unsigned int trailing = trailing_zeros(xored);
+
+			if (leading > 31U) { // so that it fits in 5 bits
+				leading = 31U;
+			}
+
+			if ((this->leading + this->trailing > 0U)
+				&& (leading >= this->leading) && (trailing >= this->trailing)) {
+				// the meaningful bits fall into the window of the previous one
+				this->dest->write(0b10ULL, 2U);
+				this->dest->write(xored >> this->trailing, 64U - this->leading - this->trailing);
+			} else {
+				unsigned int significant = 64U - leading - trailing;
+
+				this->dest->write(0b11ULL, 2U);
+				this->dest->write(leading, 5U);
+				this->dest->write(significant & 63U, 6U); // 64 is written as 0
+				this->dest->write(xored >> trailing, significant);
+
+				this->leading = leading;
+				this->trailing = trailing;
+			}
+		}
+	}
+
+	this->last = bits;
+	this->count += 1ULL;
+}
+
+ValueDecoder::ValueDecoder(const BitStream* src) : src(src), last(0ULL), leading(0U), trailing(0U), count(0ULL) {}
+ValueDecoder::ValueDecoder(const unsigned long long* words) : src(words), last(0ULL), leading(0U), trailing(0U), count(0ULL) {}
+
+double ValueDecoder::next() {
+	if (this->count == 0ULL) {
+		this->last = this->src.read(64U);
+	} else if (this->src.read_bit()) {
+		if (this->src.read_bit()) {
+			unsigned int significant = (unsigned int)(this->src.read(5U + 6U));
+
+			this->leading = significant >> 6U;
+			significant &= 63U;
+
+			if (significant == 0U) {
+				significant = 64U;
+			}
+
+			this->trailing = 64U - this->leading - significant;
+		}
+
+		this->last ^= (this->src.read(64U - this->leading - this->trailing) << this->trailing);
+	}
+
+	this->count += 1ULL;
+
+	return bits_double(this->last);
+}
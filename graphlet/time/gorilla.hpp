@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Gorilla-style compression for time series, see "Gorilla: A Fast, Scalable, In-Memory Time Series Database":
+	 *   timepoints are stored as delta-of-deltas, so that regularly sampled ones cost 1 bit each;
+	 *   values are XORed with their predecessors, so that slowly changing ones cost a few bits each.
+	 *
+	 * Streams are decoded forward only and do not know their lengths,
+	 *  clients should keep blocks small enough to be decoded as a whole, and remember how many items they hold.
+	 */
+	class BitStream {
+	public:
+		BitStream();
+
+	public:
+		void write(unsigned long long bits, unsigned int n); // the lower `n` bits, the most significant one first
+		void clear();
+		void shrink_to_fit();
+
+	public:
+		size_t bit_count() const;
+		size_t word_count() const;
+		size_t memory_usage() const; // in bytes
+		unsigned long long word_ref(size_t idx) const;
+		const unsigned long long* data() const;
+
+	private:
+		std::vector<unsigned long long> words;
+		size_t count;
+	};
+
+	class BitReader {
+	public:
+		BitReader(const WarGrey::SCADA::BitStream* src);
+		BitReader(const unsigned long long* words); // say, words of a stream that are mapped from a file
+
+	public:
+		unsigned long long read(unsigned int n);
+		bool read_bit();
+
+	private:
+		const unsigned long long* words;
+		size_t position;
+	};
+
+	/*********************************************************************************************/
+	class TimepointEncoder {
+	public:
+		TimepointEncoder(WarGrey::SCADA::BitStream* dest);
+
+	public:
+		void push(long long timepoint);
+
+	private:
+		WarGrey::SCADA::BitStream* dest;
+		long long last;
+		long long delta;
+		unsigned long long count;
+	};
+
+	class TimepointDecoder {
+	public:
+		TimepointDecoder(const WarGrey::SCADA::BitStream* src);
+		TimepointDecoder(const unsigned long long* words);
+
+	public:
+		long long next();
+
+	private:
+		WarGrey::SCADA::BitReader src;
+		long long last;
+		long long delta;
+		unsigned long long count;
+	};
+
+	class ValueEncoder {
+	public:
+		ValueEncoder(WarGrey::SCADA::BitStream* dest);
+
+	public:
+		void push(double value);
+
+	private:
+		WarGrey::SCADA::BitStream* dest;
+		unsigned long long last;
+		unsigned int leading;
+		unsigned int trailing;
+		unsigned long long count;
+	};
+
+	class ValueDecoder {
+	public:
+		ValueDecoder(const WarGrey::SCADA::BitStream* src);
+		ValueDecoder(const unsigned long long* words);
+
+	public:
+		double next();
+
+	private:
+		WarGrey::SCADA::BitReader src;
+		unsigned long long last;
+		unsigned int leading;
+		unsigned int trailing;
+		unsigned long long count;
+	};
+}
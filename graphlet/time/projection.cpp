@@ -0,0 +1,298 @@
+#include <cmath>
+#include <limits>
+
+#include "graphlet/time/projection.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PROJECTION_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace WarGrey::SCADA;
+
+/** NOTE
+ * Neither SSE2 nor AVX2 converts int64 to double,
+ *  integers in (-2^51, 2^51) are added to the bits of 1.5 * 2^52, whose double has exactly the integer as the fraction.
+ */
+static const long long INT64_DOUBLE_MAGIC_BITS = 0x4338000000000000LL;
+static const double INT64_DOUBLE_MAGIC = 6755399441055744.0;
+
+static WarGrey::SCADA::ProjectionISA detect_isa() {
+	ProjectionISA isa = ProjectionISA::Scalar;
+
+#ifdef PROJECTION_X86
+	isa = ProjectionISA::SSE2;
+
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuid(info, 0);
+
+	if (info[0] >= 7) {
+		int features[4];
+
+		__cpuid(info, 1);
+		__cpuidex(features, 7, 0);
+
+		// NOTE: OSXSAVE and AVX in ECX of leaf 1, AVX2 in EBX of leaf 7, and the OS should save YMM registers
+		if (((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) && ((features[1] & (1 << 5)) != 0)) {
+			if ((_xgetbv(0) & 0x6) == 0x6) {
+				isa = ProjectionISA::AVX2;
+			}
+		}
+	}
+#else
+	if (__builtin_cpu_supports("avx2")) {
+		isa = ProjectionISA::AVX2;
+	}
+#endif
+#endif
+
+	return isa;
+}
+
+static ProjectionISA supported_isa = detect_isa();
+static ProjectionISA active_isa = supported_isa;
+
+static inline void scan_point(ProjectionScan* scan, float x, float y, size_t idx, unsigned int* kept, size_t* count) {
+	if (!std::isnan(y)) {
+		float diff = std::fabs(x - scan->selected_x);
+
+		if (diff < scan->minimum_diff) {
+			scan->minimum_diff = diff;
+			scan->selected = (long long)(idx);
+		}
+
+		if (std::isnan(scan->last_x) || (x > scan->right)) {
+			scan->last_x = x;
+			scan->last_y = y;
+			scan->first_x = x;
+			kept[(*count)++] = (unsigned int)(idx);
+		} else {
+			if (((scan->last_x - x) > scan->tolerance) || (std::fabs(y - scan->last_y) > scan->tolerance)
+				|| (scan->first_x == scan->last_x)) {
+				scan->last_x = x;
+				scan->last_y = y;
+				kept[(*count)++] = (unsigned int)(idx);
+			}
+
+			if (x < scan->left) {
+				scan->stopped = true;
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+static void scalar_project_timepoints(const long long* src, size_t n, long long origin, double offset, double scale, float* dest) {
+	for (size_t idx = 0; idx < n; idx++) {
+		dest[idx] = float(offset + double(src[idx] - origin) * scale);
+	}
+}
+
+static void scalar_project_values(const double* src, size_t n, double offset, double scale, float* dest) {
+	for (size_t idx = 0; idx < n; idx++) {
+		dest[idx] = float(offset + src[idx] * scale);
+	}
+}
+
+#ifdef PROJECTION_X86
+static void sse2_project_timepoints(const long long* src, size_t n, long long origin, double offset, double scale, float* dest) {
+	__m128i bias = _mm_set1_epi64x(INT64_DOUBLE_MAGIC_BITS - origin);
+	__m128d magic = _mm_set1_pd(INT64_DOUBLE_MAGIC);
+	__m128d voffset = _mm_set1_pd(offset);
+	__m128d vscale = _mm_set1_pd(scale);
+	size_t idx = 0;
+
+	for (; idx + 2 <= n; idx += 2) {
+		__m128i t = _mm_add_epi64(_mm_loadu_si128((const __m128i*)(src + idx)), bias);
+		__m128d d = _mm_sub_pd(_mm_castsi128_pd(t), magic);
+
+		_mm_storel_pi((__m64*)(dest + idx), _mm_cvtpd_ps(_mm_add_pd(voffset, _mm_mul_pd(d, vscale))));
+	}
+
+	scalar_project_timepoints(src + idx, n - idx, origin, offset, scale, dest + idx);
+}
+
+static void sse2_project_values(const double* src, size_t n, double offset, double scale, float* dest) {
+	__m128d voffset = _mm_set1_pd(offset);
+	__m128d vscale = _mm_set1_pd(scale);
+	size_t idx = 0;
+
+	for (; idx + 4 <= n; idx += 4) {
+		__m128 lo = _mm_cvtpd_ps(_mm_add_pd(voffset, _mm_mul_pd(_mm_loadu_pd(src + idx), vscale)));
+		__m128 hi = _mm_cvtpd_ps(_mm_add_pd(voffset, _mm_mul_pd(_mm_loadu_pd(src + idx + 2), vscale)));
+
+		_mm_storeu_ps(dest + idx, _mm_movelh_ps(lo, hi));
+	}
+
+	scalar_project_values(src + idx, n - idx, offset, scale, dest + idx);
+}
+
+static bool sse2_skippable(const ProjectionScan* scan, const float* xs, const float* ys) {
+	// NOTE: comparisons are ordered, NaNs make the block unskippable
+	__m128 sign = _mm_set1_ps(-0.0F);
+	__m128 tolerance = _mm_set1_ps(scan->tolerance);
+	__m128 x = _mm_loadu_ps(xs);
+	__m128 y = _mm_loadu_ps(ys);
+	__m128 mask = _mm_cmple_ps(_mm_sub_ps(_mm_set1_ps(scan->last_x), x), tolerance);
+
+	mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(y, _mm_set1_ps(scan->last_y))), tolerance));
+	mask = _mm_and_ps(mask, _mm_cmpge_ps(x, _mm_set1_ps(scan->left)));
+	mask = _mm_and_ps(mask, _mm_cmple_ps(x, _mm_set1_ps(scan->right)));
+	mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_andnot_ps(sign, _mm_sub_ps(x, _mm_set1_ps(scan->selected_x))), _mm_set1_ps(scan->minimum_diff)));
+
+	return (_mm_movemask_ps(mask) == 0xF);
+}
+
+AVX2_TARGET static void avx2_project_timepoints(const long long* src, size_t n, long long origin, double offset, double scale, float* dest) {
+	__m256i bias = _mm256_set1_epi64x(INT64_DOUBLE_MAGIC_BITS - origin);
+	__m256d magic = _mm256_set1_pd(INT64_DOUBLE_MAGIC);
+	__m256d voffset = _mm256_set1_pd(offset);
+	__m256d vscale = _mm256_set1_pd(scale);
+	size_t idx = 0;
+
+	for (; idx + 4 <= n; idx += 4) {
+		__m256i t = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(src + idx)), bias);
+		__m256d d = _mm256_sub_pd(_mm256_castsi256_pd(t), magic);
+
+		_mm_storeu_ps(dest + idx, _mm256_cvtpd_ps(_mm256_add_pd(voffset, _mm256_mul_pd(d, vscale))));
+	}
+
+	scalar_project_timepoints(src + idx, n - idx, origin, offset, scale, dest + idx);
+}
+
+AVX2_TARGET static void avx2_project_values(const double* src, size_t n, double offset, double scale, float* dest) {
+	__m256d voffset = _mm256_set1_pd(offset);
+	__m256d vscale = _mm256_set1_pd(scale);
+	size_t idx = 0;
+
+	for (; idx + 4 <= n; idx += 4) {
+		_mm_storeu_ps(dest + idx, _mm256_cvtpd_ps(_mm256_add_pd(voffset, _mm256_mul_pd(_mm256_loadu_pd(src + idx), vscale))));
+	}
+
+	scalar_project_values(src + idx, n - idx, offset, scale, dest + idx);
+}
+
+AVX2_TARGET static bool avx2_skippable(const ProjectionScan* scan, const float* xs, const float* ys) {
+	__m256 sign = _mm256_set1_ps(-0.0F);
+	__m256 tolerance = _mm256_set1_ps(scan->tolerance);
+	__m256 x = _mm256_loadu_ps(xs);
+	__m256 y = _mm256_loadu_ps(ys);
+	__m256 mask = _mm256_cmp_ps(_mm256_sub_ps(_mm256_set1_ps(scan->last_x), x), tolerance, _CMP_LE_OQ);
+
+	mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(y, _mm256_set1_ps(scan->last_y))), tolerance, _CMP_LE_OQ));
+	mask = _mm256_and_ps(mask, _mm256_cmp_ps(x, _mm256_set1_ps(scan->left), _CMP_GE_OQ));
+	mask = _mm256_and_ps(mask, _mm256_cmp_ps(x, _mm256_set1_ps(scan->right), _CMP_LE_OQ));
+	mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(x, _mm256_set1_ps(scan->selected_x))),
+		_mm256_set1_ps(scan->minimum_diff), _CMP_GE_OQ));
+
+	return (_mm256_movemask_ps(mask) == 0xFF);
+}
+#endif
+
+/*************************************************************************************************/
+void WarGrey::SCADA::projection_scan_begin(ProjectionScan* scan, float left, float right, float tolerance, float selected_x, float minimum_diff) {
+	scan->left = left;
+	scan->right = right;
+	scan->tolerance = tolerance;
+	scan->minimum_diff = minimum_diff;
+
+	// NOTE: nothing is nearer to the negative infinity than `minimum_diff`
+	scan->selected_x = (std::isnan(selected_x) ? -std::numeric_limits<float>::infinity() : selected_x);
+
+	scan->last_x = std::nanf("no datum");
+	scan->last_y = std::nanf("no datum");
+	scan->first_x = std::nanf("no datum");
+	scan->selected = -1;
+	scan->stopped = false;
+}
+
+void WarGrey::SCADA::project_timepoints(const long long* src, size_t n, long long origin, double offset, double scale, float* dest) {
+	switch (active_isa) {
+#ifdef PROJECTION_X86
+	case ProjectionISA::AVX2: avx2_project_timepoints(src, n, origin, offset, scale, dest); break;
+	case ProjectionISA::SSE2: sse2_project_timepoints(src, n, origin, offset, scale, dest); break;
+#endif
+	default: scalar_project_timepoints(src, n, origin, offset, scale, dest);
+	}
+}
+
+void WarGrey::SCADA::project_values(const double* src, size_t n, double offset, double scale, float* dest) {
+	switch (active_isa) {
+#ifdef PROJECTION_X86
+	case ProjectionISA::AVX2: avx2_project_values(src, n, offset, scale, dest); break;
+	case ProjectionISA::SSE2: sse2_project_values(src, n, offset, scale, dest); break;
+#endif
+	default: scalar_project_values(src, n, offset, scale, dest);
+	}
+}
+
+size_t WarGrey::SCADA::projection_scan(ProjectionScan* scan, const float* xs, const float* ys, size_t n, unsigned int* kept) {
+	/** NOTE
+	 * Once the line gets its second point, most points of a dense series are in tolerance and far from `selected_x`,
+	 *  such blocks are skipped as a whole, and the others are scanned point by point.
+	 */
+	size_t width = ((active_isa == ProjectionISA::AVX2) ? 8U : ((active_isa == ProjectionISA::SSE2) ? 4U : 1U));
+	size_t count = 0U;
+	size_t idx = n;
+
+	scan->selected = -1;
+
+	while ((idx > 0U) && (!scan->stopped)) {
+		bool skippable = false;
+		size_t block = 1U;
+
+		if ((width > 1U) && (idx >= width) && (!std::isnan(scan->last_x)) && (scan->first_x != scan->last_x)) {
+			block = width;
+
+#ifdef PROJECTION_X86
+			if (active_isa == ProjectionISA::AVX2) {
+				skippable = avx2_skippable(scan, xs + idx - width, ys + idx - width);
+			} else {
+				skippable = sse2_skippable(scan, xs + idx - width, ys + idx - width);
+			}
+#endif
+		}
+
+		if (skippable) {
+			idx -= block;
+		} else {
+			for (size_t end = idx - block; (idx > end) && (!scan->stopped); idx--) {
+				scan_point(scan, xs[idx - 1], ys[idx - 1], idx - 1, kept, &count);
+			}
+		}
+	}
+
+	return count;
+}
+
+/*************************************************************************************************/
+ProjectionISA WarGrey::SCADA::projection_isa() {
+	return active_isa;
+}
+
+ProjectionISA WarGrey::SCADA::projection_use_isa(ProjectionISA isa) {
+	active_isa = ((isa > supported_isa) ? supported_isa : isa);
+
+	return active_isa;
+}
+
+const wchar_t* WarGrey::SCADA::projection_isa_name(ProjectionISA isa) {
+	const wchar_t* name = L"Unknown";
+
+	switch (isa) {
+	case ProjectionISA::Scalar: name = L"Scalar"; break;
+	case ProjectionISA::SSE2: name = L"SSE2"; break;
+	case ProjectionISA::AVX2: name = L"AVX2"; break;
+	}
+
+	return name;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+namespace WarGrey::SCADA {
+	enum class ProjectionISA { Scalar, SSE2, AVX2 };
+
+	/** NOTE
+	 * Points are scanned backward, from the latest one to the earliest one, since lines are drawn from the right boundary.
+	 *
+	 * A point is kept if it is the first point of the line, or it is on the right of `right` (which restarts the line),
+	 *  or it is `tolerance` away from the last kept point, or the last kept point is the first point of the line.
+	 * The scan stops at the first point on the left of `left` that is not the first point of the line,
+	 *  NaNs are neither kept nor selected.
+	 */
+	struct ProjectionScan {
+		float left;
+		float right;
+		float tolerance;
+		float selected_x;
+
+		float last_x;
+		float last_y;
+		float first_x;
+		float minimum_diff;
+		long long selected; // index of the point nearest to `selected_x` in the last scanned span, or -1
+		bool stopped;
+	};
+
+	void projection_scan_begin(WarGrey::SCADA::ProjectionScan* scan, float left, float right, float tolerance,
+		float selected_x, float minimum_diff);
+
+	// dest[i] = offset + (src[i] - origin) * scale, `src[i] - origin` is supposed to be in (-2^51, 2^51)
+	void project_timepoints(const long long* src, size_t n, long long origin, double offset, double scale, float* dest);
+
+	// dest[i] = offset + src[i] * scale
+	void project_values(const double* src, size_t n, double offset, double scale, float* dest);
+
+	// returns the number of kept points whose indices are stored in `kept` in the order of scanning
+	size_t projection_scan(WarGrey::SCADA::ProjectionScan* scan, const float* xs, const float* ys, size_t n, unsigned int* kept);
+
+	WarGrey::SCADA::ProjectionISA projection_isa();
+	WarGrey::SCADA::ProjectionISA projection_use_isa(WarGrey::SCADA::ProjectionISA isa); // for benchmarks, returns the one in use
+	const wchar_t* projection_isa_name(WarGrey::SCADA::ProjectionISA isa);
+}
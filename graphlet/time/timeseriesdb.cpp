@@ -0,0 +1,697 @@
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+#include "graphlet/time/timeseriesdb.hpp"
+#include "graphlet/time/gorilla.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Windows::Storage;
+
+static const unsigned int TSDB_MAGIC = 0x315A5354U; // "TSZ1"
+static const unsigned int TSDB_CONCURRENCY = 4U;
+static const unsigned long long TSDB_BLOCK_ROWS = 1024ULL;
+static const long long TSDB_FLUSH_INTERVAL_MS = 1000LL;
+
+static const std::wstring raw_suffix = L".tsa";
+static const std::wstring sealed_suffix = L".tsz";
+static const std::wstring temporary_suffix = L".tmp";
+
+/** NOTE
+ * Raw segments are sequences of rows, a row is a timepoint followed by values of all lines.
+ *
+ * Sealed segments start with a header and the sparse index of blocks, then blocks follow,
+ *  a block starts with bit counts of its streams, then words of the timepoint stream and value streams follow.
+ * All fields are 8-byte aligned, so that words of streams could be read from the mapped view directly.
+ */
+struct tszheader {
+	unsigned int magic;
+	unsigned int count;
+	unsigned long long rows;
+	long long first_ms;
+	long long last_ms;
+	unsigned long long block_count;
+};
+
+struct tszindex {
+	long long first_ms;
+	long long last_ms;
+	unsigned long long offset; // in bytes, from the start of the file
+	unsigned long long rows;
+};
+
+private struct WarGrey::SCADA::tssegment {
+	long long first_ms;
+	long long last_ms;
+	unsigned long long bytes;
+	std::wstring path;
+	bool sealed;
+
+	// rows of raw segments, they stay in memory until the segment is sealed
+	std::vector<long long> timepoints;
+	std::vector<double> values;
+
+	// sealed segments are mapped when they are read for the first time
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+	const unsigned char* view = nullptr;
+};
+
+private struct WarGrey::SCADA::tsrequest {
+	ITimeSeriesDataReceiver* receiver;
+	long long open_s;
+	long long close_s;
+	bool cancelled;
+
+	// rows in the order of time descending
+	std::vector<long long> timepoints;
+	std::vector<double> values;
+};
+
+static inline bool ends_with(const std::wstring& name, const std::wstring& suffix) {
+	return ((name.size() > suffix.size()) && (name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0));
+}
+
+static inline unsigned long long word_count(unsigned long long bit_count) {
+	return (bit_count + 63ULL) / 64ULL;
+}
+
+static bool map_segment(tssegment* segment) {
+	if (segment->view == nullptr) {
+		segment->file = CreateFile2(segment->path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, OPEN_EXISTING, nullptr);
+
+		if (segment->file != INVALID_HANDLE_VALUE) {
+			segment->mapping = CreateFileMappingFromApp(segment->file, nullptr, PAGE_READONLY, 0ULL, nullptr);
+
+			if (segment->mapping != nullptr) {
+				segment->view = (const unsigned char*)(MapViewOfFileFromApp(segment->mapping, FILE_MAP_READ, 0ULL, 0U));
+			}
+		}
+	}
+
+	return (segment->view != nullptr);
+}
+
+static void unmap_segment(tssegment* segment) {
+	if (segment->view != nullptr) {
+		UnmapViewOfFile(segment->view);
+		segment->view = nullptr;
+	}
+
+	if (segment->mapping != nullptr) {
+		CloseHandle(segment->mapping);
+		segment->mapping = nullptr;
+	}
+
+	if (segment->file != INVALID_HANDLE_VALUE) {
+		CloseHandle(segment->file);
+		segment->file = INVALID_HANDLE_VALUE;
+	}
+}
+
+static std::wstring segment_path(const std::wstring& rootdir, long long first_ms, const std::wstring& suffix) {
+	return rootdir + L"\\" + std::to_wstring(first_ms) + suffix;
+}
+
+static void take_rows(tsrequest* request, const long long* timepoints, const double* values, unsigned long long n,
+	unsigned int count, long long close_ms, long long open_ms) {
+	// NOTE: rows are in the order of time, they are taken backward
+	for (unsigned long long idx = n; idx > 0ULL; idx--) {
+		long long timepoint = timepoints[idx - 1ULL];
+
+		if ((timepoint >= close_ms) && (timepoint < open_ms)) {
+			const double* row = values + (idx - 1ULL) * count;
+
+			request->timepoints.push_back(timepoint);
+			request->values.insert(request->values.end(), row, row + count);
+		}
+	}
+}
+
+/*************************************************************************************************/
+TimeSeriesDB::TimeSeriesDB(Platform::String^ dirname, unsigned int count, long long retention_s
+	, unsigned long long retention_bytes, long long segment_span_s, Syslog* logger)
+	: logger(logger), count(count), retention_ms(retention_s * 1000LL), retention_bytes(retention_bytes)
+	, segment_span_ms(segment_span_s * 1000LL), serving(nullptr), active(nullptr)
+	, last_timepoint(0LL), last_flush(0LL), recovered(false), terminated(false), pending(0U) {
+	this->rootdir = std::wstring(ApplicationData::Current->LocalFolder->Path->Data()) + L"\\" + dirname->Data();
+	CreateDirectoryW(this->rootdir.c_str(), nullptr); // it is okay if the directory exists
+
+	this->worker = std::thread([this]() { this->run(); });
+}
+
+TimeSeriesDB::~TimeSeriesDB() noexcept {
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		this->terminated = true;
+	}
+
+	this->wakeup.notify_all();
+	this->worker.join();
+	this->activestream.close();
+
+	// NOTE: raw segments that have not been sealed are sealed when they are recovered
+	for (auto it = this->segments.begin(); it != this->segments.end(); it++) {
+		unmap_segment(it->second);
+		delete it->second;
+	}
+
+	for (auto request : this->requests) {
+		delete request;
+	}
+
+	for (auto reply : this->replies) {
+		delete reply;
+	}
+}
+
+bool TimeSeriesDB::ready() {
+	return this->recovered;
+}
+
+bool TimeSeriesDB::loading() {
+	return (this->pending > 0U);
+}
+
+unsigned int TimeSeriesDB::concurrency() {
+	// NOTE: requests are served one by one, queueing them just saves the round-trips between frames
+	return TSDB_CONCURRENCY;
+}
+
+void TimeSeriesDB::load(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) {
+	tsrequest* request = new tsrequest();
+
+	request->receiver = receiver;
+	request->open_s = open_s;
+	request->close_s = close_s;
+	request->cancelled = false;
+
+	this->pending += 1U;
+
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		this->requests.push_back(request);
+	}
+
+	this->wakeup.notify_one();
+}
+
+void TimeSeriesDB::cancel_load(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto same_request = [=](tsrequest* r) { return ((r->receiver == receiver) && (r->open_s == open_s) && (r->close_s == close_s)); };
+	auto maybe_request = std::find_if(this->requests.begin(), this->requests.end(), same_request);
+	auto maybe_reply = std::find_if(this->replies.begin(), this->replies.end(), same_request);
+
+	if (maybe_request != this->requests.end()) {
+		delete (*maybe_request);
+		this->requests.erase(maybe_request);
+		this->pending -= 1U;
+	}
+
+	if (maybe_reply != this->replies.end()) {
+		delete (*maybe_reply);
+		this->replies.erase(maybe_reply);
+		this->pending -= 1U;
+	}
+
+	if ((this->serving != nullptr) && same_request(this->serving)) {
+		this->serving->cancelled = true;
+	}
+}
+
+void TimeSeriesDB::cancel(ITimeSeriesDataReceiver* receiver) {
+	std::unique_lock<std::mutex> lock(this->section);
+	auto of_receiver = [=](tsrequest* r) { return (r->receiver == receiver); };
+
+	for (auto queue : { &this->requests, &this->replies }) {
+		auto others = std::stable_partition(queue->begin(), queue->end(), [=](tsrequest* r) { return !of_receiver(r); });
+
+		for (auto it = others; it != queue->end(); it++) {
+			delete (*it);
+			this->pending -= 1U;
+		}
+
+		queue->erase(others, queue->end());
+	}
+
+	if ((this->serving != nullptr) && of_receiver(this->serving)) {
+		this->serving->cancelled = true;
+	}
+}
+
+void TimeSeriesDB::dispatch() {
+	std::deque<tsrequest*> replies;
+
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		replies.swap(this->replies);
+	}
+
+	for (auto reply : replies) {
+		ITimeSeriesDataReceiver* receiver = reply->receiver;
+
+		receiver->begin_maniplation_sequence();
+		for (size_t idx = 0; idx < reply->timepoints.size(); idx++) {
+			receiver->on_datum_values(reply->open_s, reply->timepoints[idx], reply->values.data() + idx * this->count, this->count);
+		}
+		receiver->end_maniplation_sequence();
+		receiver->on_maniplation_complete(reply->open_s, reply->close_s);
+
+		delete reply;
+		this->pending -= 1U;
+	}
+}
+
+void TimeSeriesDB::save(long long timepoint_ms, double* values, unsigned int n) {
+	if (this->recovered) {
+		if (!this->early_timepoints.empty()) {
+			// NOTE: `last_timepoint` is the one of recovered segments now, early rows that are not newer are dropped
+			for (size_t idx = 0; idx < this->early_timepoints.size(); idx++) {
+				this->append(this->early_timepoints[idx], this->early_values.data() + idx * this->count, this->count);
+			}
+
+			std::vector<long long>().swap(this->early_timepoints);
+			std::vector<double>().swap(this->early_values);
+		}
+
+		this->append(timepoint_ms, values, n);
+	} else if (this->early_timepoints.empty() || (timepoint_ms > this->early_timepoints.back())) {
+		// NOTE: the worker owns segments and `last_timepoint` until the recovery is done
+		this->early_timepoints.push_back(timepoint_ms);
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			this->early_values.push_back((idx < n) ? values[idx] : std::nan("no datum"));
+		}
+	}
+}
+
+void TimeSeriesDB::append(long long timepoint_ms, const double* values, unsigned int n) {
+	// NOTE: segments are append-only, rows that are not newer than the last one are dropped
+	if (timepoint_ms > this->last_timepoint) {
+		if ((this->active == nullptr) || (timepoint_ms >= this->active->first_ms + this->segment_span_ms)) {
+			this->rotate(timepoint_ms);
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(this->section);
+
+			this->active->timepoints.push_back(timepoint_ms);
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				this->active->values.push_back((idx < n) ? values[idx] : std::nan("no datum"));
+			}
+
+			this->active->last_ms = timepoint_ms;
+			this->active->bytes += sizeof(long long) + sizeof(double) * this->count;
+		}
+
+		if (this->activestream.is_open()) {
+			const double* row = this->active->values.data() + (this->active->timepoints.size() - 1U) * this->count;
+
+			this->activestream.write((const char*)(&timepoint_ms), sizeof(long long));
+			this->activestream.write((const char*)(row), sizeof(double) * this->count);
+
+			// NOTE: rows in the stream buffer are lost if the application crashes, but they are at most one second of rows
+			if (timepoint_ms - this->last_flush >= TSDB_FLUSH_INTERVAL_MS) {
+				this->activestream.flush();
+				this->last_flush = timepoint_ms;
+			}
+		}
+
+		this->last_timepoint = timepoint_ms;
+	}
+}
+
+void TimeSeriesDB::rotate(long long timepoint_ms) {
+	tssegment* segment = new tssegment();
+
+	segment->first_ms = timepoint_ms;
+	segment->last_ms = timepoint_ms;
+	segment->bytes = 0ULL;
+	segment->path = segment_path(this->rootdir, timepoint_ms, raw_suffix);
+	segment->sealed = false;
+
+	if (this->activestream.is_open()) {
+		this->activestream.close();
+	}
+
+	this->activestream.open(segment->path, std::ios::out | std::ios::app | std::ios::binary);
+	this->last_flush = timepoint_ms;
+
+	if (!this->activestream.is_open()) {
+		this->log_failure(L"failed to create segment", segment->path);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		if (this->active != nullptr) {
+			this->sealings.push_back(this->active);
+		}
+
+		this->segments.insert(std::pair<long long, tssegment*>(timepoint_ms, segment));
+		this->active = segment;
+	}
+
+	this->wakeup.notify_one();
+}
+
+/*************************************************************************************************/
+void TimeSeriesDB::run() {
+	bool running = true;
+
+	this->recover();
+	this->retain();
+	this->recovered = true;
+
+	while (running) {
+		tsrequest* request = nullptr;
+		tssegment* sealing = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(this->section);
+
+			this->wakeup.wait(lock, [this]() {
+				return (this->terminated || (!this->requests.empty()) || (!this->sealings.empty()));
+			});
+
+			if (this->terminated) {
+				running = false;
+			} else if (!this->requests.empty()) { // loads go first, someone is waiting for them
+				request = this->requests.front();
+				this->requests.pop_front();
+				this->serving = request;
+			} else {
+				sealing = this->sealings.front();
+				this->sealings.pop_front();
+			}
+		}
+
+		if (request != nullptr) {
+			this->serve(request);
+
+			{
+				std::unique_lock<std::mutex> lock(this->section);
+
+				if (request->cancelled) {
+					delete request;
+					this->pending -= 1U;
+				} else {
+					this->replies.push_back(request);
+				}
+
+				this->serving = nullptr;
+			}
+		} else if (sealing != nullptr) {
+			this->seal(sealing);
+			this->retain();
+		}
+	}
+}
+
+void TimeSeriesDB::serve(tsrequest* request) {
+	long long open_ms = request->open_s * 1000LL;
+	long long close_ms = request->close_s * 1000LL;
+	std::vector<tssegment*> sealeds;
+	std::vector<long long> timepoints;
+	std::vector<double> values;
+
+	{ // NOTE: rows of raw segments are taken here since the active one is growing, sealed ones are read later
+		std::unique_lock<std::mutex> lock(this->section);
+
+		for (auto it = this->segments.rbegin(); it != this->segments.rend(); it++) {
+			tssegment* segment = it->second;
+
+			if ((segment->first_ms < open_ms) && (segment->last_ms >= close_ms)) {
+				if (segment->sealed) {
+					sealeds.push_back(segment);
+				} else {
+					take_rows(request, segment->timepoints.data(), segment->values.data(), segment->timepoints.size(),
+						this->count, close_ms, open_ms);
+				}
+			}
+		}
+	}
+
+	// NOTE: segments are sealed from the oldest one, so sealed segments are older than raw ones
+	for (auto segment : sealeds) {
+		if (!request->cancelled) {
+			if (map_segment(segment)) {
+				const tszheader* header = (const tszheader*)(segment->view);
+				const tszindex* index = (const tszindex*)(segment->view + sizeof(tszheader));
+				const tszindex* end = index + header->block_count;
+				const tszindex* block = std::lower_bound(index, end, open_ms,
+					[](const tszindex& b, long long t) { return b.first_ms < t; });
+
+				// NOTE: blocks before `block` start before `open_ms`, they are decoded backward until one ends before `close_ms`
+				while ((block > index) && ((block - 1)->last_ms >= close_ms)) {
+					const unsigned long long* bit_counts = nullptr;
+					const unsigned long long* words = nullptr;
+					std::vector<ValueDecoder> vdecoders;
+
+					block -= 1;
+					bit_counts = (const unsigned long long*)(segment->view + block->offset);
+					words = bit_counts + (this->count + 1U);
+
+					TimepointDecoder tdecoder(words);
+					words += word_count(bit_counts[0]);
+					for (unsigned int idx = 0; idx < this->count; idx++) {
+						vdecoders.push_back(ValueDecoder(words));
+						words += word_count(bit_counts[idx + 1U]);
+					}
+
+					timepoints.resize(block->rows);
+					values.resize(block->rows * this->count);
+
+					for (unsigned long long row = 0; row < block->rows; row++) {
+						timepoints[row] = tdecoder.next();
+
+						for (unsigned int idx = 0; idx < this->count; idx++) {
+							values[row * this->count + idx] = vdecoders[idx].next();
+						}
+					}
+
+					take_rows(request, timepoints.data(), values.data(), block->rows, this->count, close_ms, open_ms);
+				}
+			} else {
+				this->log_failure(L"failed to map segment", segment->path);
+			}
+		}
+	}
+}
+
+void TimeSeriesDB::seal(tssegment* segment) {
+	// NOTE: the segment is not active anymore, its rows never change, and only this thread reads them
+	unsigned long long rows = segment->timepoints.size();
+	std::wstring temporary = segment_path(this->rootdir, segment->first_ms, sealed_suffix + temporary_suffix);
+	std::wstring sealed = segment_path(this->rootdir, segment->first_ms, sealed_suffix);
+	std::vector<tszindex> index;
+	std::vector<unsigned long long> payload;
+	std::vector<BitStream> streams(this->count + 1U);
+	unsigned long long offset = 0ULL;
+	tszheader header;
+	std::ofstream dest;
+
+	header.magic = TSDB_MAGIC;
+	header.count = this->count;
+	header.rows = rows;
+	header.first_ms = segment->first_ms;
+	header.last_ms = segment->last_ms;
+	header.block_count = (rows + TSDB_BLOCK_ROWS - 1ULL) / TSDB_BLOCK_ROWS;
+	offset = sizeof(tszheader) + sizeof(tszindex) * header.block_count;
+
+	for (unsigned long long start = 0; (start < rows) && (!this->terminated); start += TSDB_BLOCK_ROWS) {
+		unsigned long long end = ((start + TSDB_BLOCK_ROWS < rows) ? (start + TSDB_BLOCK_ROWS) : rows);
+		TimepointEncoder tencoder(&streams[0]);
+		std::vector<ValueEncoder> vencoders;
+		tszindex block;
+
+		for (unsigned int idx = 0; idx <= this->count; idx++) {
+			streams[idx].clear();
+
+			if (idx > 0U) {
+				vencoders.push_back(ValueEncoder(&streams[idx]));
+			}
+		}
+
+		for (unsigned long long row = start; row < end; row++) {
+			tencoder.push(segment->timepoints[row]);
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				vencoders[idx].push(segment->values[row * this->count + idx]);
+			}
+		}
+
+		block.first_ms = segment->timepoints[start];
+		block.last_ms = segment->timepoints[end - 1ULL];
+		block.offset = offset + payload.size() * sizeof(unsigned long long);
+		block.rows = end - start;
+		index.push_back(block);
+
+		for (unsigned int idx = 0; idx <= this->count; idx++) {
+			payload.push_back(streams[idx].bit_count());
+		}
+
+		for (unsigned int idx = 0; idx <= this->count; idx++) {
+			payload.insert(payload.end(), streams[idx].data(), streams[idx].data() + streams[idx].word_count());
+		}
+	}
+
+	if (this->terminated) {
+		// NOTE: do not keep the destructor waiting, the raw segment is still there, it will be sealed when it is recovered
+	} else {
+		dest.open(temporary, std::ios::out | std::ios::trunc | std::ios::binary);
+		dest.write((const char*)(&header), sizeof(tszheader));
+		dest.write((const char*)(index.data()), sizeof(tszindex) * index.size());
+		dest.write((const char*)(payload.data()), sizeof(unsigned long long) * payload.size());
+		dest.close();
+
+		if (dest.fail() || (_wrename(temporary.c_str(), sealed.c_str()) != 0)) {
+			// NOTE: the raw segment is still there, it will be sealed again when it is recovered
+			this->log_failure(L"failed to seal segment", temporary);
+			_wremove(temporary.c_str());
+		} else {
+			std::wstring raw = segment->path;
+
+			{
+				std::unique_lock<std::mutex> lock(this->section);
+
+				segment->path = sealed;
+				segment->bytes = offset + payload.size() * sizeof(unsigned long long);
+				segment->sealed = true;
+				std::vector<long long>().swap(segment->timepoints);
+				std::vector<double>().swap(segment->values);
+			}
+
+			_wremove(raw.c_str());
+		}
+	}
+}
+
+void TimeSeriesDB::retain() {
+	long long now = current_milliseconds();
+	std::vector<tssegment*> expired;
+
+	{ // NOTE: only sealed segments are removed, from the oldest one
+		std::unique_lock<std::mutex> lock(this->section);
+		unsigned long long total = 0ULL;
+		bool retaining = true;
+
+		for (auto it = this->segments.begin(); it != this->segments.end(); it++) {
+			total += it->second->bytes;
+		}
+
+		while (retaining && (!this->segments.empty())) {
+			tssegment* oldest = this->segments.begin()->second;
+
+			retaining = oldest->sealed
+				&& ((oldest->last_ms < now - this->retention_ms)
+					|| ((this->retention_bytes > 0ULL) && (total > this->retention_bytes)));
+
+			if (retaining) {
+				total -= oldest->bytes;
+				expired.push_back(oldest);
+				this->segments.erase(this->segments.begin());
+			}
+		}
+	}
+
+	for (auto segment : expired) {
+		unmap_segment(segment);
+
+		if (_wremove(segment->path.c_str()) != 0) {
+			this->log_failure(L"failed to remove segment", segment->path);
+		}
+
+		delete segment;
+	}
+}
+
+void TimeSeriesDB::recover() {
+	std::wstring pattern = this->rootdir + L"\\*";
+	std::vector<std::wstring> raws;
+	WIN32_FIND_DATAW found;
+	HANDLE finder = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &found, FindExSearchNameMatch, nullptr, 0);
+
+	if (finder != INVALID_HANDLE_VALUE) {
+		do {
+			std::wstring path = this->rootdir + L"\\" + found.cFileName;
+
+			if (ends_with(path, raw_suffix)) {
+				raws.push_back(path);
+			} else if (ends_with(path, temporary_suffix)) {
+				_wremove(path.c_str());
+			} else if (ends_with(path, sealed_suffix)) {
+				std::ifstream src(path, std::ios::in | std::ios::binary | std::ios::ate);
+				unsigned long long bytes = (unsigned long long)(src.tellg());
+				tszheader header;
+
+				src.seekg(0);
+				src.read((char*)(&header), sizeof(tszheader));
+
+				if ((!src.fail()) && (header.magic == TSDB_MAGIC) && (header.count == this->count) && (header.rows > 0ULL)) {
+					tssegment* segment = new tssegment();
+
+					segment->first_ms = header.first_ms;
+					segment->last_ms = header.last_ms;
+					segment->bytes = bytes;
+					segment->path = path;
+					segment->sealed = true;
+
+					this->segments.insert(std::pair<long long, tssegment*>(segment->first_ms, segment));
+				} else {
+					this->log_failure(L"ignored malformed segment", path);
+				}
+			}
+		} while (FindNextFileW(finder, &found));
+
+		FindClose(finder);
+	}
+
+	for (auto path : raws) {
+		// NOTE: the trailing partial row, if any, is dropped; raw segments are never appended after restarting
+		std::ifstream src(path, std::ios::in | std::ios::binary | std::ios::ate);
+		unsigned long long row_size = sizeof(long long) + sizeof(double) * this->count;
+		unsigned long long rows = (src.is_open() ? ((unsigned long long)(src.tellg()) / row_size) : 0ULL);
+		tssegment* segment = new tssegment();
+
+		segment->path = path;
+		segment->sealed = false;
+		segment->bytes = rows * row_size;
+		segment->timepoints.resize(rows);
+		segment->values.resize(rows * this->count);
+		src.seekg(0);
+
+		for (unsigned long long row = 0; row < rows; row++) {
+			src.read((char*)(&segment->timepoints[row]), sizeof(long long));
+			src.read((char*)(&segment->values[row * this->count]), sizeof(double) * this->count);
+		}
+
+		if ((rows > 0ULL) && (!src.fail())
+			&& (this->segments.find(segment->timepoints[0]) == this->segments.end())) {
+			segment->first_ms = segment->timepoints[0];
+			segment->last_ms = segment->timepoints[rows - 1ULL];
+			this->segments.insert(std::pair<long long, tssegment*>(segment->first_ms, segment));
+			this->sealings.push_back(segment);
+		} else { // empty, or it had been sealed
+			src.close();
+			_wremove(path.c_str());
+			delete segment;
+		}
+	}
+
+	if (!this->segments.empty()) {
+		this->last_timepoint = this->segments.rbegin()->second->last_ms;
+	}
+}
+
+void TimeSeriesDB::log_failure(const wchar_t* what, const std::wstring& path) {
+	if (this->logger != nullptr) {
+		this->logger->log_message(Log::Error, L"%s: %s", what, path.c_str());
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <condition_variable>
+
+#include "graphlet/time/timeserieslet.hpp"
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+	struct tssegment;
+	struct tsrequest;
+
+	/** NOTE
+	 * The built-in time series data source, one directory for one series.
+	 *
+	 * Rows are appended to the active segment file, which covers `segment_span_s` seconds,
+	 *  then the segment is sealed in the background: compressed Gorilla-style in blocks, with a sparse time index of blocks.
+	 * Sealed segments are memory-mapped for reading, and they are removed when they are older than `retention_s`,
+	 *  or when all segments take more than `retention_bytes` (0 means no limit).
+	 *
+	 * Rows saved before the existing segments are recovered are held in memory and appended once the recovery is done.
+	 * The active segment file is flushed at most once every second of rows, and whenever it is rotated.
+	 *
+	 * `load` is served by the background thread, and values are delivered in `dispatch`, say, in the thread of the receiver.
+	 */
+	private class TimeSeriesDB : public WarGrey::SCADA::ITimeSeriesDataSource {
+	public:
+		TimeSeriesDB(Platform::String^ dirname, unsigned int count,
+			long long retention_s = 7LL * day_span_s, unsigned long long retention_bytes = 0ULL,
+			long long segment_span_s = hour_span_s, WarGrey::SCADA::Syslog* logger = nullptr);
+
+	public:
+		bool ready() override;
+		bool loading() override;
+		void cancel(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver) override;
+
+	public:
+		unsigned int concurrency() override;
+		void cancel_load(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) override;
+		void dispatch() override;
+
+	public:
+		void load(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) override;
+		void save(long long timepoint_ms, double* values, unsigned int n) override;
+
+	protected:
+		~TimeSeriesDB() noexcept;
+
+	private:
+		void run();
+		void recover();
+		void serve(WarGrey::SCADA::tsrequest* request);
+		void seal(WarGrey::SCADA::tssegment* segment);
+		void retain();
+		void rotate(long long timepoint_ms);
+		void append(long long timepoint_ms, const double* values, unsigned int n);
+		void log_failure(const wchar_t* what, const std::wstring& path);
+
+	private:
+		std::wstring rootdir;
+		WarGrey::SCADA::Syslog* logger;
+		unsigned int count;
+		long long retention_ms;
+		unsigned long long retention_bytes;
+		long long segment_span_ms;
+
+	private: // guarded by `section`
+		std::map<long long, WarGrey::SCADA::tssegment*> segments; // by their first timepoints
+		std::deque<WarGrey::SCADA::tsrequest*> requests;
+		std::deque<WarGrey::SCADA::tssegment*> sealings;
+		std::deque<WarGrey::SCADA::tsrequest*> replies;
+		WarGrey::SCADA::tsrequest* serving;
+
+	private: // owned by the thread that saves values
+		WarGrey::SCADA::tssegment* active;
+		std::ofstream activestream;
+		std::vector<long long> early_timepoints; // rows saved before the recovery is done
+		std::vector<double> early_values;
+		long long last_timepoint;
+		long long last_flush;
+
+	private:
+		std::mutex section;
+		std::condition_variable wakeup;
+		std::atomic<bool> recovered;
+		std::atomic<bool> terminated; // also checked by sealing, which gives up and leaves the raw segment for the next recovery
+		std::atomic<unsigned int> pending;
+		std::thread worker;
+	};
+}
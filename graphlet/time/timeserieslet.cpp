@@ -1,4 +1,13 @@
-﻿#include "graphlet/time/timeserieslet.hpp"
+﻿#include <deque>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+
+#include "graphlet/time/timeserieslet.hpp"
+#include "graphlet/time/gorilla.hpp"
+#include "graphlet/time/projection.hpp"
 
 #include "string.hpp"
 
@@ -8,9 +17,12 @@
 #include "shape.hpp"
 #include "geometry.hpp"
 
+#include "drawing/win2d.hpp"
+
 using namespace WarGrey::SCADA;
 
 using namespace Windows::Foundation;
+using namespace Windows::Foundation::Numerics;
 using namespace Windows::System;
 
 using namespace Microsoft::Graphics::Canvas;
@@ -21,6 +33,35 @@ using namespace Microsoft::Graphics::Canvas::Geometry;
 static const long long DEFAULT_SLOT_SIZE = 4096LL;
 static const unsigned int DEFAULT_COUNT_RATE = 5;
 
+/** NOTE
+ * Levels of detail are min/max buckets of fixed time spans, each level is 4 times coarser than the previous one,
+ *  a level is used once its buckets are not wider than a pixel, so that spikes are never lost.
+ */
+static const long long LOD_BASE_SPAN_MS = 4000LL;
+
+// NOTE: sources might drop requests, say, when a request failed, a window that has not landed for so long is asked for again
+static const long long PREFETCH_STALE_MS = 10000LL;
+static const unsigned int LOD_LEVELS = 5U;
+
+static inline long long lod_bucket_span(unsigned int level) {
+	return LOD_BASE_SPAN_MS << (level * 2U);
+}
+
+/** NOTE
+ * Lines are cached in chunks of fixed time spans, which are about `CHUNK_WIDTH` pixels wide,
+ *  chunks before the tail one never change, scrolling only translates them.
+ */
+static const double CHUNK_WIDTH = 128.0;
+
+/** NOTE
+ * Axis labels are shared by all time series, date and time marks keep changing in realtime,
+ *  so the cache is simply flushed when it is full.
+ *
+ * Glyphs are bound to the shared device, the cache is also flushed once the device has been replaced,
+ *  say, after the device is lost and planets are constructed again, and it is guarded since graphlets are loaded in workers.
+ */
+static const size_t AXIS_LABEL_CACHE_SIZE = 1024U;
+
 static CanvasSolidColorBrush^ lines_default_border_color = Colours::make(0xBBBBBB);
 static CanvasTextFormat^ lines_default_font = make_bold_text_format(12.0F);
 static CanvasTextFormat^ lines_default_legend_font = make_bold_text_format(14.0F);
@@ -31,26 +72,102 @@ private struct tsdouble {
 	double value;
 };
 
-private class WarGrey::SCADA::TimeSeriesLine {
-public:
-	~TimeSeriesLine() noexcept {
-		this->clear_pool();
+private struct tsblock {
+	long long first_timepoint;
+	WarGrey::SCADA::BitStream timepoints;
+	std::vector<WarGrey::SCADA::BitStream> values;
+};
+
+private struct tsbucket {
+	long long key; // timepoint / span
+	long long min_timepoint;
+	double min_value;
+	long long max_timepoint;
+	double max_value;
+};
+
+private struct tslabel {
+	CanvasCachedGeometry^ glyphs;
+	TextExtent extent;
+};
+
+static std::map<std::wstring, tslabel> axis_labels;
+static CanvasDevice^ axis_labels_device = nullptr;
+static std::mutex axis_labels_section;
+
+static tslabel axis_label(Platform::String^ text, CanvasTextFormat^ font) {
+	CanvasDevice^ device = CanvasDevice::GetSharedDevice();
+	std::unique_lock<std::mutex> lock(axis_labels_section);
+	std::wstring key(text->Data());
+	auto maybe_label = axis_labels.end();
+
+	if (axis_labels_device != device) {
+		axis_labels.clear();
+		axis_labels_device = device;
 	}
 
-public:
-	bool empty() {
-		return ((this->legend_flonum == nullptr) && (this->flonums[this->slot_count - 1] == nullptr));
+	key.push_back(L'\t');
+	key.append(font->FontFamily->Data());
+	key.push_back(L'\t');
+	key.append(std::to_wstring(font->FontSize));
+	key.push_back(L'\t');
+	key.append(std::to_wstring(font->FontWeight.Weight));
+	key.push_back(L'\t');
+	key.append(std::to_wstring(int(font->FontStyle)));
+
+	maybe_label = axis_labels.find(key);
+
+	if (maybe_label == axis_labels.end()) {
+		tslabel label;
+
+		if (axis_labels.size() >= AXIS_LABEL_CACHE_SIZE) {
+			axis_labels.clear();
+		}
+
+		label.glyphs = geometry_freeze(paragraph(text, font, &label.extent));
+		maybe_label = axis_labels.insert(std::pair<std::wstring, tslabel>(key, label)).first;
 	}
 
-	void update_legend(unsigned int precision, WarGrey::SCADA::TimeSeriesStyle& style) {
-		Platform::String^ legend = this->name;
+	return maybe_label->second;
+}
 
-		if (this->legend_flonum != nullptr) {
-			legend += ": ";
-			legend += flstring(this->legend_flonum->value, precision);
+static void draw_marks(CanvasDrawingSession^ ds, std::vector<TimeSeriesMark>& marks, float x, float y, ICanvasBrush^ color) {
+	for (auto& mark : marks) {
+		ds->DrawCachedGeometry(mark.glyphs, x + mark.x, y + mark.y, color);
+	}
+}
+
+static inline int lod_level(long long resolution) {
+	// NOTE: the coarsest level that is not wider than a pixel, `-1` means the raw values
+	int level = -1;
+
+	for (unsigned int idx = LOD_LEVELS; idx > 0; idx--) {
+		if (lod_bucket_span(idx - 1) <= resolution) {
+			level = idx - 1;
+			break;
 		}
+	}
 
-		this->legend = make_text_layout(legend, style.legend_font);
+	return level;
+}
+
+/** NOTE
+ * Lines of a time series graphlet share the timestamp column, and each line owns a value column of every slot,
+ *  cells of lines that have no value at the timepoint of the row are NaNs.
+ */
+private class WarGrey::SCADA::TimeSeriesStore {
+public:
+	~TimeSeriesStore() noexcept {
+		this->clear_pool();
+	}
+
+	TimeSeriesStore(unsigned int count) : count(count) {}
+
+public:
+	bool empty() {
+		return ((!this->back_available)
+			&& (this->timepoints[this->slot_count - 1] == nullptr)
+			&& (this->blocks[this->slot_count - 1] == nullptr));
 	}
 
 public:
@@ -65,82 +182,152 @@ public:
 
 		if (this->current_index > 0) {
 			this->iterator_index = this->current_index - 1;
-		} else { // also works when `this->legend_value == nullptr`
+		} else { // also works when `this->back_available == false`
 			this->virtual_iterator_slot -= 1;
 			this->iterator_index = this->slot_size - 1;
 		}
 	}
 
-	bool cursor_step_backward(tsdouble* flonum) {
-		bool has_value = false;
+	void cursor_seek(long long timepoint) {
+		// NOTE: Stop at the first row after `timepoint`, or the last row, so that lines go beyond the right boundary
+		long long begin = this->virtual_history_slot * this->slot_size + this->history_last_index;
+		long long end = (this->virtual_current_slot + this->slot_count) * this->slot_size + this->current_index;
+		long long position = this->upper_position(begin, end, timepoint);
+
+		position = std::min(position, end - 1);
+		this->virtual_iterator_slot = position / this->slot_size;
+		this->iterator_index = position % this->slot_size;
+
+		if (position < begin) { // empty
+			this->virtual_iterator_slot = this->virtual_history_slot - 1;
+		}
+	}
+
+	unsigned int cursor_span_backward(long long** timepoints, double** cells) {
+		/** NOTE
+		 * Take rows from the start of the iterator slot, or the first history row, to the cursor, in the order of time,
+		 *  values of line `idx` start from `(*cells) + idx * this->cursor_stride()`.
+		 * The span might be in the scratch slot, it should be consumed before taking the next one.
+		 */
+		unsigned int n = 0U;
 
 		if ((this->virtual_iterator_slot > this->virtual_history_slot)
 			|| ((this->virtual_iterator_slot == this->virtual_history_slot)
 				&& (this->iterator_index >= this->history_last_index))) {
-			long long iterator_slot = this->virtual_iterator_slot % this->slot_count;
-		
-			(*flonum) = this->flonums[iterator_slot][this->iterator_index];
+			long long first = ((this->virtual_iterator_slot == this->virtual_history_slot) ? this->history_last_index : 0);
+			long long* tcolumn = nullptr;
+			double* vcolumns = nullptr;
 
-			if (this->iterator_index > 0) {
-				this->iterator_index -= 1;
-			} else {
-				this->virtual_iterator_slot -= 1;
-				this->iterator_index = this->slot_size - 1;
-			}
+			this->column_ref(this->virtual_iterator_slot * this->slot_size, &tcolumn, &vcolumns);
+			(*timepoints) = tcolumn + first;
+			(*cells) = vcolumns + first;
+			n = (unsigned int)(this->iterator_index - first + 1);
 
-			has_value = true;
+			this->virtual_iterator_slot -= 1;
+			this->iterator_index = this->slot_size - 1;
 		}
 
-		return has_value;
+		return n;
+	}
+
+	unsigned int cursor_stride() {
+		return this->slot_size;
+	}
+
+	bool fill_timestamp_range(long long* first, long long* last) {
+		// NOTE: both rows are cheap to reach, sealed slots know their first timepoints, and the last row is not sealed yet
+		long long begin = this->virtual_history_slot * this->slot_size + this->history_last_index;
+		long long end = (this->virtual_current_slot + this->slot_count) * this->slot_size + this->current_index;
+		bool available = (begin < end);
+
+		if (available) {
+			(*first) = this->timepoint_ref(begin);
+			(*last) = this->timepoint_ref(end - 1);
+		}
+
+		return available;
+	}
+
+	bool fill_last_timestamp(long long* timestamp) {
+		if (this->back_available) {
+			(*timestamp) = this->last_timestamp;
+		}
+
+		return this->back_available;
 	}
 
-	void push_front_value(long long timestamp, double value) {
+	bool push_front_values(long long timestamp, double* values) {
 		long long current_slot = this->virtual_history_slot % this->slot_count;
+		bool pushed = false;
 
 		if (this->history_last_index > 0) {
+			long long index = this->history_last_index - 1;
+
 			if (this->history_last_index == this->slot_size) {
-				if (this->flonums[current_slot] == nullptr) {
+				if (this->timepoints[current_slot] == nullptr) {
 					this->bzero_slot(current_slot);
 				}
 			}
 
-			this->flonums[current_slot][this->history_last_index - 1].timepoint = timestamp;
-			this->flonums[current_slot][this->history_last_index - 1].value = value;
+			this->timepoints[current_slot][index] = timestamp;
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				this->values[current_slot][idx * this->slot_size + index] = values[idx];
+			}
 
 			this->history_last_index -= 1;
+			pushed = true;
+
+			if ((this->history_last_index == 0) && (current_slot != (this->virtual_current_slot % this->slot_count))) {
+				this->seal_slot(current_slot);
+			}
 
 			if ((this->history_last_index == 0) && (this->virtual_history_slot > this->virtual_current_slot + 1U)) {
 				this->history_last_index = this->slot_size;
 				this->virtual_history_slot -= 1;
 			}
 		}
+
+		return pushed;
 	}
 
-	void push_back_value(long long timestamp, double value) {
-		long long current_slot = this->virtual_current_slot % this->slot_count;
+	void push_back_values(long long timestamp, double* values) {
+		double* cells = this->push_back_row(timestamp);
 
-		if (this->current_index == 0) {
-			if (this->flonums[current_slot] == nullptr) {
-				this->bzero_slot(current_slot);
-			}
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			cells[idx * this->slot_size] = values[idx];
 		}
+	}
 
-		this->flonums[current_slot][this->current_index].timepoint = timestamp;
-		this->flonums[current_slot][this->current_index].value = value;
+	void push_back_value(unsigned int idx, long long timestamp, double value) {
+		double* cells = nullptr;
 
-		this->legend_flonum = &this->flonums[current_slot][this->current_index];
+		if (this->back_available && (timestamp >= this->last_timestamp) && ((timestamp - this->last_timestamp) < this->row_window)) {
+			/** NOTE
+			 * Lines that are pushed one by one within the period of a row share the row stamped by the first of them,
+			 *  but only empty cells are filled, a line that already has its value in the row starts a new row,
+			 *  so that no sample is lost, and both push paths, the levels of detail and the statistics see the same samples.
+			 * The last row is never sealed, see `push_back_row()`.
+			 */
+			long long* tcolumn = nullptr;
+			unsigned int index = this->column_ref(this->virtual_current_slot * this->slot_size + this->current_index - 1, &tcolumn, &cells);
 
-		if (this->current_index < (this->slot_size - 1)) {
-			this->current_index += 1;
-		} else {
-			if ((this->virtual_history_slot - this->virtual_current_slot) <= 1) {
-				this->history_last_index = 0;
-				this->virtual_history_slot += 1;
+			cells += index;
+
+			if (!std::isnan(cells[idx * this->slot_size])) {
+				cells = nullptr;
 			}
+		}
 
-			this->current_index = 0;
-			this->virtual_current_slot += 1;
+		if (cells == nullptr) {
+			cells = this->push_back_row(timestamp);
+
+			for (unsigned int i = 0; i < this->count; i++) {
+				cells[i * this->slot_size] = std::nan("no value");
+			}
 		}
+
+		cells[idx * this->slot_size] = value;
 	}
 
 public:
@@ -148,19 +335,23 @@ public:
 		long long total = history_s * count_rate;
 		long long slot_count = total / slot_size;
 		
-		this->legend_flonum = nullptr;
 		this->clear_pool();
 
 		/** NOTE
 		 * The history values will not be stored in the current slot,
 		 * thereby always adding an extra slot for the "air" history values.
 		 *
-		 * By the way, the pool is much bigger than desired.
+		 * By the way, the pool is much bigger than desired,
+		 *  but only the hot slot and the partial history slot are kept as they are,
+		 *  full slots are sealed into compressed blocks, which are about 10 times smaller for regular samples.
 		 */
 		this->slot_count = (unsigned int)(slot_count + 1);
 		this->slot_size = (unsigned int)(slot_size);
+		this->row_window = std::max(1000LL / std::max(count_rate, 1LL), 1LL);
 
-		this->flonums = new tsdouble*[this->slot_count];
+		this->timepoints = new long long*[this->slot_count];
+		this->values = new double*[this->slot_count];
+		this->blocks = new tsblock*[this->slot_count];
 
 		this->virtual_current_slot = 0;
 		this->current_index = 0;
@@ -169,173 +360,1403 @@ public:
 		this->history_last_index = this->slot_size;
 
 		for (unsigned int idx = 0; idx < this->slot_count; idx++) {
-			this->flonums[idx] = nullptr;
+			this->timepoints[idx] = nullptr;
+			this->values[idx] = nullptr;
+			this->blocks[idx] = nullptr;
 		}
 	}
 
 	void clear_pool() {
-		this->legend_flonum = nullptr;
+		this->back_available = false;
+		this->sealing_slot = -1;
 
-		if (this->flonums != nullptr) {
+		if (this->timepoints != nullptr) {
 			for (unsigned int idx = 0; idx < this->slot_count; idx++) {
-				if (this->flonums[idx] != nullptr) {
-					delete[] this->flonums[idx];
+				if (this->timepoints[idx] != nullptr) {
+					delete[] this->timepoints[idx];
+					delete[] this->values[idx];
+				}
+
+				if (this->blocks[idx] != nullptr) {
+					delete this->blocks[idx];
 				}
 			}
 
-			delete[] this->flonums;
+			delete[] this->timepoints;
+			delete[] this->values;
+			delete[] this->blocks;
+		}
+
+		if (this->scratch_timepoints != nullptr) {
+			delete[] this->scratch_timepoints;
+			delete[] this->scratch_values;
+			this->scratch_timepoints = nullptr;
+			this->scratch_values = nullptr;
+		}
+
+		if (this->spare_timepoints != nullptr) {
+			delete[] this->spare_timepoints;
+			delete[] this->spare_values;
+			this->spare_timepoints = nullptr;
+			this->spare_values = nullptr;
 		}
+
+		this->scratch_slot = -1;
 	}
 
 	void bzero_slot(long long slot) {
 		// `bzero()` is not necessary;
-		this->flonums[slot] = new tsdouble[this->slot_size];
+		if (this->blocks[slot] != nullptr) {
+			delete this->blocks[slot];
+			this->blocks[slot] = nullptr;
+
+			if (this->scratch_slot == slot) {
+				this->scratch_slot = -1;
+			}
+		}
+
+		if (this->spare_timepoints != nullptr) {
+			this->timepoints[slot] = this->spare_timepoints;
+			this->values[slot] = this->spare_values;
+			this->spare_timepoints = nullptr;
+			this->spare_values = nullptr;
+		} else {
+			this->timepoints[slot] = new long long[this->slot_size];
+			this->values[slot] = new double[this->slot_size * this->count];
+		}
 	}
 
-public:
-	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color;
-	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ close_color;
-	Microsoft::Graphics::Canvas::Text::CanvasTextLayout^ legend;
-	Platform::String^ name;
-	bool hiden;
+	void seal_slot(long long slot) {
+		long long* tcolumn = this->timepoints[slot];
+		double* vcolumns = this->values[slot];
+		tsblock* block = new tsblock();
+		TimepointEncoder timepoints(&block->timepoints);
 
-public:
-	double selected_value;
-	float y_axis_selected;
+		for (unsigned int idx = 0; idx < this->slot_size; idx++) {
+			timepoints.push(tcolumn[idx]);
+		}
 
-private:
-	tsdouble** flonums = nullptr;
-	tsdouble* legend_flonum = nullptr;
-	unsigned int slot_count = 0;
-	unsigned int slot_size = 0;
-	long long virtual_current_slot;
-	long long current_index;
-	long long virtual_history_slot;
-	long long history_last_index;
+		block->first_timepoint = tcolumn[0];
+		block->timepoints.shrink_to_fit();
+		block->values.resize(this->count);
 
-private:
-	long long virtual_iterator_slot;
-	long long iterator_index;
-};
+		for (unsigned int line = 0; line < this->count; line++) {
+			ValueEncoder values(&block->values[line]);
+			double* column = vcolumns + line * this->slot_size;
 
-/*************************************************************************************************/
-TimeSeries WarGrey::SCADA::make_minute_series(unsigned int count, unsigned int step) {
-	TimeSeries ts;
+			for (unsigned int idx = 0; idx < this->slot_size; idx++) {
+				values.push(column[idx]);
+			}
 
-	ts.span = minute_span_s * std::max(count, 1U);
-	ts.start = current_floor_seconds(minute_span_s) - ts.span / 2;
-	ts.step = step;
+			block->values[line].shrink_to_fit();
+		}
 
-	return ts;
-}
+		this->blocks[slot] = block;
+		this->timepoints[slot] = nullptr;
+		this->values[slot] = nullptr;
 
-TimeSeries WarGrey::SCADA::make_hour_series(unsigned int count, unsigned int step) {
-	TimeSeries ts;
+		// NOTE: the raw slot will be reused by the next hot slot
+		if (this->spare_timepoints == nullptr) {
+			this->spare_timepoints = tcolumn;
+			this->spare_values = vcolumns;
+		} else {
+			delete[] tcolumn;
+			delete[] vcolumns;
+		}
+	}
 
-	ts.span = hour_span_s * std::max(count, 1U);
-	ts.start = current_floor_seconds(hour_span_s) - ts.span / 2;
-	ts.step = step;
+private:
+	double* push_back_row(long long timestamp) {
+		// NOTE: returns the cell of the first line, cells of other lines are `this->slot_size` apart
+		long long current_slot = this->virtual_current_slot % this->slot_count;
+		double* cells = nullptr;
 
-	return ts;
-}
+		if (this->current_index == 0) {
+			if (this->sealing_slot >= 0) {
+				this->seal_slot(this->sealing_slot);
+				this->sealing_slot = -1;
+			}
 
-TimeSeries WarGrey::SCADA::make_today_series(unsigned int step) {
-	TimeSeries ts;
+			if (this->timepoints[current_slot] == nullptr) {
+				this->bzero_slot(current_slot);
+			}
+		}
 
-	ts.span = day_span_s;
-	ts.start = current_floor_seconds(ts.span);
-	ts.step = step;
+		this->timepoints[current_slot][this->current_index] = timestamp;
+		cells = &this->values[current_slot][this->current_index];
 
-	return ts;
-}
+		this->last_timestamp = timestamp;
+		this->back_available = true;
 
-CanvasSolidColorBrush^ WarGrey::SCADA::lookup_default_light_color(unsigned int idx) {
-	return make_solid_brush(lookup_light_color(idx + 1));
-}
+		if (this->current_index < (this->slot_size - 1)) {
+			this->current_index += 1;
+		} else {
+			// NOTE: the full slot is sealed when the next row comes, so that other lines can still fill the last row
+			this->sealing_slot = current_slot;
 
-CanvasSolidColorBrush^ WarGrey::SCADA::lookup_default_dark_color(unsigned int idx) {
-	return make_solid_brush(lookup_dark_color(idx + 1));
-}
+			if ((this->virtual_history_slot - this->virtual_current_slot) <= 1) {
+				this->history_last_index = 0;
+				this->virtual_history_slot += 1;
+			}
 
-/*************************************************************************************************/
-ITimeSerieslet::ITimeSerieslet(ITimeSeriesDataSource* datasrc
-	, double vmin, double vmax, TimeSeries& ts, unsigned int n, float width, float height
-	, unsigned int step, unsigned int precision, long long history_span)
-	: IStatelet(TimeSeriesState::Realtime), width(std::fabsf(width)), height(height), precision(precision)
-	, data_source(datasrc), vmin(vmin), vmax(vmax), count(n), vertical_step((step == 0) ? 5U : step)
-	, realtime(ts), history(ts), history_span(history_span), history_destination(0), selected_x(std::nanf("not exists")) {
+			this->current_index = 0;
+			this->virtual_current_slot += 1;
+		}
 
-	if (this->height == 0.0F) {
-		this->height = this->width * 0.2718F;
+		return cells;
 	}
 
-	if (this->vmin > this->vmax) {
-		this->vmin = vmax;
-		this->vmax = vmin;
-	}
+	unsigned int column_ref(long long position, long long** tcolumn, double** vcolumns) {
+		long long slot = (position / this->slot_size) % this->slot_count;
 
-	if (this->data_source != nullptr) {
-		this->data_source->reference();
+		if (this->timepoints[slot] == nullptr) {
+			this->unseal_slot(slot);
+			(*tcolumn) = this->scratch_timepoints;
+			(*vcolumns) = this->scratch_values;
+		} else {
+			(*tcolumn) = this->timepoints[slot];
+			(*vcolumns) = this->values[slot];
+		}
+
+		return (unsigned int)(position % this->slot_size);
 	}
 
-	this->enable_events(true);
-	this->loading_timepoint = current_seconds();
-}
+	long long timepoint_ref(long long position) {
+		long long slot = (position / this->slot_size) % this->slot_count;
+		long long timepoint = 0;
 
-ITimeSerieslet::~ITimeSerieslet() {
-	if (this->data_source != nullptr) {
-		this->data_source->destroy();
-	}
-	
-	if (this->lines != nullptr) {
-		delete[] this->lines;
-	}
-}
+		if ((this->timepoints[slot] == nullptr) && ((position % this->slot_size) == 0)) {
+			timepoint = this->blocks[slot]->first_timepoint;
+		} else {
+			long long* tcolumn = nullptr;
+			double* vcolumns = nullptr;
+			unsigned int idx = this->column_ref(position, &tcolumn, &vcolumns);
 
-void ITimeSerieslet::update(long long count, long long interval, long long uptime) {
-	long long limit = this->history_destination;
+			timepoint = tcolumn[idx];
+		}
 
-	if (this->history_destination <= 0) {
-		limit = current_seconds();
-		this->check_visual_window(limit);
+		return timepoint;
 	}
 
-	{ // load exists data
-		long long request_interval = this->history_span / this->realtime.step;
-		long long request_earliest_s = std::min(this->realtime.start, limit - this->history_span);
+	void unseal_slot(long long slot) {
+		// NOTE: only the last unsealed slot is cached, iterations and searches touch slots one by one
+		if (this->scratch_slot != slot) {
+			tsblock* block = this->blocks[slot];
+			TimepointDecoder timepoints(&block->timepoints);
 
-		if (this->loading_timepoint > request_earliest_s) {
-			if (this->data_source != nullptr) {
-				if (this->data_source->ready() && (!this->data_source->loading())) {
-					this->data_source->load(this, this->loading_timepoint, (this->loading_timepoint - request_interval));
+			if (this->scratch_timepoints == nullptr) {
+				this->scratch_timepoints = new long long[this->slot_size];
+				this->scratch_values = new double[this->slot_size * this->count];
+			}
+
+			for (unsigned int idx = 0; idx < this->slot_size; idx++) {
+				this->scratch_timepoints[idx] = timepoints.next();
+			}
+
+			for (unsigned int line = 0; line < this->count; line++) {
+				ValueDecoder values(&block->values[line]);
+				double* column = this->scratch_values + line * this->slot_size;
+
+				for (unsigned int idx = 0; idx < this->slot_size; idx++) {
+					column[idx] = values.next();
 				}
-			} else {
-				this->on_maniplation_complete(this->loading_timepoint, (this->loading_timepoint - request_interval));
 			}
+
+			this->scratch_slot = slot;
 		}
 	}
-}
 
-void ITimeSerieslet::construct_line(unsigned int idx, Platform::String^ name) {
-	TimeSeriesStyle style = this->get_style();
-	long long slot_size = DEFAULT_SLOT_SIZE;
-	long long count_rate = DEFAULT_COUNT_RATE;
+	long long upper_position(long long begin, long long end, long long timepoint) {
+		/** NOTE
+		 * Values are in the order of time, no matter they are pushed to the front or to the back.
+		 * The slot is located by its first timepoint before searching values, so that at most one sealed slot is unsealed.
+		 */
+		if (begin < end) {
+			long long first_slot = begin / this->slot_size;
+			long long lslot = first_slot;
+			long long rslot = (end - 1) / this->slot_size + 1;
 
-	if (this->lines == nullptr) {
-		this->lines = new TimeSeriesLine[this->count];
-	}
+			while (lslot < rslot) {
+				long long mslot = lslot + (rslot - lslot) / 2;
+
+				if (this->timepoint_ref(std::max(mslot * this->slot_size, begin)) <= timepoint) {
+					lslot = mslot + 1;
+				} else {
+					rslot = mslot;
+				}
+			}
 
-	if (slot_size > this->history_span * count_rate) {
-		slot_size = this->history_span;
+			if (lslot > first_slot) {
+				begin = std::max((lslot - 1) * this->slot_size, begin);
+				end = std::min(lslot * this->slot_size, end);
+
+				while (begin < end) {
+					long long middle = begin + (end - begin) / 2;
+
+					if (this->timepoint_ref(middle) <= timepoint) {
+						begin = middle + 1;
+					} else {
+						end = middle;
+					}
+				}
+			}
+		}
+
+		return begin;
 	}
 
-	this->lines[idx].reset_pool(this->history_span, count_rate, slot_size);
-	
-	if (!name->Equals(this->lines[idx].name)) {
-		this->lines[idx].name = name;
-		this->lines[idx].close_color = nullptr;
-		this->lines[idx].hiden = false;
+private:
+	long long** timepoints = nullptr;
+	double** values = nullptr; // columns of lines are stored one after another
+	tsblock** blocks = nullptr;
+	unsigned int count;
+	unsigned int slot_count = 0;
+	unsigned int slot_size = 0;
+	long long virtual_current_slot;
+	long long current_index;
+	long long virtual_history_slot;
+	long long history_last_index;
+	long long last_timestamp;
+	long long row_window = 1; // in milliseconds
+	bool back_available = false;
+	long long sealing_slot = -1;
+
+private:
+	long long* scratch_timepoints = nullptr;
+	double* scratch_values = nullptr;
+	long long* spare_timepoints = nullptr;
+	double* spare_values = nullptr;
+	long long scratch_slot = -1;
+
+private:
+	long long virtual_iterator_slot;
+	long long iterator_index;
+};
+
+private class tssignal { // the data behind a line, shared by lines of all charts bound to the same signals
+public:
+	void reset(long long history_s) {
+		this->available = false;
+		this->history_span_ms = history_s * 1000LL;
+
+		for (unsigned int level = 0; level < LOD_LEVELS; level++) {
+			this->levels[level].clear();
+		}
+	}
+
+	void push_value(long long timepoint, double value, bool front) {
+		// NOTE: values are stored by `TimeSeriesStore`, signals only keep their levels of detail
+		if (!std::isnan(value)) {
+			if (!front) {
+				this->last_value = value;
+				this->available = true;
+			}
+
+			this->lod_push(timepoint, value, front);
+		}
+	}
+
+public:
+	std::deque<tsbucket> levels[LOD_LEVELS];
+	double last_value;
+	bool available = false;
+
+private:
+	void lod_push(long long timepoint, double value, bool front) {
+		for (unsigned int level = 0; level < LOD_LEVELS; level++) {
+			std::deque<tsbucket>* buckets = &this->levels[level];
+			long long span = lod_bucket_span(level);
+			long long key = timepoint / span;
+			tsbucket* bucket = nullptr;
+
+			if (front) {
+				if ((!buckets->empty()) && (buckets->front().key == key)) {
+					bucket = &buckets->front();
+				} else {
+					buckets->push_front(tsbucket{ key, timepoint, value, timepoint, value });
+				}
+			} else {
+				if ((!buckets->empty()) && (buckets->back().key == key)) {
+					bucket = &buckets->back();
+				} else {
+					buckets->push_back(tsbucket{ key, timepoint, value, timepoint, value });
+				}
+
+				while ((buckets->front().key + 1LL) * span <= timepoint - this->history_span_ms) {
+					buckets->pop_front();
+				}
+			}
+
+			if (bucket != nullptr) {
+				if (value < bucket->min_value) {
+					bucket->min_timepoint = timepoint;
+					bucket->min_value = value;
+				}
+
+				if (value > bucket->max_value) {
+					bucket->max_timepoint = timepoint;
+					bucket->max_value = value;
+				}
+			}
+		}
+	}
+
+private:
+	long long history_span_ms = 0;
+};
+
+private class tswindow { // statistics of a line over a window of time
+public:
+	void clear() {
+		this->mins.clear();
+		this->maxs.clear();
+		this->count = 0ULL;
+		this->sum = 0.0;
+		this->squares = 0.0;
+	}
+
+	void push_back(long long timepoint, double value) { // the newest sample
+		if (!std::isnan(value)) {
+			while ((!this->mins.empty()) && (this->mins.back().value >= value)) {
+				this->mins.pop_back();
+			}
+
+			while ((!this->maxs.empty()) && (this->maxs.back().value <= value)) {
+				this->maxs.pop_back();
+			}
+
+			this->mins.push_back(tsdouble{ timepoint, value });
+			this->maxs.push_back(tsdouble{ timepoint, value });
+			this->accumulate(value, true);
+		}
+	}
+
+	void push_front(long long timepoint, double value) { // the oldest sample, it leaves first, so it matters only as an extreme
+		if (!std::isnan(value)) {
+			if (this->mins.empty() || (value < this->mins.front().value)) {
+				this->mins.push_front(tsdouble{ timepoint, value });
+			}
+
+			if (this->maxs.empty() || (value > this->maxs.front().value)) {
+				this->maxs.push_front(tsdouble{ timepoint, value });
+			}
+
+			this->accumulate(value, true);
+		}
+	}
+
+	void pop_front(long long timepoint, double value) { // the oldest sample leaves the window
+		if (!std::isnan(value)) {
+			while ((!this->mins.empty()) && (this->mins.front().timepoint <= timepoint)) {
+				this->mins.pop_front();
+			}
+
+			while ((!this->maxs.empty()) && (this->maxs.front().timepoint <= timepoint)) {
+				this->maxs.pop_front();
+			}
+
+			this->accumulate(value, false);
+		}
+	}
+
+	bool fill_statistics(WarGrey::SCADA::TimeSeriesStatistics* stats) {
+		bool available = (this->count > 0ULL);
+
+		if (available) {
+			double n = double(this->count);
+			double mean = this->sum / n;
+
+			stats->minimum = this->mins.front().value;
+			stats->maximum = this->maxs.front().value;
+			stats->mean = this->shift + mean;
+			stats->stddev = std::sqrt(std::max(this->squares / n - mean * mean, 0.0));
+			stats->count = this->count;
+		}
+
+		return available;
+	}
+
+private:
+	void accumulate(double value, bool in) {
+		// NOTE: sums are taken around the first value, so that removing samples does not lose the precision of large values
+		double delta = 0.0;
+
+		if (this->count == 0ULL) {
+			this->shift = value;
+		}
+
+		delta = value - this->shift;
+
+		if (in) {
+			this->count += 1ULL;
+			this->sum += delta;
+			this->squares += delta * delta;
+		} else if (this->count > 1ULL) {
+			this->count -= 1ULL;
+			this->sum -= delta;
+			this->squares -= delta * delta;
+		} else {
+			this->clear();
+		}
+	}
+
+private:
+	std::deque<tsdouble> mins; // increasing values of increasing timepoints, the front is the minimum
+	std::deque<tsdouble> maxs;
+	unsigned long long count = 0ULL;
+	double shift = 0.0;
+	double sum = 0.0;
+	double squares = 0.0;
+};
+
+private class WarGrey::SCADA::TimeSeriesSignals {
+public:
+	~TimeSeriesSignals() noexcept {
+		delete this->store;
+		delete[] this->signals;
+	}
+
+	TimeSeriesSignals(unsigned int count, bool shared) : count(count), shared(shared), references(1U), version(0ULL) {
+		this->store = new TimeSeriesStore(count);
+		this->signals = new tssignal[count];
+	}
+
+public:
+	void reset(long long history_s) {
+		long long slot_size = DEFAULT_SLOT_SIZE;
+		long long count_rate = DEFAULT_COUNT_RATE;
+
+		if (slot_size > history_s * count_rate) {
+			slot_size = history_s;
+		}
+
+		this->store->reset_pool(history_s, count_rate, slot_size);
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			this->signals[idx].reset(history_s);
+		}
+
+		this->history_span = history_s;
+		this->loaded_s = current_seconds();
+		this->front_ms = std::numeric_limits<long long>::max();
+		this->version += 1ULL;
+	}
+
+	void push_back_value(unsigned int idx, long long timepoint, double value) {
+		this->store->push_back_value(idx, timepoint, value);
+		this->signals[idx].push_value(timepoint, value, false);
+		this->version += 1ULL;
+	}
+
+	void push_back_values(long long timepoint, double* values) {
+		this->store->push_back_values(timepoint, values);
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			this->signals[idx].push_value(timepoint, values[idx], false);
+		}
+
+		this->version += 1ULL;
+	}
+
+	bool push_front_values(long long timepoint, double* values) {
+		// NOTE: charts bound to the same signals might load the same window, rows that are not older are ignored
+		bool pushed = false;
+
+		if (timepoint < this->front_ms) {
+			if (this->store->push_front_values(timepoint, values)) {
+				for (unsigned int idx = 0; idx < this->count; idx++) {
+					this->signals[idx].push_value(timepoint, values[idx], true);
+				}
+
+				this->front_ms = timepoint;
+				this->version += 1ULL;
+				pushed = true;
+			}
+		}
+
+		return pushed;
+	}
+
+public:
+	TimeSeriesStore* store;
+	tssignal* signals;
+	unsigned int count;
+	bool shared;
+
+public:
+	unsigned int references; // shared signals are also referenced by the registry
+	unsigned long long version; // increased whenever the data changes
+	long long history_span;
+	long long loaded_s; // history before it has not been loaded yet
+	long long front_ms; // the earliest row loaded from history
+};
+
+static std::map<std::wstring, TimeSeriesSignals*> signals_registry;
+static std::mutex signals_registry_section; // also guards references and writes of shared signals
+
+static std::unique_lock<std::mutex> lock_shared_signals(TimeSeriesSignals* signals) {
+	// NOTE: private signals are only touched by their own charts
+	return (signals->shared
+		? std::unique_lock<std::mutex>(signals_registry_section)
+		: std::unique_lock<std::mutex>(signals_registry_section, std::defer_lock));
+}
+
+private struct tschunk {
+	CanvasGeometry^ line;
+	CanvasGeometry^ area;
+	CanvasCachedGeometry^ cached_line;
+	CanvasCachedGeometry^ cached_area;
+};
+
+private struct tschunking {
+	long long span; // in milliseconds
+	long long first_key; // chunks in [first_key, last_key] are being built, x is relative to `first_key * span`
+	long long last_key;
+	long long tail_key; // chunks since the tail one are still growing, they are built for each frame and not cached
+	double x_scale;
+	float y_axis_0;
+	float thickness;
+	CanvasStrokeStyle^ stroke_style;
+};
+
+private class WarGrey::SCADA::TimeSeriesLine {
+public:
+	void update_legend(unsigned int precision, WarGrey::SCADA::TimeSeriesStyle& style) {
+		Platform::String^ legend = this->name;
+
+		if (this->signal->available) {
+			legend += ": ";
+			legend += flstring(this->signal->last_value, precision);
+		}
+
+		if (this->statistics != nullptr) {
+			legend += this->statistics;
+		}
+
+		this->legend = make_text_layout(legend, style.legend_font);
+		this->legend_text = legend->Data();
+	}
+
+	CanvasTextLayout^ selected_metric(unsigned int precision, WarGrey::SCADA::TimeSeriesStyle& style) {
+		// NOTE: the label follows the crosshair, it is rebuilt only when the selected value changes
+		if ((this->metric == nullptr) || (this->metric_value != this->selected_value) || (this->metric_font != style.legend_font)) {
+			this->metric = make_text_layout(this->name + ": " + flstring(this->selected_value, precision), style.legend_font);
+			this->metric_value = this->selected_value;
+			this->metric_font = style.legend_font;
+		}
+
+		return this->metric;
+	}
+
+public:
+	void reset() {
+		// NOTE: lines only keep their views, the data are kept by signals
+		this->metric = nullptr;
+		this->drop_chunks();
+	}
+
+public:
+	void bucket_seek(long long timepoint, int level) {
+		// NOTE: Stop at the bucket of `timepoint`, or the last bucket, so that the line goes beyond the right boundary
+		std::deque<tsbucket>* buckets = &this->signal->levels[level];
+		long long key = timepoint / lod_bucket_span(level);
+		auto maybe_bucket = std::upper_bound(buckets->begin(), buckets->end(), key,
+			[](long long k, const tsbucket& b) { return k < b.key; });
+
+		this->bucket_level = level;
+		this->bucket_cursor = std::min((long long)(maybe_bucket - buckets->begin()), (long long)(buckets->size()) - 1LL);
+		this->bucket_later_taken = false;
+	}
+
+	bool bucket_step_backward(tsdouble* flonum) {
+		bool has_value = false;
+
+		if (this->bucket_cursor >= 0) {
+			tsbucket* bucket = &this->signal->levels[this->bucket_level][this->bucket_cursor];
+			bool min_later = (bucket->min_timepoint > bucket->max_timepoint);
+
+			// NOTE: the later extreme goes first since the iteration is backward
+			if ((!this->bucket_later_taken) == min_later) {
+				flonum->timepoint = bucket->min_timepoint;
+				flonum->value = bucket->min_value;
+			} else {
+				flonum->timepoint = bucket->max_timepoint;
+				flonum->value = bucket->max_value;
+			}
+
+			if (this->bucket_later_taken || (bucket->min_timepoint == bucket->max_timepoint)) {
+				this->bucket_cursor -= 1;
+				this->bucket_later_taken = false;
+			} else {
+				this->bucket_later_taken = true;
+			}
+
+			has_value = true;
+		}
+
+		return has_value;
+	}
+
+public:
+	void chunk_begin() {
+		this->chunk_open = false;
+		this->chunk_connected = false;
+		this->tails.clear();
+	}
+
+	void chunk_feed(tschunking* c, long long key, const float* xs, const float* ys, size_t n, unsigned int* kept) {
+		// NOTE: points are in the order of time, but chunks and spans are fed backward
+		size_t count = 0U;
+
+		if ((!this->chunk_open) || (this->chunk_key != key)) {
+			this->chunk_seal(c);
+			this->chunk_start(c, key, kept);
+		}
+
+		for (size_t idx = 0; idx < n; idx++) {
+			if (!std::isnan(ys[idx])) {
+				this->chunk_earliest = float2(xs[idx], ys[idx]);
+				this->chunk_has_earliest = true;
+				break;
+			}
+		}
+
+		count = projection_scan(&this->scan, xs, ys, n, kept);
+
+		for (size_t idx = 0; idx < count; idx++) {
+			this->chunk_points.push_back(float2(xs[kept[idx]], ys[kept[idx]]));
+		}
+	}
+
+	void chunk_end(tschunking* c) {
+		this->chunk_seal(c);
+
+		for (long long key = c->first_key; (key <= c->last_key) && (key < c->tail_key); key++) {
+			if (this->chunks.find(key) == this->chunks.end()) { // no point in the chunk
+				this->chunks.insert(std::pair<long long, tschunk>(key, tschunk()));
+			}
+		}
+	}
+
+	tschunk* chunk_ref(long long key, long long tail_key) {
+		std::map<long long, tschunk>* pool = ((key < tail_key) ? &this->chunks : &this->tails);
+		auto maybe_chunk = pool->find(key);
+
+		return ((maybe_chunk == pool->end()) ? nullptr : &maybe_chunk->second);
+	}
+
+	void draw_chunk(CanvasDrawingSession^ ds, tschunk* chunk, float x, float y, WarGrey::SCADA::TimeSeriesStyle& style) {
+		if (chunk->cached_area != nullptr) {
+			ds->DrawCachedGeometry(chunk->cached_area, x, y, this->close_color);
+		} else if (chunk->area != nullptr) {
+			ds->FillGeometry(chunk->area, x, y, this->close_color);
+		}
+
+		if (chunk->cached_line != nullptr) {
+			ds->DrawCachedGeometry(chunk->cached_line, x, y, this->color);
+		} else if (chunk->line != nullptr) {
+			ds->DrawGeometry(chunk->line, x, y, this->color, style.lines_thickness, style.lines_style);
+		}
+	}
+
+	void drop_chunks() {
+		this->chunks.clear();
+		this->tails.clear();
+	}
+
+	void drop_chunks(long long first_key, long long last_key) {
+		this->chunks.erase(this->chunks.lower_bound(first_key), this->chunks.upper_bound(last_key));
+	}
+
+	void keep_chunks(long long first_key, long long last_key) {
+		this->chunks.erase(this->chunks.begin(), this->chunks.lower_bound(first_key));
+		this->chunks.erase(this->chunks.upper_bound(last_key), this->chunks.end());
+	}
+
+private:
+	void chunk_start(tschunking* c, long long key, unsigned int* kept) {
+		this->chunk_key = key;
+		this->chunk_open = true;
+		this->chunk_has_earliest = false;
+		this->chunk_points.clear();
+
+		projection_scan_begin(&this->scan, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+			c->thickness, std::nanf("no selection"), 0.0F);
+
+		if (this->chunk_connected) { // the earliest point of the later chunk
+			float x = this->chunk_connector.x;
+			float y = this->chunk_connector.y;
+
+			if (projection_scan(&this->scan, &x, &y, 1, kept) > 0) {
+				this->chunk_points.push_back(this->chunk_connector);
+			}
+		}
+	}
+
+	void chunk_seal(tschunking* c) {
+		if (this->chunk_open) {
+			// NOTE: the earliest point is always kept, so that chunks built in different frames are connected seamlessly
+			if (this->chunk_has_earliest) {
+				if (this->chunk_points.empty()
+					|| (this->chunk_points.back().x != this->chunk_earliest.x)
+					|| (this->chunk_points.back().y != this->chunk_earliest.y)) {
+					this->chunk_points.push_back(this->chunk_earliest);
+				}
+			}
+
+			if (!this->chunk_points.empty()) {
+				this->chunk_connector = this->chunk_points.back();
+				this->chunk_connected = true;
+			}
+
+			if ((this->chunk_key >= c->first_key) && (this->chunk_key <= c->last_key)) {
+				tschunk chunk;
+
+				if (this->chunk_points.size() > 1) {
+					float dx = float(double((this->chunk_key - c->first_key) * c->span) * c->x_scale);
+					CanvasPathBuilder^ line = ref new CanvasPathBuilder(CanvasDevice::GetSharedDevice());
+					size_t last = this->chunk_points.size() - 1;
+
+					line->BeginFigure(this->chunk_points[0].x - dx, this->chunk_points[0].y);
+					for (size_t idx = 1; idx <= last; idx++) {
+						line->AddLine(this->chunk_points[idx].x - dx, this->chunk_points[idx].y);
+					}
+					line->EndFigure(CanvasFigureLoop::Open);
+					chunk.line = CanvasGeometry::CreatePath(line);
+
+					if (this->close_color != nullptr) {
+						CanvasPathBuilder^ area = ref new CanvasPathBuilder(CanvasDevice::GetSharedDevice());
+
+						area->BeginFigure(this->chunk_points[0].x - dx, c->y_axis_0);
+						for (size_t idx = 0; idx <= last; idx++) {
+							area->AddLine(this->chunk_points[idx].x - dx, this->chunk_points[idx].y);
+						}
+						area->AddLine(this->chunk_points[last].x - dx, c->y_axis_0);
+						area->EndFigure(CanvasFigureLoop::Closed);
+						chunk.area = CanvasGeometry::CreatePath(area);
+					}
+
+					if (this->chunk_key < c->tail_key) {
+						chunk.cached_line = geometry_freeze(geometry_stroke(chunk.line, c->thickness, c->stroke_style));
+						chunk.line = nullptr;
+
+						if (chunk.area != nullptr) {
+							chunk.cached_area = geometry_freeze(chunk.area);
+							chunk.area = nullptr;
+						}
+					}
+				}
+
+				if (this->chunk_key < c->tail_key) {
+					this->chunks[this->chunk_key] = chunk;
+				} else {
+					this->tails[this->chunk_key] = chunk;
+				}
+			}
+
+			this->chunk_open = false;
+		}
+	}
+
+public:
+	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ color;
+	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ close_color;
+	Microsoft::Graphics::Canvas::Text::CanvasTextLayout^ legend;
+	std::wstring legend_text;
+	Platform::String^ name;
+	Platform::String^ statistics;
+	tssignal* signal;
+	bool hiden;
+
+public:
+	tswindow visible;
+	tswindow recent;
+
+public:
+	double selected_value;
+	float selected_diff;
+	float y_axis_selected;
+
+private:
+	CanvasTextLayout^ metric;
+	CanvasTextFormat^ metric_font;
+	double metric_value;
+
+private:
+	int bucket_level;
+	long long bucket_cursor;
+	bool bucket_later_taken;
+
+private:
+	std::map<long long, tschunk> chunks;
+	std::map<long long, tschunk> tails;
+	std::vector<Windows::Foundation::Numerics::float2> chunk_points;
+	Windows::Foundation::Numerics::float2 chunk_connector;
+	Windows::Foundation::Numerics::float2 chunk_earliest;
+	WarGrey::SCADA::ProjectionScan scan;
+	long long chunk_key;
+	bool chunk_open = false;
+	bool chunk_connected = false;
+	bool chunk_has_earliest = false;
+};
+
+/*************************************************************************************************/
+TimeSeries WarGrey::SCADA::make_minute_series(unsigned int count, unsigned int step) {
+	TimeSeries ts;
+
+	ts.span = minute_span_s * std::max(count, 1U);
+	ts.start = current_floor_seconds(minute_span_s) - ts.span / 2;
+	ts.step = step;
+
+	return ts;
+}
+
+TimeSeries WarGrey::SCADA::make_hour_series(unsigned int count, unsigned int step) {
+	TimeSeries ts;
+
+	ts.span = hour_span_s * std::max(count, 1U);
+	ts.start = current_floor_seconds(hour_span_s) - ts.span / 2;
+	ts.step = step;
+
+	return ts;
+}
+
+TimeSeries WarGrey::SCADA::make_today_series(unsigned int step) {
+	TimeSeries ts;
+
+	ts.span = day_span_s;
+	ts.start = current_floor_seconds(ts.span);
+	ts.step = step;
+
+	return ts;
+}
+
+CanvasSolidColorBrush^ WarGrey::SCADA::lookup_default_light_color(unsigned int idx) {
+	return make_solid_brush(lookup_light_color(idx + 1));
+}
+
+CanvasSolidColorBrush^ WarGrey::SCADA::lookup_default_dark_color(unsigned int idx) {
+	return make_solid_brush(lookup_dark_color(idx + 1));
+}
+
+void WarGrey::SCADA::register_time_series_signals(Platform::String^ name, unsigned int count, long long history_s) {
+	std::unique_lock<std::mutex> lock(signals_registry_section);
+	std::wstring key(name->Data());
+
+	if (signals_registry.find(key) == signals_registry.end()) {
+		TimeSeriesSignals* signals = new TimeSeriesSignals(count, true); // the reference is held by the registry
+
+		signals->reset(history_s);
+		signals_registry[key] = signals;
+	}
+}
+
+bool WarGrey::SCADA::push_time_series_signals(Platform::String^ name, double* values, unsigned int n, long long timepoint_ms) {
+	std::unique_lock<std::mutex> lock(signals_registry_section);
+	auto maybe_signals = signals_registry.find(name->Data());
+	bool pushed = false;
+
+	if ((maybe_signals != signals_registry.end()) && (maybe_signals->second->count == n)) {
+		maybe_signals->second->push_back_values(((timepoint_ms <= 0) ? current_milliseconds() : timepoint_ms), values);
+		pushed = true;
+	}
+
+	return pushed;
+}
+
+bool WarGrey::SCADA::unregister_time_series_signals(Platform::String^ name) {
+	TimeSeriesSignals* unreferenced = nullptr;
+	bool unregistered = false;
+
+	{
+		std::unique_lock<std::mutex> lock(signals_registry_section);
+		auto maybe_signals = signals_registry.find(name->Data());
+
+		if (maybe_signals != signals_registry.end()) {
+			TimeSeriesSignals* signals = maybe_signals->second;
+
+			signals_registry.erase(maybe_signals);
+			signals->references -= 1U;
+			unregistered = true;
+
+			if (signals->references == 0U) {
+				unreferenced = signals;
+			}
+		}
+	}
+
+	if (unreferenced != nullptr) {
+		delete unreferenced;
+	}
+
+	return unregistered;
+}
+
+/*************************************************************************************************/
+ITimeSerieslet::ITimeSerieslet(ITimeSeriesDataSource* datasrc
+	, double vmin, double vmax, TimeSeries& ts, unsigned int n, float width, float height
+	, unsigned int step, unsigned int precision, long long history_span)
+	: IStatelet(TimeSeriesState::Realtime), width(std::fabsf(width)), height(height), precision(precision)
+	, data_source(datasrc), vmin(vmin), vmax(vmax), count(n), vertical_step((step == 0) ? 5U : step)
+	, realtime(ts), history(ts), history_span(history_span), history_destination(0), selected_x(std::nanf("not exists"))
+	, store(nullptr), signals(nullptr), chunk_span(0LL), selected_utc_s(0LL)
+	, recent_span(minute_span_s * 5LL), stats_version(0ULL), visible_statistics(false), recent_statistics(false) {
+
+	if (this->height == 0.0F) {
+		this->height = this->width * 0.2718F;
+	}
+
+	if (this->vmin > this->vmax) {
+		this->vmin = vmax;
+		this->vmax = vmin;
+	}
+
+	if (this->data_source != nullptr) {
+		this->data_source->reference();
+	}
+
+	this->enable_events(true);
+	this->loading_timepoint = current_seconds();
+}
+
+ITimeSerieslet::~ITimeSerieslet() {
+	if (this->data_source != nullptr) {
+		// NOTE: the source might outlive this chart if other charts share it, it must not deliver values here anymore
+		this->cancel_prefetches();
+		this->data_source->destroy();
+	}
+	
+	if (this->lines != nullptr) {
+		delete[] this->lines;
+	}
+
+	this->release_signals();
+}
+
+void ITimeSerieslet::update(long long count, long long interval, long long uptime) {
+	long long limit = this->history_destination;
+
+	if (this->history_destination <= 0) {
+		limit = current_seconds();
+		this->check_visual_window(limit);
+	}
+
+	{ // load exists data
+		long long request_interval = this->history_span / this->realtime.step;
+		long long request_earliest_s = std::min(this->realtime.start, limit - this->history_span);
+
+		if (this->data_source != nullptr) {
+			this->data_source->dispatch();
+		}
+
+		if (this->loading_timepoint > request_earliest_s) {
+			if (this->data_source != nullptr) {
+				if (this->data_source->ready()) {
+					this->prefetch_history(request_earliest_s, request_interval);
+				}
+			} else {
+				this->on_maniplation_complete(this->loading_timepoint, (this->loading_timepoint - request_interval));
+			}
+		}
+	}
+
+	this->sync_signals();
+	this->update_statistics();
+}
+
+void ITimeSerieslet::prefetch_history(long long earliest_s, long long interval) {
+	/** NOTE
+	 * Windows of `interval` seconds are requested backward from `loading_timepoint`, several of them could be in flight.
+	 * The window right after the loaded history always goes first since nothing older could be drawn before it lands,
+	 *  then the windows of the visible range, then the following ones.
+	 * The store only grows backward, windows completed out of order wait in `prefetches` for their turns.
+	 */
+	TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+	unsigned int concurrency = std::max(this->data_source->concurrency(), 1U);
+	long long visible_end = ts->start + ts->span;
+	long long now = current_milliseconds();
+	std::vector<long long> wanted;
+	unsigned int inflight = 0U;
+
+	for (unsigned int round = 0; round < 3; round++) {
+		long long open_s = this->loading_timepoint;
+		long long last_s = earliest_s;
+
+		if (round == 0) { // the window right after the loaded history
+			last_s = std::max(open_s - interval, earliest_s);
+		} else if (round == 1) { // the windows of the visible range
+			open_s -= std::max((this->loading_timepoint - visible_end) / interval, 0LL) * interval;
+			last_s = std::max(ts->start, earliest_s);
+		}
+
+		while ((wanted.size() < concurrency) && (open_s > last_s)) {
+			auto maybe_prefetch = this->prefetches.find(open_s);
+
+			if ((maybe_prefetch == this->prefetches.end()) || (!maybe_prefetch->second.complete)) {
+				if (std::find(wanted.begin(), wanted.end(), open_s) == wanted.end()) {
+					wanted.push_back(open_s);
+				}
+			}
+
+			open_s -= interval;
+		}
+	}
+
+	{ // cancel requests that are not wanted anymore, say, the user has scrolled away, and forget the dropped or stale ones
+		/** NOTE
+		 * Replies have been dispatched before prefetching, a source that is not loading anything has dropped the rest,
+		 *  forgotten windows that are still wanted are asked for again below.
+		 */
+		bool dropped = (!this->data_source->loading());
+		auto it = this->prefetches.begin();
+
+		while (it != this->prefetches.end()) {
+			if (it->second.complete) {
+				it++;
+			} else if ((std::find(wanted.begin(), wanted.end(), it->first) == wanted.end())
+				|| dropped || ((now - it->second.requested_ms) >= PREFETCH_STALE_MS)) {
+				this->data_source->cancel_load(this, it->first, it->second.close_s);
+				it = this->prefetches.erase(it);
+			} else {
+				inflight += 1U;
+				it++;
+			}
+		}
+	}
+
+	for (auto open_s : wanted) {
+		if (this->prefetches.find(open_s) == this->prefetches.end()) {
+			// NOTE: `loading()` is meaningless for sources that serve requests concurrently
+			if ((inflight < concurrency) && ((concurrency > 1U) || (!this->data_source->loading()))) {
+				TimeSeriesPrefetch* prefetch = &this->prefetches[open_s];
+
+				prefetch->close_s = open_s - interval;
+				prefetch->requested_ms = now;
+				prefetch->complete = false;
+				inflight += 1U;
+
+				this->data_source->load(this, open_s, prefetch->close_s);
+			}
+		}
+	}
+}
+
+void ITimeSerieslet::cancel_prefetches() {
+	if (this->data_source != nullptr) {
+		this->data_source->cancel(this);
+	}
+
+	this->prefetches.clear();
+}
+
+void ITimeSerieslet::flush_prefetches() {
+	auto maybe_prefetch = this->prefetches.find(this->loading_timepoint);
+
+	while (maybe_prefetch != this->prefetches.end()) {
+		TimeSeriesPrefetch* prefetch = &maybe_prefetch->second;
+
+		for (size_t idx = 0; idx < prefetch->timepoints.size(); idx++) {
+			this->push_history_values(prefetch->timepoints[idx], prefetch->values.data() + idx * this->count);
+		}
+
+		prefetch->timepoints.clear();
+		prefetch->values.clear();
+
+		if (prefetch->complete) {
+			this->loading_timepoint = prefetch->close_s;
+			this->prefetches.erase(maybe_prefetch);
+			maybe_prefetch = this->prefetches.find(this->loading_timepoint);
+		} else { // values will be received directly
+			maybe_prefetch = this->prefetches.end();
+		}
+	}
+}
+
+void ITimeSerieslet::construct_line(unsigned int idx, Platform::String^ name) {
+	TimeSeriesStyle style = this->get_style();
+
+	if (this->lines == nullptr) {
+		this->lines = new TimeSeriesLine[this->count];
+		this->reset_store();
+	}
+
+	this->lines[idx].reset();
+	this->chart = nullptr;
+	
+	if (!name->Equals(this->lines[idx].name)) {
+		this->lines[idx].name = name;
+		this->lines[idx].close_color = nullptr;
+		this->lines[idx].hiden = false;
+	}
+}
+
+void ITimeSerieslet::reset_store() {
+	if ((this->signals == nullptr) || this->signals->shared) { // replaying an interval never touches shared signals
+		this->release_signals();
+		this->signals = new TimeSeriesSignals(this->count, false);
+	}
+
+	this->signals->reset(this->history_span);
+	this->attach_signals();
+}
+
+void ITimeSerieslet::attach_signals() {
+	this->store = this->signals->store;
+	this->signals_version = this->signals->version;
+	this->signals_front_ms = this->signals->front_ms;
+
+	for (unsigned int idx = 0; idx < this->count; idx++) {
+		this->lines[idx].signal = &this->signals->signals[idx];
+		this->lines[idx].visible.clear();
+		this->lines[idx].recent.clear();
+	}
+
+	this->visible_window = TimeSeriesWindow{ 0LL, 0LL, std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max() };
+	this->recent_window = this->visible_window;
+	this->stats_version = 0ULL;
+}
+
+void ITimeSerieslet::release_signals() {
+	if (this->signals != nullptr) {
+		bool unreferenced = false;
+
+		{
+			std::unique_lock<std::mutex> lock = lock_shared_signals(this->signals);
+
+			this->signals->references -= 1U;
+			unreferenced = (this->signals->references == 0U);
+		}
+
+		if (unreferenced) {
+			delete this->signals;
+		}
+
+		this->signals = nullptr;
+		this->store = nullptr;
+	}
+}
+
+bool ITimeSerieslet::bind_signals(Platform::String^ name) {
+	TimeSeriesSignals* signals = nullptr;
+	bool bound = false;
+
+	if (this->lines != nullptr) {
+		std::unique_lock<std::mutex> lock(signals_registry_section);
+		auto maybe_signals = signals_registry.find(name->Data());
+
+		if ((maybe_signals != signals_registry.end()) && (maybe_signals->second->count == this->count)) {
+			signals = maybe_signals->second;
+			signals->references += 1U; // NOTE: it survives unregistering before it is attached
+		}
+	}
+
+	if (signals != nullptr) {
+		TimeSeriesStyle style = this->get_style();
+
+		this->cancel_prefetches();
+		this->release_signals();
+		this->signals = signals;
+
+		{ // NOTE: binding usually happens in workers, while the data layer is pushing values in the UI thread
+			std::unique_lock<std::mutex> lock(signals_registry_section);
+
+			this->attach_signals();
+			this->history_span = this->signals->history_span;
+			this->loading_timepoint = this->signals->loaded_s;
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				this->lines[idx].reset();
+				this->lines[idx].update_legend(this->precision + 1U, style);
+			}
+		}
+
+		this->history_destination = 0LL;
+		this->history = this->realtime;
+		this->no_selected();
+		this->update_horizontal_axes(style);
+		this->notify_updated();
+		bound = true;
+	}
+
+	return bound;
+}
+
+void ITimeSerieslet::sync_signals() {
+	// NOTE: shared signals might be changed by the data layer or by other charts
+	if (this->signals->shared) {
+		bool changed = false;
+
+		{
+			std::unique_lock<std::mutex> lock(signals_registry_section);
+
+			if (this->signals_version != this->signals->version) {
+				TimeSeriesStyle style = this->get_style();
+
+				for (unsigned int idx = 0; idx < this->count; idx++) {
+					if ((this->chunk_span > 0LL) && (this->signals->front_ms < this->signals_front_ms)) { // history loaded by others
+						this->lines[idx].drop_chunks(this->signals->front_ms / this->chunk_span - 1LL, this->signals_front_ms / this->chunk_span);
+					}
+
+					this->lines[idx].update_legend(this->precision + 1U, style);
+				}
+
+				this->signals_version = this->signals->version;
+				this->signals_front_ms = this->signals->front_ms;
+				changed = true;
+			}
+
+			if (this->signals->loaded_s < this->loading_timepoint) {
+				if (this->prefetches.empty()) { // loaded by other charts
+					this->loading_timepoint = this->signals->loaded_s;
+				}
+			} else {
+				this->signals->loaded_s = this->loading_timepoint;
+			}
+		}
+
+		if (changed) {
+			this->chart = nullptr;
+			this->notify_updated();
+		}
+	}
+}
+
+void ITimeSerieslet::update_statistics() {
+	TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+	long long visible_open = ts->start * 1000LL;
+	long long visible_limit = (ts->start + ts->span) * 1000LL;
+
+	if ((this->stats_version != this->signals->version)
+		|| (this->visible_window.open != visible_open) || (this->visible_window.limit != visible_limit)) {
+		long long first_ms = 0LL;
+		long long last_ms = 0LL;
+		long long growing_ms = 0LL;
+
+		if (this->store->fill_timestamp_range(&first_ms, &last_ms)) {
+			// NOTE: the growing row is taken when the next one comes, since other lines might still fill it
+			long long taken_ms = (this->store->fill_last_timestamp(&growing_ms) ? (last_ms - 1LL) : last_ms);
+
+			this->slide_window(&this->visible_window, false, visible_open, visible_limit, first_ms, taken_ms);
+			this->slide_window(&this->recent_window, true, last_ms - this->recent_span * 1000LL, last_ms, first_ms, taken_ms);
+		}
+
+		this->stats_version = this->signals->version;
+
+		if (this->visible_statistics || this->recent_statistics) {
+			TimeSeriesStyle style = this->get_style();
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				TimeSeriesLine* line = &this->lines[idx];
+				Platform::String^ visible = (this->visible_statistics ? make_statistics_string(&line->visible, this->precision) : nullptr);
+				Platform::String^ recent = (this->recent_statistics ? make_statistics_string(&line->recent, this->precision) : nullptr);
+
+				line->statistics = ((visible == nullptr) ? recent : ((recent == nullptr) ? visible : (visible + recent)));
+				line->update_legend(this->precision + 1U, style);
+			}
+
+			this->chart = nullptr;
+			this->notify_updated();
+		}
+	}
+}
+
+void ITimeSerieslet::slide_window(TimeSeriesWindow* w, bool recent, long long open_ms, long long limit_ms, long long first_ms, long long last_ms) {
+	/** NOTE
+	 * Rows in [max(w->open, w->front), w->close] have been taken, rows only come at both ends of the store,
+	 *  so rows before `w->front` are history loaded since then, they are older than taken ones,
+	 *  and the rest rows after `w->close` are new ones.
+	 * Samples that come or leave are visited once, the window is rebuilt only when it jumps, shrinks at the end,
+	 *  or when the store has dropped rows that are still in it.
+	 */
+	long long close_ms = std::min(limit_ms, last_ms);
+	long long taken_ms = std::max(w->open, w->front);
+
+	if ((open_ms > w->close) || (close_ms < w->close) || (first_ms > taken_ms)) {
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			(recent ? this->lines[idx].recent : this->lines[idx].visible).clear();
+		}
+
+		taken_ms = std::max(open_ms, close_ms + 1LL);
+		w->close = close_ms;
+	}
+
+	if (open_ms < taken_ms) {
+		scan_rows_backward(this->store, open_ms, std::min(taken_ms - 1LL, close_ms), [this, recent](long long timepoint, double* cells, unsigned int stride) {
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				(recent ? this->lines[idx].recent : this->lines[idx].visible).push_front(timepoint, cells[idx * stride]);
+			}
+		});
+	} else if (open_ms > taken_ms) {
+		this->take_rows(taken_ms, open_ms - 1LL);
+
+		for (size_t row = this->stats_timepoints.size(); row > 0; row--) {
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				(recent ? this->lines[idx].recent : this->lines[idx].visible).pop_front(this->stats_timepoints[row - 1],
+					this->stats_values[(row - 1) * this->count + idx]);
+			}
+		}
+	}
+
+	if (close_ms > w->close) {
+		this->take_rows(std::max(w->close + 1LL, taken_ms), close_ms);
+
+		for (size_t row = this->stats_timepoints.size(); row > 0; row--) {
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				(recent ? this->lines[idx].recent : this->lines[idx].visible).push_back(this->stats_timepoints[row - 1],
+					this->stats_values[(row - 1) * this->count + idx]);
+			}
+		}
+	}
+
+	w->open = open_ms;
+	w->limit = limit_ms;
+	w->close = close_ms;
+	w->front = first_ms;
+}
+
+void ITimeSerieslet::take_rows(long long open_ms, long long close_ms) {
+	// NOTE: rows are taken backward, and spans of the store might be in the scratch slot, so they are copied
+	this->stats_timepoints.clear();
+	this->stats_values.clear();
+
+	scan_rows_backward(this->store, open_ms, close_ms, [this](long long timepoint, double* cells, unsigned int stride) {
+		this->stats_timepoints.push_back(timepoint);
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			this->stats_values.push_back(cells[idx * stride]);
+		}
+	});
+}
+
+bool ITimeSerieslet::fill_visible_statistics(unsigned int idx, TimeSeriesStatistics* stats) {
+	return this->lines[idx].visible.fill_statistics(stats);
+}
+
+bool ITimeSerieslet::fill_recent_statistics(unsigned int idx, TimeSeriesStatistics* stats) {
+	return this->lines[idx].recent.fill_statistics(stats);
+}
+
+void ITimeSerieslet::set_recent_window(long long recent_s) {
+	if (this->recent_span != recent_s) {
+		this->recent_span = recent_s;
+		this->stats_version = 0ULL; // signals start from version 1
+	}
+}
+
+void ITimeSerieslet::show_statistics(bool visible_window, bool recent_window) {
+	TimeSeriesStyle style = this->get_style();
+
+	this->visible_statistics = visible_window;
+	this->recent_statistics = recent_window;
+	this->stats_version = 0ULL;
+
+	for (unsigned int idx = 0; idx < this->count; idx++) {
+		this->lines[idx].statistics = nullptr;
+		this->lines[idx].update_legend(this->precision + 1U, style);
 	}
+
+	this->chart = nullptr;
+	this->notify_updated();
 }
 
 void ITimeSerieslet::fill_extent(float x, float y, float* w, float* h) {
@@ -374,7 +1795,10 @@ void ITimeSerieslet::apply_style(TimeSeriesStyle& style) {
 	for (unsigned int idx = 0; idx < this->count; idx++) {
 		this->lines[idx].color = style.lookup_color(idx);
 		this->lines[idx].update_legend(this->precision + 1U, style);
+		this->lines[idx].drop_chunks(); // chunks are stroked with the line style
 	}
+
+	this->selected_timestamp = nullptr;
 }
 
 void ITimeSerieslet::on_state_changed(TimeSeriesState state) {
@@ -392,69 +1816,375 @@ void ITimeSerieslet::update_time_series(long long next_start) {
 }
 
 void ITimeSerieslet::update_vertical_axes(TimeSeriesStyle& style) {
-	CanvasGeometry^ vaxes = blank();
-	CanvasGeometry^ marks = blank();
 	CanvasPathBuilder^ axes = ref new CanvasPathBuilder(CanvasDevice::GetSharedDevice());
+	std::shared_ptr<DrawingPath> axes_path = std::make_shared<DrawingPath>();
 	float interval = this->height / float(this->vertical_step + 1);
 	double delta = (this->vmax - this->vmin) / double(this->vertical_step + 1);
 	float y = this->height - style.haxes_thickness * 0.5F;
-	TextExtent mark_te;
+
+	this->vmarks.clear();
 
 	for (unsigned int i = 1; i <= vertical_step; i++) {
 		float ythis = y - interval * float(i);
-		Platform::String^ mark = flstring(this->vmin + delta * double(i), this->precision);
-		CanvasGeometry^ gmark = paragraph(mark, style.font, &mark_te);
+		Platform::String^ text = flstring(this->vmin + delta * double(i), this->precision);
+		tslabel label = axis_label(text, style.font);
+		TimeSeriesMark mark;
 
-		marks = geometry_union(marks, gmark, style.border_thickness + mark_te.height * 0.618F, ythis - mark_te.height);
+		mark.glyphs = label.glyphs;
+		mark.text = text->Data();
+		mark.x = style.border_thickness + label.extent.height * 0.618F;
+		mark.y = ythis - label.extent.height;
+		this->vmarks.push_back(mark);
 
 		axes->BeginFigure(0.0F, ythis);
 		axes->AddLine(this->width, ythis);
 		axes->EndFigure(CanvasFigureLoop::Open);
+
+		axes_path->move_to(0.0F, ythis);
+		axes_path->line_to(this->width, ythis);
 	}
 
-	this->vmarks = geometry_freeze(marks);
 	this->vaxes = geometry_freeze(geometry_stroke(CanvasGeometry::CreatePath(axes), style.vaxes_thickness, style.vaxes_style));
+	this->vaxes_path = axes_path;
+	this->vaxes_path->set_persistent(true);
+	this->chart = nullptr;
 }
 
 void ITimeSerieslet::update_horizontal_axes(TimeSeriesStyle& style) {
 	TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
 	CanvasPathBuilder^ axes = ref new CanvasPathBuilder(CanvasDevice::GetSharedDevice());
-	CanvasGeometry^ hmarks = blank();
+	std::shared_ptr<DrawingPath> axes_path = std::make_shared<DrawingPath>();
 	float interval = this->width / float(ts->step);
 	long long delta = ts->span / ts->step;
 	float x = style.haxes_thickness * 0.5F;
 	float y = this->height - style.border_thickness;
-	TextExtent date_mark_te, time_mark_te;
+
+	this->hmarks.clear();
 
 	for (unsigned int i = 0; i <= ts->step; i++) {
 		float xthis = x + interval * float(i);
 		long long utc_s = ts->start + delta * i;
-		Platform::String^ date_mark = make_datestamp_utc(utc_s, true);
-		Platform::String^ time_mark = make_daytimestamp_utc(utc_s, true);
-		CanvasGeometry^ gdatemark = paragraph(date_mark, style.font, &date_mark_te);
-		CanvasGeometry^ gtimemark = paragraph(time_mark, style.font, &time_mark_te);
+		Platform::String^ date = make_datestamp_utc(utc_s, true);
+		Platform::String^ daytime = make_daytimestamp_utc(utc_s, true);
+		tslabel date_label = axis_label(date, style.font);
+		tslabel time_label = axis_label(daytime, style.font);
+		TimeSeriesMark date_mark, time_mark;
 
 		axes->BeginFigure(xthis, 0.0F);
 		axes->AddLine(xthis, this->height);
 		axes->EndFigure(CanvasFigureLoop::Open);
 
-		hmarks = geometry_union(hmarks, gdatemark, xthis - date_mark_te.width * 0.5F, y - date_mark_te.height);
-		hmarks = geometry_union(hmarks, gtimemark, xthis - time_mark_te.width * 0.5F, y - time_mark_te.height - date_mark_te.height);
+		axes_path->move_to(xthis, 0.0F);
+		axes_path->line_to(xthis, this->height);
+
+		date_mark.glyphs = date_label.glyphs;
+		date_mark.text = date->Data();
+		date_mark.x = xthis - date_label.extent.width * 0.5F;
+		date_mark.y = y - date_label.extent.height;
+		this->hmarks.push_back(date_mark);
+
+		time_mark.glyphs = time_label.glyphs;
+		time_mark.text = daytime->Data();
+		time_mark.x = xthis - time_label.extent.width * 0.5F;
+		time_mark.y = y - time_label.extent.height - date_label.extent.height;
+		this->hmarks.push_back(time_mark);
 	}
 
-	this->hmarks = geometry_freeze(hmarks);
 	this->haxes = geometry_stroke(CanvasGeometry::CreatePath(axes), style.haxes_thickness, style.haxes_style);
+	this->haxes_path = axes_path;
+	this->haxes_path->set_persistent(true);
+	this->chart = nullptr;
+}
+
+static void build_chunks(TimeSeriesStore* store, TimeSeriesLine* lines, unsigned int count, tschunking* c,
+	double y_offset, double y_scale, float* xs, float* ys, unsigned int* kept) {
+	// NOTE: timestamps are shared by lines, they are walked and projected only once for each span
+	unsigned int stride = store->cursor_stride();
+	long long origin = c->first_key * c->span;
+	long long* timepoints = nullptr;
+	double* cells = nullptr;
+	unsigned int n = 0U;
+
+	store->cursor_seek((c->last_key + 1LL) * c->span - 1LL);
+	n = store->cursor_span_backward(&timepoints, &cells);
+
+	while (n > 0U) {
+		unsigned int hi = n;
+
+		project_timepoints(timepoints, n, origin, 0.0, c->x_scale, xs);
+
+		while (hi > 0U) {
+			long long key = timepoints[hi - 1] / c->span;
+
+			if (key < c->first_key) {
+				hi = 0U;
+				n = 0U;
+			} else {
+				unsigned int lo = (unsigned int)(std::lower_bound(timepoints, timepoints + hi, key * c->span) - timepoints);
+
+				for (unsigned int idx = 0; idx < count; idx++) {
+					if (!lines[idx].hiden) {
+						project_values(cells + idx * stride + lo, hi - lo, y_offset, y_scale, ys);
+						lines[idx].chunk_feed(c, key, xs + lo, ys, hi - lo, kept);
+					}
+				}
+
+				hi = lo;
+			}
+		}
+
+		if (n > 0U) {
+			n = store->cursor_span_backward(&timepoints, &cells);
+		}
+	}
+}
+
+static void build_chunks(TimeSeriesLine* line, int level, tschunking* c, double y_offset, double y_scale) {
+	long long origin = c->first_key * c->span;
+	tsdouble flonum;
+	unsigned int kept;
+
+	line->bucket_seek((c->last_key + 1LL) * c->span - 1LL, level);
+
+	while (line->bucket_step_backward(&flonum)) {
+		long long key = flonum.timepoint / c->span;
+
+		if (key < c->first_key) {
+			break;
+		} else {
+			float this_x = float(double(flonum.timepoint - origin) * c->x_scale);
+			float this_y = float(y_offset + flonum.value * y_scale);
+
+			line->chunk_feed(c, key, &this_x, &this_y, 1, &kept);
+		}
+	}
+}
+
+template<typename F>
+static void scan_rows_backward(TimeSeriesStore* store, long long open_ms, long long close_ms, F visit) {
+	// NOTE: rows in [open_ms, close_ms] are visited backward, `visit` takes the timepoint, the cell of the first line and the stride
+	unsigned int stride = store->cursor_stride();
+	long long* timepoints = nullptr;
+	double* cells = nullptr;
+	bool done = (open_ms > close_ms);
+	unsigned int n = 0U;
+
+	if (!done) {
+		store->cursor_seek(close_ms);
+		n = store->cursor_span_backward(&timepoints, &cells);
+	}
+
+	while ((n > 0U) && (!done)) {
+		for (unsigned int i = n; (i > 0U) && (!done); i--) {
+			if (timepoints[i - 1] < open_ms) {
+				done = true;
+			} else if (timepoints[i - 1] <= close_ms) {
+				visit(timepoints[i - 1], cells + (i - 1), stride);
+			}
+		}
+
+		if (!done) {
+			n = store->cursor_span_backward(&timepoints, &cells);
+		}
+	}
+}
+
+static Platform::String^ make_statistics_string(tswindow* window, unsigned int precision) {
+	TimeSeriesStatistics stats;
+	Platform::String^ s = nullptr;
+
+	if (window->fill_statistics(&stats)) {
+		s = " | " + flstring(stats.minimum, precision) + " ~ " + flstring(stats.maximum, precision)
+			+ ", " + flstring(stats.mean, precision) + " +/- " + flstring(stats.stddev, precision);
+	}
+
+	return s;
+}
+
+static void fill_vertical_scale(double vmin, double vmax, Rect& box, double* y_offset, double* y_scale) {
+	(*y_offset) = double(box.Y + box.Height);
+	(*y_scale) = 0.0;
+
+	if (vmin != vmax) {
+		(*y_scale) = -double(box.Height) / (vmax - vmin);
+		(*y_offset) = double(box.Y) - vmax * (*y_scale);
+	}
+}
+
+static bool neighbour_timepoint(TimeSeriesStore* store, long long timepoint, bool forward, long long* neighbour) {
+	// NOTE: the cursor stops at the first row after `timepoint`, rows before it are usually in the same span
+	long long* timepoints = nullptr;
+	double* cells = nullptr;
+	bool found = false;
+	unsigned int n = 0U;
+
+	store->cursor_seek(timepoint);
+	n = store->cursor_span_backward(&timepoints, &cells);
+
+	if (forward) {
+		if ((n > 0U) && (timepoints[n - 1] > timepoint)) {
+			(*neighbour) = timepoints[n - 1];
+			found = true;
+		}
+	} else {
+		while ((n > 0U) && (!found)) {
+			if (timepoints[n - 1] < timepoint) {
+				(*neighbour) = timepoints[n - 1];
+				found = true;
+			} else {
+				n -= 1U;
+
+				if (n == 0U) {
+					n = store->cursor_span_backward(&timepoints, &cells);
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+static void select_values(TimeSeriesStore* store, TimeSeriesLine* lines, unsigned int count, long long timepoint,
+	long long origin, double x_scale, double y_offset, double y_scale, float selected_x, float tolerance) {
+	// NOTE: only the first row after `timepoint` and the one before it are candidates, no need to walk the visible rows
+	unsigned int stride = store->cursor_stride();
+	long long* timepoints = nullptr;
+	double* cells = nullptr;
+	unsigned int rows = 0U;
+	unsigned int n = 0U;
+
+	for (unsigned idx = 0; idx < count; idx++) {
+		lines[idx].selected_value = std::nanf("not resolved");
+		lines[idx].selected_diff = tolerance;
+	}
+
+	store->cursor_seek(timepoint);
+	n = store->cursor_span_backward(&timepoints, &cells);
+
+	while ((n > 0U) && (rows < 2U)) {
+		unsigned int i = n;
+
+		while ((i > 0U) && (rows < 2U)) {
+			float this_x = float(double(timepoints[i - 1] - origin) * x_scale);
+			float diff = std::fabsf(this_x - selected_x);
+
+			for (unsigned idx = 0; idx < count; idx++) {
+				TimeSeriesLine* line = &lines[idx];
+				double value = cells[idx * stride + i - 1];
+
+				if ((!line->hiden) && (!std::isnan(value)) && (diff < line->selected_diff)) {
+					line->selected_value = value;
+					line->selected_diff = diff;
+					line->y_axis_selected = float(y_offset + value * y_scale);
+				}
+			}
+
+			i -= 1U;
+			rows += 1U;
+		}
+
+		if (rows < 2U) {
+			n = store->cursor_span_backward(&timepoints, &cells);
+		}
+	}
+}
+
+static void simplify_columns(std::vector<DrawingPoint>& points) {
+	// NOTE: points are in the order of time, only the first, the last and the extremes of each pixel column are kept
+	size_t kept = 0U;
+	size_t i = 0U;
+
+	while (i < points.size()) {
+		float column = std::floor(points[i].x);
+		size_t lo = i;
+		size_t hi = i;
+		size_t j = i + 1U;
+
+		while ((j < points.size()) && (std::floor(points[j].x) == column)) {
+			if (points[j].y < points[lo].y) {
+				lo = j;
+			}
+
+			if (points[j].y > points[hi].y) {
+				hi = j;
+			}
+
+			j++;
+		}
+
+		{ // the `k`th distinct candidate is at least `i + k`, so that it has not been overwritten
+			size_t candidates[4] = { i, std::min(lo, hi), std::max(lo, hi), j - 1U };
+
+			for (size_t c = 0; c < 4; c++) {
+				if ((c == 0) || (candidates[c] != candidates[c - 1])) {
+					points[kept++] = points[candidates[c]];
+				}
+			}
+		}
+
+		i = j;
+	}
+
+	points.resize(kept);
+}
+
+static void render_series_line(IDrawingContext* dc, std::vector<DrawingPoint>& points, TimeSeriesLine* line
+	, float y_axis_0, TimeSeriesStyle& style) {
+	DrawingPath polyline;
+
+	std::reverse(points.begin(), points.end());
+	simplify_columns(points);
+
+	if (line->close_color != nullptr) {
+		DrawingPath area;
+
+		area.move_to(points.front().x, y_axis_0);
+		for (auto p = points.begin(); p != points.end(); p++) {
+			area.line_to(p->x, p->y);
+		}
+		area.line_to(points.back().x, y_axis_0);
+		area.close();
+
+		dc->fill_path(area, drawing_color(line->close_color));
+	}
+
+	polyline.move_to(points.front().x, points.front().y);
+	for (size_t idx = 1; idx < points.size(); idx++) {
+		polyline.line_to(points[idx].x, points[idx].y);
+	}
+
+	dc->stroke_path(polyline, drawing_color(line->color), style.lines_thickness);
 }
 
 void ITimeSerieslet::draw(CanvasDrawingSession^ ds, float x, float y, float Width, float Height) {
+	/** NOTE
+	 * The chart is recorded once and replayed until it is invalidated,
+	 *  so that moving the selection only repaints the overlay.
+	 */
+	if ((this->chart == nullptr) || (this->chart->Device != ds->Device) || (this->chart_x != x) || (this->chart_y != y)) {
+		CanvasCommandList^ chart = ref new CanvasCommandList(ds);
+		CanvasDrawingSession^ cds = chart->CreateDrawingSession();
+
+		this->draw_chart(cds, x, y);
+		delete cds; // stop recording here, the overlay is drawn outside the recorded chart, over its replay
+
+		this->chart = chart;
+		this->chart_x = x;
+		this->chart_y = y;
+	}
+
+	ds->DrawImage(this->chart);
+	this->draw_overlay(ds, x, y);
+}
+
+void ITimeSerieslet::draw_chart(CanvasDrawingSession^ ds, float x, float y) {
 	bool history = (this->get_state() == TimeSeriesState::History);
 	TimeSeries* ts = (history ? &this->history : &this->realtime);
 	TimeSeriesStyle style = this->get_style();
 	Rect haxes_box = this->haxes->ComputeBounds();
-	float x_axis_selected = x + this->selected_x;
 	float border_off = style.border_thickness * 0.5F;
-	float x_axis_max = std::nanf("unknown");
 	float y_axis_max = y + haxes_box.Y;
+	long long resolution = (long long)(double(ts->span * 1000LL) / double(haxes_box.Width));
 	
 	/** WARNING
 	 * It seems that Win2D/Direct2D Path object does not like overlaid lines,
@@ -489,91 +2219,149 @@ void ITimeSerieslet::draw(CanvasDrawingSession^ ds, float x, float y, float Widt
 		}
 	}
 
-	for (unsigned idx = 0; idx < this->count; idx++) {
-		TimeSeriesLine* line = &this->lines[idx];
-		tsdouble cursor_flonum;
+	{ // draw lines
+		long long start_ms = ts->start * 1000LL;
+		long long span_ms = ts->span * 1000LL;
+		double x_scale = double(haxes_box.Width) / double(span_ms);
+		double y_offset = 0.0;
+		double y_scale = 0.0;
+		long long chunk_span = std::max((long long)(std::round(CHUNK_WIDTH / x_scale)), 1LL);
+		long long leftmost_key = start_ms / chunk_span - 1LL; // the chunk connecting the left boundary
+		long long rightmost_key = (start_ms + span_ms) / chunk_span;
+		long long tail_key = std::numeric_limits<long long>::max();
+		long long last_timestamp = 0LL;
+		int level = lod_level(resolution);
+
+		fill_vertical_scale(this->vmin, this->vmax, haxes_box, &y_offset, &y_scale);
+
+		if (this->store->fill_last_timestamp(&last_timestamp)) {
+			tail_key = last_timestamp / chunk_span;
+		}
 
-		line->selected_value = std::nanf("not resolved");
+		if ((this->chunk_span != chunk_span) || (this->chunk_xscale != x_scale)
+			|| (this->chunk_yscale != y_scale) || (this->chunk_yoffset != y_offset)) {
+			for (unsigned idx = 0; idx < this->count; idx++) {
+				this->lines[idx].drop_chunks();
+			}
 
-		if (!line->hiden) {
-			float minimum_diff = style.selected_thickness * 0.5F;
-			float tolerance = style.lines_thickness;
-			float last_x = std::nanf("no datum");
-			float last_y = std::nanf("no datum");
-			float rx = x + haxes_box.Width;
-			CanvasPathBuilder^ area = nullptr;
+			this->chunk_span = chunk_span;
+			this->chunk_xscale = x_scale;
+			this->chunk_yscale = y_scale;
+			this->chunk_yoffset = y_offset;
+		}
 
-			line->cursor_end();
+		{ // build missing chunks and the growing ones
+			long long first_key = std::max(std::min(tail_key, rightmost_key + 1LL), leftmost_key);
 
-			while (line->cursor_step_backward(&cursor_flonum)) {
-				double fx = (double(cursor_flonum.timepoint) - double(ts->start * 1000)) / double(ts->span * 1000);
-				double fy = (this->vmin == this->vmax) ? 1.0 : (this->vmax - cursor_flonum.value) / (this->vmax - this->vmin);
-				float this_x = x + haxes_box.X + float(fx) * haxes_box.Width;
-				float this_y = y + haxes_box.Y + float(fy) * haxes_box.Height;
-				float this_diff = std::fabsf(this_x - x_axis_selected);
+			for (long long key = leftmost_key; key < first_key; key++) {
+				for (unsigned idx = 0; idx < this->count; idx++) {
+					TimeSeriesLine* line = &this->lines[idx];
 
-				if (this_diff < minimum_diff) {
-					minimum_diff = this_diff;
-					line->y_axis_selected = this_y;
-					line->selected_value = cursor_flonum.value;
+					if ((!line->hiden) && (line->chunk_ref(key, tail_key) == nullptr)) {
+						first_key = key;
+					}
 				}
+			}
+
+			for (unsigned idx = 0; idx < this->count; idx++) {
+				this->lines[idx].chunk_begin();
+			}
+
+			if (first_key <= rightmost_key) {
+				tschunking c;
+
+				c.span = chunk_span;
+				c.first_key = first_key;
+				c.last_key = rightmost_key;
+				c.tail_key = tail_key;
+				c.x_scale = x_scale;
+				c.y_axis_0 = y_axis_0 - y;
+				c.thickness = style.lines_thickness;
+				c.stroke_style = style.lines_style;
+
+				if (level < 0) {
+					unsigned int stride = this->store->cursor_stride();
+
+					if (this->projected_xs.size() < stride) {
+						this->projected_xs.resize(stride);
+						this->projected_ys.resize(stride);
+						this->projected_indices.resize(stride);
+					}
 
-				if (std::isnan(last_x) || (this_x > rx)) {
-					last_x = this_x;
-					last_y = this_y;
-					x_axis_max = last_x;
+					build_chunks(this->store, this->lines, this->count, &c, y_offset, y_scale,
+						this->projected_xs.data(), this->projected_ys.data(), this->projected_indices.data());
 				} else {
-					if (((last_x - this_x) > tolerance) || (std::fabsf(this_y - last_y) > tolerance) || (x_axis_max == last_x)) {
-						if (line->close_color == nullptr) {
-							ds->DrawLine(last_x, last_y, this_x, this_y, line->color, style.lines_thickness, style.lines_style);
-						} else {
-							if (area == nullptr) {
-								area = ref new CanvasPathBuilder(CanvasDevice::GetSharedDevice());
-								area->BeginFigure(last_x, y_axis_0);
-								area->AddLine(last_x, last_y);
-								x_axis_max = last_x;
-							} else {
-								area->AddLine(this_x, this_y);
-							}
+					for (unsigned idx = 0; idx < this->count; idx++) {
+						if (!this->lines[idx].hiden) {
+							build_chunks(&this->lines[idx], level, &c, y_offset, y_scale);
 						}
-
-						last_x = this_x;
-						last_y = this_y;
 					}
+				}
 
-					if (this_x < x) {
-						break;
+				for (unsigned idx = 0; idx < this->count; idx++) {
+					if (!this->lines[idx].hiden) {
+						this->lines[idx].chunk_end(&c);
 					}
 				}
 			}
+		}
 
-			if (area != nullptr) {
-				if (last_x == x_axis_max) {
-					area->EndFigure(CanvasFigureLoop::Open);
-					ds->DrawLine(last_x, last_y, last_x, y_axis_0, line->color, style.lines_thickness);
-				} else {
-					area->AddLine(last_x, y_axis_0);
-					area->EndFigure(CanvasFigureLoop::Closed);
+		{ // draw chunks, the horizontal scrolling is just a translation
+			CanvasActiveLayer^ layer = ds->CreateLayer(1.0F, Rect(x + haxes_box.X, y, haxes_box.Width, this->height));
+			long long keep_count = rightmost_key - leftmost_key + 1LL;
+
+			for (unsigned idx = 0; idx < this->count; idx++) {
+				TimeSeriesLine* line = &this->lines[idx];
 
-					{ // draw closed line area
-						CanvasGeometry^ garea = CanvasGeometry::CreatePath(area);
+				if (!line->hiden) {
+					for (long long key = leftmost_key; key <= rightmost_key; key++) {
+						tschunk* chunk = line->chunk_ref(key, tail_key);
 
-						ds->FillGeometry(garea, 0.0F, 0.0F, line->close_color);
-						ds->DrawGeometry(garea, 0.0F, 0.0F, line->color, style.lines_thickness);
+						if (chunk != nullptr) {
+							float chunk_x = float(double(x + haxes_box.X) + double(key * chunk_span - start_ms) * x_scale);
 
+							line->draw_chunk(ds, chunk, chunk_x, y, style);
+						}
 					}
 				}
+
+				line->keep_chunks(leftmost_key - keep_count, rightmost_key + keep_count);
 			}
+
+			delete layer;
 		}
 	}
 
-	ds->DrawCachedGeometry(this->vmarks, x, y, style.vaxes_color);
-	ds->DrawCachedGeometry(this->hmarks, x, y, style.haxes_color);
+	draw_marks(ds, this->vmarks, x, y, style.vaxes_color);
+	draw_marks(ds, this->hmarks, x, y, style.haxes_color);
+
+	ds->DrawRectangle(x + border_off, y + border_off,
+		this->width - style.border_thickness, this->height - style.border_thickness,
+		style.border_color, style.border_thickness);
+}
 
-	if (x_axis_selected > x) {
+void ITimeSerieslet::draw_overlay(CanvasDrawingSession^ ds, float x, float y) {
+	if (this->selected_x > 0.0F) {
+		TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+		TimeSeriesStyle style = this->get_style();
+		Rect haxes_box = this->haxes->ComputeBounds();
+		float x_axis_selected = x + this->selected_x;
+		float border_off = style.border_thickness * 0.5F;
+		float y_axis_max = y + haxes_box.Y;
+		float y_axis_0 = y_axis_max + haxes_box.Height + style.lines_thickness;
+		long long start_ms = ts->start * 1000LL;
+		double x_scale = double(haxes_box.Width) / double(ts->span * 1000LL);
+		float selected_x = this->selected_x - haxes_box.X;
+		long long selected_ms = start_ms + (long long)(std::round(double(selected_x) / x_scale));
+		double y_offset = 0.0;
+		double y_scale = 0.0;
 		float last_xoff = 0.0F;
 		float last_y = y + this->height;
-		
+
+		fill_vertical_scale(this->vmin, this->vmax, haxes_box, &y_offset, &y_scale);
+		select_values(this->store, this->lines, this->count, selected_ms, start_ms, x_scale,
+			double(y) + y_offset, y_scale, selected_x, style.selected_thickness * 0.5F);
+
 		ds->DrawLine(x_axis_selected, y_axis_0, x_axis_selected, y_axis_max,
 			style.selected_color, style.selected_thickness, style.selected_style);
 
@@ -581,8 +2369,7 @@ void ITimeSerieslet::draw(CanvasDrawingSession^ ds, float x, float y, float Widt
 			TimeSeriesLine* line = &this->lines[idx];
 
 			if (!std::isnan(line->selected_value)) {
-				Platform::String^ metric = line->name + ": " + flstring(line->selected_value, this->precision);
-				CanvasTextLayout^ desc = make_text_layout(metric, style.legend_font);
+				CanvasTextLayout^ desc = line->selected_metric(this->precision, style);
 				Rect this_box = desc->LayoutBounds;
 				float yoff = desc->LayoutBounds.Height;
 				float this_y = line->y_axis_selected - yoff;
@@ -603,16 +2390,194 @@ void ITimeSerieslet::draw(CanvasDrawingSession^ ds, float x, float y, float Widt
 		{ // draw selected time
 			double selected_s = double(this->selected_x) / double(this->width) * double(ts->span) + double(ts->start);
 			long long utc_s = (long long)std::round(selected_s);
-			CanvasTextLayout^ timestamp = make_text_layout(make_daytimestamp_utc(utc_s, true), style.font);
-			float xoff = timestamp->LayoutBounds.Width * 0.5F;
+			float xoff = 0.0F;
+
+			if ((this->selected_timestamp == nullptr) || (this->selected_utc_s != utc_s)) {
+				this->selected_timestamp = make_text_layout(make_daytimestamp_utc(utc_s, true), style.font);
+				this->selected_utc_s = utc_s;
+			}
 
-			ds->DrawTextLayout(timestamp, x_axis_selected - xoff, y + border_off, style.selected_color);
+			xoff = this->selected_timestamp->LayoutBounds.Width * 0.5F;
+			ds->DrawTextLayout(this->selected_timestamp, x_axis_selected - xoff, y + border_off, style.selected_color);
 		}
 	}
-	
-	ds->DrawRectangle(x + border_off, y + border_off,
+}
+
+void ITimeSerieslet::render(IDrawingContext* dc, float x, float y, float Width, float Height) {
+	/** NOTE
+	 * The portable counterpart of `draw()`, lines are rebuilt from the visible rows for every call rather than cached in chunks,
+	 *  and they are plain polylines, dash styles are ignored.
+	 */
+	this->render_chart(dc, x, y);
+	this->render_overlay(dc, x, y);
+}
+
+void ITimeSerieslet::render_chart(IDrawingContext* dc, float x, float y) {
+	TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+	TimeSeriesStyle style = this->get_style();
+	DrawingFont font = drawing_font(style.font);
+	Rect haxes_box = this->haxes->ComputeBounds();
+	float border_off = style.border_thickness * 0.5F;
+	float y_axis_0 = y + haxes_box.Y + haxes_box.Height + style.lines_thickness;
+	long long resolution = (long long)(double(ts->span * 1000LL) / double(haxes_box.Width));
+
+	dc->push_transform(drawing_translation(x, y));
+	dc->stroke_path(*this->vaxes_path, drawing_color(style.vaxes_color), style.vaxes_thickness);
+	dc->stroke_path(*this->haxes_path, drawing_color(style.haxes_color), style.haxes_thickness);
+	dc->pop_transform();
+
+	{ // render legends
+		DrawingFont legend_font = drawing_font(style.legend_font);
+		float legend_x = x + this->width * style.legend_fx;
+		float legend_label_height = this->lines[0].legend->LayoutBounds.Height;
+		float legend_label_x = legend_x + legend_label_height * 1.618F;
+		float legend_height = legend_label_height * 0.618F;
+		float legend_yoff = (legend_label_height - legend_height) * 0.5F;
+		float flcount = 0.0F;
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			TimeSeriesLine* line = &this->lines[idx];
+
+			if (!line->hiden) {
+				DrawingColor color = drawing_color(line->color);
+				float yoff = legend_label_height * (flcount + 0.618F);
+
+				dc->fill_rectangle(legend_x, y + legend_yoff + yoff, legend_label_height, legend_height, color);
+				dc->draw_text(line->legend_text, legend_label_x, y + yoff, legend_font, color);
+
+				flcount += 1.0F;
+			}
+		}
+	}
+
+	{ // render lines
+		long long start_ms = ts->start * 1000LL;
+		long long span_ms = ts->span * 1000LL;
+		long long open_ms = start_ms;
+		long long close_ms = start_ms + span_ms;
+		double x_scale = double(haxes_box.Width) / double(span_ms);
+		double x_origin = double(x + haxes_box.X);
+		double y_offset = 0.0;
+		double y_scale = 0.0;
+		int level = lod_level(resolution);
+		std::vector<std::vector<DrawingPoint>> points(this->count);
+
+		fill_vertical_scale(this->vmin, this->vmax, haxes_box, &y_offset, &y_scale);
+		y_offset += double(y);
+
+		// NOTE: the rows just out of the window are also taken, so that lines reach the boundaries
+		neighbour_timepoint(this->store, open_ms, false, &open_ms);
+		neighbour_timepoint(this->store, close_ms, true, &close_ms);
+
+		if (level < 0) {
+			scan_rows_backward(this->store, open_ms, close_ms, [&](long long timepoint, double* cells, unsigned int stride) {
+				float this_x = float(x_origin + double(timepoint - start_ms) * x_scale);
+
+				for (unsigned int idx = 0; idx < this->count; idx++) {
+					double value = cells[idx * stride];
+
+					if ((!this->lines[idx].hiden) && (!std::isnan(value))) {
+						points[idx].push_back(DrawingPoint{ this_x, float(y_offset + value * y_scale) });
+					}
+				}
+			});
+		} else {
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				TimeSeriesLine* line = &this->lines[idx];
+				tsdouble flonum;
+
+				if (!line->hiden) {
+					line->bucket_seek(close_ms, level);
+
+					while (line->bucket_step_backward(&flonum) && (flonum.timepoint >= open_ms)) {
+						points[idx].push_back(DrawingPoint{
+							float(x_origin + double(flonum.timepoint - start_ms) * x_scale),
+							float(y_offset + flonum.value * y_scale) });
+					}
+				}
+			}
+		}
+
+		dc->push_layer(DrawingRect{ float(x_origin), y, haxes_box.Width, this->height });
+
+		for (unsigned int idx = 0; idx < this->count; idx++) {
+			if (points[idx].size() > 1) {
+				render_series_line(dc, points[idx], &this->lines[idx], y_axis_0, style);
+			}
+		}
+
+		dc->pop_layer();
+	}
+
+	for (auto& mark : this->vmarks) {
+		dc->draw_text(mark.text, x + mark.x, y + mark.y, font, drawing_color(style.vaxes_color));
+	}
+
+	for (auto& mark : this->hmarks) {
+		dc->draw_text(mark.text, x + mark.x, y + mark.y, font, drawing_color(style.haxes_color));
+	}
+
+	dc->stroke_rectangle(x + border_off, y + border_off,
 		this->width - style.border_thickness, this->height - style.border_thickness,
-		style.border_color, style.border_thickness);
+		drawing_color(style.border_color), style.border_thickness);
+}
+
+void ITimeSerieslet::render_overlay(IDrawingContext* dc, float x, float y) {
+	if (this->selected_x > 0.0F) {
+		TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+		TimeSeriesStyle style = this->get_style();
+		DrawingFont legend_font = drawing_font(style.legend_font);
+		DrawingColor selected_color = drawing_color(style.selected_color);
+		Rect haxes_box = this->haxes->ComputeBounds();
+		float x_axis_selected = x + this->selected_x;
+		float border_off = style.border_thickness * 0.5F;
+		float y_axis_max = y + haxes_box.Y;
+		float y_axis_0 = y_axis_max + haxes_box.Height + style.lines_thickness;
+		long long start_ms = ts->start * 1000LL;
+		double x_scale = double(haxes_box.Width) / double(ts->span * 1000LL);
+		float selected_x = this->selected_x - haxes_box.X;
+		long long selected_ms = start_ms + (long long)(std::round(double(selected_x) / x_scale));
+		double y_offset = 0.0;
+		double y_scale = 0.0;
+		float last_xoff = 0.0F;
+		float last_y = y + this->height;
+
+		fill_vertical_scale(this->vmin, this->vmax, haxes_box, &y_offset, &y_scale);
+		select_values(this->store, this->lines, this->count, selected_ms, start_ms, x_scale,
+			double(y) + y_offset, y_scale, selected_x, style.selected_thickness * 0.5F);
+
+		dc->draw_line(x_axis_selected, y_axis_0, x_axis_selected, y_axis_max, selected_color, style.selected_thickness);
+
+		for (unsigned idx = 0; idx < this->count; idx++) {
+			TimeSeriesLine* line = &this->lines[idx];
+
+			if (!std::isnan(line->selected_value)) {
+				std::wstring desc = (line->name + ": " + flstring(line->selected_value, this->precision))->Data();
+				DrawingRect this_box = dc->measure_text(desc, legend_font);
+				float this_y = line->y_axis_selected - this_box.height;
+				float this_xoff = this_box.height * 0.25F;
+
+				if ((this_y + this_box.height > last_y) && (last_xoff >= 0.0F)) {
+					this_xoff = -this_box.width - this_xoff;
+				}
+
+				dc->draw_text(desc, x_axis_selected + this_xoff, this_y, legend_font,
+					((line->close_color != nullptr) ? selected_color : drawing_color(line->color)));
+
+				last_xoff = this_xoff;
+				last_y = this_box.y + this_y;
+			}
+		}
+
+		{ // render selected time
+			double selected_s = double(this->selected_x) / double(this->width) * double(ts->span) + double(ts->start);
+			std::wstring timestamp = make_daytimestamp_utc((long long)std::round(selected_s), true)->Data();
+			DrawingFont font = drawing_font(style.font);
+			float xoff = dc->measure_text(timestamp, font).width * 0.5F;
+
+			dc->draw_text(timestamp, x_axis_selected - xoff, y + border_off, font, selected_color);
+		}
+	}
 }
 
 void ITimeSerieslet::close_line(unsigned int idx, double alpha) {
@@ -621,10 +2586,14 @@ void ITimeSerieslet::close_line(unsigned int idx, double alpha) {
 	} else {
 		this->lines[idx].close_color = Colours::make(this->lines[idx].color, alpha);
 	}
+
+	this->lines[idx].drop_chunks();
+	this->chart = nullptr;
 }
 
 void ITimeSerieslet::hide_line(unsigned int idx, bool yes_no) {
 	this->lines[idx].hiden = yes_no;
+	this->chart = nullptr;
 }
 
 void ITimeSerieslet::push_value(unsigned int idx, double v, long long timepoint_ms) {
@@ -633,9 +2602,14 @@ void ITimeSerieslet::push_value(unsigned int idx, double v, long long timepoint_
 	TimeSeriesStyle style = this->get_style();
 	
 	if ((timepoint <= limit) && (timepoint >= (limit - this->history_span * 1000LL))) {
-		this->lines[idx].push_back_value(timepoint, v);
-		this->lines[idx].update_legend(this->precision + 1U, style);
+		{
+			std::unique_lock<std::mutex> lock = lock_shared_signals(this->signals);
 
+			this->signals->push_back_value(idx, timepoint, v);
+			this->lines[idx].update_legend(this->precision + 1U, style);
+		}
+
+		this->chart = nullptr;
 		this->notify_updated();
 	}
 }
@@ -646,9 +2620,14 @@ void ITimeSerieslet::set_values(double* values, bool persistent, long long timep
 	TimeSeriesStyle style = this->get_style();
 
 	if ((timepoint <= limit) && (timepoint >= (limit - this->history_span * 1000LL))) {
-		for (unsigned int idx = 0; idx < this->count; idx++) {
-			this->lines[idx].push_back_value(timepoint, values[idx]);
-			this->lines[idx].update_legend(this->precision + 1U, style);
+		{
+			std::unique_lock<std::mutex> lock = lock_shared_signals(this->signals);
+
+			this->signals->push_back_values(timepoint, values);
+
+			for (unsigned int idx = 0; idx < this->count; idx++) {
+				this->lines[idx].update_legend(this->precision + 1U, style);
+			}
 		}
 
 		if (persistent) {
@@ -657,21 +2636,52 @@ void ITimeSerieslet::set_values(double* values, bool persistent, long long timep
 			}
 		}
 
+		this->chart = nullptr;
 		this->notify_updated();
 	}
 }
 
 void ITimeSerieslet::on_datum_values(long long open_s, long long timepoint_ms, double* values, unsigned int n) {
 	if (this->loading_timepoint == open_s) {
+		this->push_history_values(timepoint_ms, values);
+	} else {
+		auto maybe_prefetch = this->prefetches.find(open_s);
+
+		if ((maybe_prefetch != this->prefetches.end()) && (!maybe_prefetch->second.complete)) {
+			maybe_prefetch->second.timepoints.push_back(timepoint_ms);
+			maybe_prefetch->second.values.insert(maybe_prefetch->second.values.end(), values, values + this->count);
+		}
+	}
+}
+
+void ITimeSerieslet::push_history_values(long long timepoint_ms, double* values) {
+	std::unique_lock<std::mutex> lock = lock_shared_signals(this->signals);
+
+	if (this->signals->push_front_values(timepoint_ms, values)) {
 		for (unsigned int idx = 0; idx < this->count; idx++) {
-			this->lines[idx].push_front_value(timepoint_ms, values[idx]);
+			if (this->chunk_span > 0LL) { // the chunk and the one connected to it
+				long long key = timepoint_ms / this->chunk_span;
+
+				this->lines[idx].drop_chunks(key - 1LL, key);
+			}
 		}
+
+		this->chart = nullptr;
 	}
 }
 
 void ITimeSerieslet::on_maniplation_complete(long long open_s, long long close_s) {
+	auto maybe_prefetch = this->prefetches.find(open_s);
+
 	if (this->loading_timepoint == open_s) {
+		if (maybe_prefetch != this->prefetches.end()) {
+			this->prefetches.erase(maybe_prefetch);
+		}
+
 		this->loading_timepoint = close_s;
+		this->flush_prefetches();
+	} else if (maybe_prefetch != this->prefetches.end()) {
+		maybe_prefetch->second.complete = true;
 	}
 }
 
@@ -680,10 +2690,7 @@ void ITimeSerieslet::set_history_interval(long long open_s, long long close_s, b
 	long long destination = std::max(open_s, close_s);
 
 	if (force || (this->history_destination != destination) || (this->history_span != span)) {
-		if (this->data_source != nullptr) {
-			this->data_source->cancel();
-		}
-
+		this->cancel_prefetches();
 		this->history_span = span;
 		this->history_destination = destination;
 
@@ -692,6 +2699,7 @@ void ITimeSerieslet::set_history_interval(long long open_s, long long close_s, b
 		this->history = this->realtime;
 
 		this->update_horizontal_axes(this->get_style());
+		this->reset_store();
 
 		for (unsigned int idx = 0; idx < this->count; idx++) {
 			this->construct_line(idx, this->lines[idx].name);
@@ -740,6 +2748,7 @@ void ITimeSerieslet::own_caret(bool yes) {
 
 void ITimeSerieslet::on_tap(float x, float y) {
 	this->selected_x = x;
+	this->notify_updated(); // the chart is still valid, only the overlay is repainted
 }
 
 bool ITimeSerieslet::on_key(VirtualKey key, bool screen_keyboard) {
@@ -749,32 +2758,51 @@ bool ITimeSerieslet::on_key(VirtualKey key, bool screen_keyboard) {
 	long long start_right_limit = limit - interval;
 	bool handled = true;
 
-	switch (key) {
-	case VirtualKey::Left: {
-		this->history.start -= interval;
-		this->history.start = std::max(this->history.start, start_left_limit);
-	}; break;
-	case VirtualKey::Right: {
-		this->history.start += interval;
-		this->history.start = std::min(this->history.start, start_right_limit);
-	}; break;
-	case VirtualKey::Add: {
-		this->history.span = this->history.span >> 1;
-		this->history.span = std::max(this->history.span, minute_span_s);
-	}; break;
-	case VirtualKey::Subtract: {
-		this->history.span = this->history.span << 1;
-		this->history.span = std::min(this->history.span, day_span_s);
-	}; break;
-	case VirtualKey::Home: this->history.start = start_left_limit; break;
-	case VirtualKey::End: this->history.start = start_right_limit; break;
-	case VirtualKey::Escape: this->history = this->realtime; break;
-	default: handled = false; break;
-	}
-
-	if (handled) {
-		this->no_selected();
-		this->update_horizontal_axes(this->get_style());
+	if ((!std::isnan(this->selected_x)) && ((key == VirtualKey::Left) || (key == VirtualKey::Right))) {
+		// NOTE: arrows scrub the crosshair sample by sample once there is a selection, Escape resets it
+		TimeSeries* ts = ((this->get_state() == TimeSeriesState::History) ? &this->history : &this->realtime);
+		Rect haxes_box = this->haxes->ComputeBounds();
+		long long start_ms = ts->start * 1000LL;
+		double x_scale = double(haxes_box.Width) / double(ts->span * 1000LL);
+		long long selected_ms = start_ms + (long long)(std::round(double(this->selected_x - haxes_box.X) / x_scale));
+		long long neighbour_ms = 0LL;
+
+		if (neighbour_timepoint(this->store, selected_ms, (key == VirtualKey::Right), &neighbour_ms)) {
+			float neighbour_x = haxes_box.X + float(double(neighbour_ms - start_ms) * x_scale);
+
+			if ((neighbour_x >= haxes_box.X) && (neighbour_x <= haxes_box.X + haxes_box.Width)) {
+				this->selected_x = neighbour_x;
+				this->notify_updated();
+			}
+		}
+	} else {
+		switch (key) {
+		case VirtualKey::Left: {
+			this->history.start -= interval;
+			this->history.start = std::max(this->history.start, start_left_limit);
+		}; break;
+		case VirtualKey::Right: {
+			this->history.start += interval;
+			this->history.start = std::min(this->history.start, start_right_limit);
+		}; break;
+		case VirtualKey::Add: {
+			this->history.span = this->history.span >> 1;
+			this->history.span = std::max(this->history.span, minute_span_s);
+		}; break;
+		case VirtualKey::Subtract: {
+			this->history.span = this->history.span << 1;
+			this->history.span = std::min(this->history.span, day_span_s);
+		}; break;
+		case VirtualKey::Home: this->history.start = start_left_limit; break;
+		case VirtualKey::End: this->history.start = start_right_limit; break;
+		case VirtualKey::Escape: this->history = this->realtime; break;
+		default: handled = false; break;
+		}
+
+		if (handled) {
+			this->no_selected();
+			this->update_horizontal_axes(this->get_style());
+		}
 	}
 
 	return handled;
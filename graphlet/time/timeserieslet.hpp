@@ -1,5 +1,9 @@
 #pragma once
 
+#include <vector>
+#include <memory>
+#include <map>
+
 #include "graphlet/primitive.hpp"
 
 #include "time.hpp"
@@ -9,10 +13,14 @@
 #include "paint.hpp"
 #include "brushes.hxx"
 
+#include "drawing/context.hpp"
+
 namespace WarGrey::SCADA {
 	typedef Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush ^ (*lookup_line_color)(unsigned int idx);
 
 	class TimeSeriesLine;
+	class TimeSeriesStore;
+	class TimeSeriesSignals;
 
 	private enum class TimeSeriesState { Realtime, History, _ };
 
@@ -29,6 +37,24 @@ namespace WarGrey::SCADA {
 	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ lookup_default_light_color(unsigned int idx);
 	Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ lookup_default_dark_color(unsigned int idx);
 
+	/** NOTE
+	 * Signals shown by several charts are registered once by name and pushed once by the data layer,
+	 *  charts bound to them via `ITimeSerieslet::bind_signals` share one history, no matter how many charts there are,
+	 *  and newly opened charts show the history at once.
+	 *
+	 * Signals of a name share timepoints, say, they are pushed together, as lines of a chart do.
+	 * A chart is bound to a whole group, line by line, so signals shown in several combinations,
+	 *  say, RPM with draught in one chart and RPM with speed in another, are registered as one group per combination,
+	 *  and the data layer pushes the common signal to each of the groups.
+	 *
+	 * Charts are usually bound while their planets are loaded in workers, so the registry is guarded,
+	 *  but values are still expected to be pushed in the UI thread, publish them via `StatePublication` from other threads.
+	 * Unregistering a group stops pushing, charts bound to it keep the history until they are unbound.
+	 */
+	void register_time_series_signals(Platform::String^ name, unsigned int count, long long history_s = day_span_s);
+	bool push_time_series_signals(Platform::String^ name, double* values, unsigned int n, long long timepoint_ms = 0LL);
+	bool unregister_time_series_signals(Platform::String^ name);
+
 	private struct TimeSeriesStyle {
 		WarGrey::SCADA::lookup_line_color lookup_color = nullptr;
 
@@ -70,7 +96,21 @@ namespace WarGrey::SCADA {
 	public:
 		virtual bool ready() = 0;
 		virtual bool loading() = 0;
-		virtual void cancel() = 0;
+
+		// NOTE: sources might be shared by several receivers, cancelling only touches requests of the receiver
+		virtual void cancel(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver) = 0;
+
+	public:
+		/** NOTE
+		 * Sources that could serve several `load`s at the same time should tell how many,
+		 *  values of each request are sent with its own `open_s`, requests may complete in any order.
+		 * Cancelling one request is the best effort, its late values are ignored anyway.
+		 */
+		virtual unsigned int concurrency() { return 1U; }
+		virtual void cancel_load(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) {}
+
+		// NOTE: receivers call it in their own threads, sources loading in background threads deliver values here
+		virtual void dispatch() {}
 
 	public:
 		virtual void load(WarGrey::SCADA::ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) = 0;
@@ -80,6 +120,36 @@ namespace WarGrey::SCADA {
 		~ITimeSeriesDataSource() noexcept {}
 	};
 
+	private struct TimeSeriesMark { // a cached axis label placed on the axes
+		Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^ glyphs;
+		std::wstring text; // for the portable rendering
+		float x;
+		float y;
+	};
+
+	private struct TimeSeriesStatistics {
+		double minimum;
+		double maximum;
+		double mean;
+		double stddev;
+		unsigned long long count;
+	};
+
+	private struct TimeSeriesWindow { // in milliseconds
+		long long open;
+		long long limit;
+		long long close;
+		long long front;
+	};
+
+	private struct TimeSeriesPrefetch {
+		long long close_s;
+		long long requested_ms; // it is asked for again once the source has dropped it or it goes stale
+		bool complete;
+		std::vector<long long> timepoints;
+		std::vector<double> values;
+	};
+
 	/************************************************************************************************/
 	private class ITimeSerieslet abstract
 		: public WarGrey::SCADA::IStatelet<WarGrey::SCADA::TimeSeriesState, WarGrey::SCADA::TimeSeriesStyle>
@@ -95,6 +165,7 @@ namespace WarGrey::SCADA {
 		void update(long long count, long long interval, long long uptime) override;
 		void fill_extent(float x, float y, float* w = nullptr, float* h = nullptr) override;
 		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y, float Width, float Height) override;
+		void render(WarGrey::SCADA::IDrawingContext* dc, float x, float y, float Width, float Height) override;
 
 	public:
 		bool on_key(Windows::System::VirtualKey key, bool screen_keyboard) override;
@@ -111,6 +182,21 @@ namespace WarGrey::SCADA {
 		void scroll_to_timepoint(long long timepoint_ms, float visual_boundary_proportion_of_series_interval = 1.5F);
 		void no_selected();
 
+	public:
+		// NOTE: bind after the chart is constructed, `set_history_interval` unbinds it since replaying is private
+		bool bind_signals(Platform::String^ name);
+
+	public:
+		/** NOTE
+		 * Statistics of the visible window and of the recent window are maintained as samples come and leave,
+		 *  say, O(1) per sample, they are up to date since the last `update`.
+		 * The last row is taken when the next one comes, since lines might be pushed one by one.
+		 */
+		bool fill_visible_statistics(unsigned int idx, WarGrey::SCADA::TimeSeriesStatistics* stats);
+		bool fill_recent_statistics(unsigned int idx, WarGrey::SCADA::TimeSeriesStatistics* stats);
+		void set_recent_window(long long recent_s);
+		void show_statistics(bool visible_window, bool recent_window = false);
+
 	protected:
 		void push_value(unsigned int idx, double value, long long timepoint_ms = 0LL);
 
@@ -125,21 +211,70 @@ namespace WarGrey::SCADA {
 		void hide_line(unsigned int idx, bool yes_no);
 
 	private:
+		void reset_store();
+		void attach_signals();
+		void release_signals();
+		void sync_signals();
+		void update_statistics();
+		void slide_window(WarGrey::SCADA::TimeSeriesWindow* w, bool recent, long long open_ms, long long limit_ms, long long first_ms, long long last_ms);
+		void take_rows(long long open_ms, long long close_ms);
+		void prefetch_history(long long earliest_s, long long interval);
+		void flush_prefetches();
+		void cancel_prefetches();
+		void push_history_values(long long timepoint_ms, double* values);
 		void check_visual_window(long long timepoint);
 		void update_time_series(long long next_start);
 		void update_vertical_axes(WarGrey::SCADA::TimeSeriesStyle& style);
 		void update_horizontal_axes(WarGrey::SCADA::TimeSeriesStyle& style);
 
 	private:
-		Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^ vmarks;
+		void draw_chart(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y);
+		void draw_overlay(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float x, float y);
+		void render_chart(WarGrey::SCADA::IDrawingContext* dc, float x, float y);
+		void render_overlay(WarGrey::SCADA::IDrawingContext* dc, float x, float y);
+
+	private:
+		std::vector<WarGrey::SCADA::TimeSeriesMark> vmarks;
 		Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^ vaxes;
-		Microsoft::Graphics::Canvas::Geometry::CanvasCachedGeometry^ hmarks;
+		std::vector<WarGrey::SCADA::TimeSeriesMark> hmarks;
 		Microsoft::Graphics::Canvas::Geometry::CanvasGeometry^ haxes;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> vaxes_path;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> haxes_path;
 
 	private:
 		WarGrey::SCADA::TimeSeriesLine* lines;
+		WarGrey::SCADA::TimeSeriesStore* store;
+		WarGrey::SCADA::TimeSeriesSignals* signals;
+		unsigned long long signals_version;
+		long long signals_front_ms;
 		unsigned int count;
 
+	private:
+		std::vector<float> projected_xs;
+		std::vector<float> projected_ys;
+		std::vector<unsigned int> projected_indices;
+		long long chunk_span;
+		double chunk_xscale;
+		double chunk_yscale;
+		double chunk_yoffset;
+
+	private: // the chart is replayed until anything but the selection changes
+		Microsoft::Graphics::Canvas::CanvasCommandList^ chart;
+		float chart_x;
+		float chart_y;
+		Microsoft::Graphics::Canvas::Text::CanvasTextLayout^ selected_timestamp;
+		long long selected_utc_s;
+
+	private:
+		WarGrey::SCADA::TimeSeriesWindow visible_window;
+		WarGrey::SCADA::TimeSeriesWindow recent_window;
+		std::vector<long long> stats_timepoints;
+		std::vector<double> stats_values;
+		long long recent_span;
+		unsigned long long stats_version;
+		bool visible_statistics;
+		bool recent_statistics;
+
 	private:
 		float width;
 		float height;
@@ -157,6 +292,7 @@ namespace WarGrey::SCADA {
 
 	private:
 		WarGrey::SCADA::ITimeSeriesDataSource* data_source;
+		std::map<long long, WarGrey::SCADA::TimeSeriesPrefetch> prefetches;
 		long long loading_timepoint;
 	};
 
@@ -223,6 +359,18 @@ namespace WarGrey::SCADA {
 			ITimeSerieslet::hide_line(_I(slot), yes_no);
 		}
 
+	public:
+		using ITimeSerieslet::fill_visible_statistics;
+		using ITimeSerieslet::fill_recent_statistics;
+
+		bool fill_visible_statistics(Name slot, WarGrey::SCADA::TimeSeriesStatistics* stats) {
+			return ITimeSerieslet::fill_visible_statistics(_I(slot), stats);
+		}
+
+		bool fill_recent_statistics(Name slot, WarGrey::SCADA::TimeSeriesStatistics* stats) {
+			return ITimeSerieslet::fill_recent_statistics(_I(slot), stats);
+		}
+
 	private:
 		Platform::String^ tongue;
 	};
@@ -34,11 +34,17 @@ ListViewNavigator::ListViewNavigator(ListView^ master) {
 }
 
 void ListViewNavigator::insert(IPlanet* planet) {
+	this->indices.insert(std::pair<IPlanet*, int>(planet, int(this->master->Items->Size)));
 	this->master->Items->Append(planet->display_name());
 }
 
 void ListViewNavigator::select(IPlanet* planet) {
-	this->master->SelectedValue = planet->display_name();
+	// NOTE: selecting by index neither searches the items nor confuses planets sharing the same display name
+	auto it = this->indices.find(planet);
+
+	if (it != this->indices.end()) {
+		this->master->SelectedIndex = it->second;
+	}
 }
 
 int ListViewNavigator::selected_index() {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "navigator/navigator.hpp"
 
 namespace WarGrey::SCADA {
@@ -18,5 +20,6 @@ namespace WarGrey::SCADA {
 	private:
 		Windows::UI::Xaml::Controls::ListView^ master;
 		Platform::Object^ listener;
+		std::map<WarGrey::SCADA::IPlanet*, int> indices;
 	};
 }
@@ -14,6 +14,9 @@
 
 #include "graphlet/primitive.hpp"
 #include "decorator/decorator.hpp"
+#include "drawing/scene.hpp"
+#include "drawing/win2d.hpp"
+#include "profiler.hpp"
 
 #include "virtualization/numpad.hpp"
 #include "virtualization/affinepad.hpp"
@@ -50,10 +53,18 @@ using namespace Microsoft::Graphics::Canvas::Geometry;
 
 #define GRAPHLET_INFO(g) (static_cast<GraphletInfo*>(g->info))
 
+static const float damage_stroke_margin = 2.0F; // selections and strokes are allowed to be slightly out of boundaries
+
 class GraphletInfo : public WarGrey::SCADA::IGraphletInfo {
 public:
     GraphletInfo(IPlanet* master, unsigned int mode)
-		: IGraphletInfo(master), mode(mode), alpha(1.0F) {};
+		: IGraphletInfo(master), mode(mode), alpha(1.0F), commands(nullptr), dirty(true)
+		, painted_x(0.0F), painted_y(0.0F), painted_width(0.0F), painted_height(0.0F) {};
+
+public: // the memory is owned by the planet's arena, `delete` just gives it back.
+	static void* operator new(size_t size, Arena* arena) { return arena->allocate(); }
+	static void operator delete(void* info, Arena* arena) { Arena::recycle(info); }
+	static void operator delete(void* info) { Arena::recycle(info); }
 
 public:
     float x;
@@ -72,14 +83,28 @@ public: // for asynchronously loaded graphlets
 	float fy0;
 	float dx0;
 	float dy0;
+
+public: // for display lists
+	CanvasCommandList^ commands;
+	float recorded_x;
+	float recorded_y;
+	float recorded_width;
+	float recorded_height;
+	bool dirty;
+
+public: // for damage tracking
+	float painted_x;
+	float painted_y;
+	float painted_width;
+	float painted_height;
 	
 public:
 	IGraphlet* next;
 	IGraphlet* prev;
 };
 
-static inline GraphletInfo* bind_graphlet_owership(IPlanet* master, unsigned int mode, IGraphlet* g) {
-    auto info = new GraphletInfo(master, mode);
+static inline GraphletInfo* bind_graphlet_owership(IPlanet* master, Arena* arena, unsigned int mode, IGraphlet* g) {
+    auto info = new (arena) GraphletInfo(master, mode);
     
 	g->info = info;
 
@@ -102,6 +127,35 @@ static inline bool unsafe_graphlet_unmasked(GraphletInfo* info, unsigned int mod
 	return ((info->mode & mode) == info->mode);
 }
 
+static bool unsafe_draw_graphlet_via_display_list(IGraphlet* g, GraphletInfo* info, CanvasDrawingSession^ ds, float width, float height) {
+	bool recording = (info->dirty || (info->commands == nullptr) || (info->commands->Device != ds->Device)
+		|| (info->recorded_x != info->x) || (info->recorded_y != info->y)
+		|| (info->recorded_width != width) || (info->recorded_height != height));
+
+	if (recording) {
+		CanvasCommandList^ commands = ref new CanvasCommandList(ds);
+		CanvasDrawingSession^ cds = commands->CreateDrawingSession();
+
+		g->draw(cds, info->x, info->y, width, height);
+		delete cds; // the command list cannot be drawn before its session is closed.
+
+		info->commands = commands;
+		info->recorded_x = info->x;
+		info->recorded_y = info->y;
+		info->recorded_width = width;
+		info->recorded_height = height;
+		info->dirty = false;
+	}
+
+	ds->DrawImage(info->commands);
+
+	return recording;
+}
+
+static inline bool unsafe_graphlet_culled(GraphletInfo* info, float width, float height, float left, float top, float right, float bottom) {
+	return ((info->x >= right) || ((info->x + width) <= left) || (info->y >= bottom) || ((info->y + height) <= top));
+}
+
 static void unsafe_fill_graphlet_bound(IGraphlet* g, GraphletInfo* info, float* x, float* y, float* width, float* height) {
 	g->fill_extent(info->x, info->y, width, height);
 
@@ -227,12 +281,15 @@ static IGraphlet* do_search_selected_graphlet(IGraphlet* start, unsigned int mod
 
 /*************************************************************************************************/
 Planet::Planet(Platform::String^ name, unsigned int initial_mode)
-	: IPlanet(name), mode(initial_mode), needs_update(false), update_sequence_depth(0), background(nullptr) {
+	: IPlanet(name), mode(initial_mode), needs_update(false), update_sequence_depth(0), background(nullptr)
+	, display_lists_enabled(false), damage_left(0.0F), damage_top(0.0F), damage_right(0.0F), damage_bottom(0.0F)
+	, damaged_all(true), culling(false) {
 	this->numpad = new Numpad(this);
 	this->arrowpad = new Affinepad(this);
 	this->bucketpad = new Bucketpad(this);
 
 	this->keyboard = this->numpad;
+	this->graphlets_arena = new Arena(sizeof(GraphletInfo));
 }
 
 Planet::~Planet() {
@@ -245,6 +302,8 @@ Planet::~Planet() {
 	delete this->numpad;
 	delete this->arrowpad;
 	delete this->bucketpad;
+
+	delete this->graphlets_arena;
 }
 
 void Planet::change_mode(unsigned int mode) {
@@ -289,6 +348,49 @@ void Planet::notify_graphlet_ready(IGraphlet* g) {
 }
 
 void Planet::notify_graphlet_updated(ISprite* g) { // NOTE: `g` may be `nullptr`
+	GraphletInfo* ginfo = planet_graphlet_info(this, dynamic_cast<IGraphlet*>(g));
+
+	if (ginfo != nullptr) {
+		ginfo->dirty = true;
+	}
+
+	if ((ginfo == nullptr) || (ginfo->rotation != 0.0F)) {
+		this->damaged_all = true;
+	} else if (!this->damaged_all) {
+		IGraphlet* graphlet = static_cast<IGraphlet*>(g);
+		float x, y, width, height;
+		float left = ginfo->painted_x;
+		float top = ginfo->painted_y;
+		float right = ginfo->painted_x + ginfo->painted_width;
+		float bottom = ginfo->painted_y + ginfo->painted_height;
+
+		unsafe_fill_graphlet_bound(graphlet, ginfo, &x, &y, &width, &height);
+
+		if ((ginfo->painted_width <= 0.0F) || (ginfo->painted_height <= 0.0F)) { // not painted yet
+			left = x;
+			top = y;
+			right = x + width;
+			bottom = y + height;
+		}
+
+		left = min(left, x) - damage_stroke_margin;
+		top = min(top, y) - damage_stroke_margin;
+		right = max(right, x + width) + damage_stroke_margin;
+		bottom = max(bottom, y + height) + damage_stroke_margin;
+
+		if (this->damage_right > this->damage_left) {
+			this->damage_left = min(this->damage_left, left);
+			this->damage_top = min(this->damage_top, top);
+			this->damage_right = max(this->damage_right, right);
+			this->damage_bottom = max(this->damage_bottom, bottom);
+		} else {
+			this->damage_left = left;
+			this->damage_top = top;
+			this->damage_right = right;
+			this->damage_bottom = bottom;
+		}
+	}
+
 	if (this->in_update_sequence()) {
 		this->needs_update = true;
 	} else if (this->info != nullptr) {
@@ -320,7 +422,7 @@ void Planet::end_update_sequence() {
 
 void Planet::insert(IGraphlet* g, float x, float y, float fx, float fy, float dx, float dy) {
 	if (g->info == nullptr) {
-		GraphletInfo* info = bind_graphlet_owership(this, this->mode, g);
+		GraphletInfo* info = bind_graphlet_owership(this, this->graphlets_arena, this->mode, g);
 
 		if (this->head_graphlet == nullptr) {
             this->head_graphlet = g;
@@ -411,6 +513,7 @@ void Planet::remove(IGraphlet* g) {
 			this->hovering_graphlet = nullptr;
 		}
 		
+		this->notify_graphlet_removed(g);
 		delete g; // g's destructor will delete the associated info object
 		this->notify_graphlet_updated(nullptr);
 		this->size_cache_invalid();
@@ -426,19 +529,30 @@ void Planet::erase() {
 		this->head_graphlet = nullptr;
 		prev_info->next = nullptr;
 
+		// NOTE: infos are not given back one by one, the arena is rewound as a whole below
+		this->graphlets_arena->begin_release();
+
 		do {
 			IGraphlet* child = temp_head;
 
 			temp_head = GRAPHLET_INFO(temp_head)->next;
 
+			this->notify_graphlet_removed(child);
 			delete child; // child's destructor will delete the associated info object
 		} while (temp_head != nullptr);
 
 		this->head_graphlet = nullptr;
 		this->size_cache_invalid();
+
+		// all infos are gone with their graphlets, rewind the arena instead of tracking the free records.
+		this->graphlets_arena->release();
 	}
 }
 
+void Planet::fill_graphlets_arena_statistics(ArenaStatistics* stats) {
+	this->graphlets_arena->fill_statistics(stats);
+}
+
 void Planet::move_to(IGraphlet* g, float x, float y, float fx, float fy, float dx, float dy) {
 	GraphletInfo* info = planet_graphlet_info(this, g);
 	
@@ -515,6 +629,32 @@ void Planet::set_background(ICanvasBrush^ background, float corner_radius) {
 	this->background_corner_radius = corner_radius;
 }
 
+void Planet::enable_display_lists(bool yes) {
+	if (this->display_lists_enabled != yes) {
+		this->display_lists_enabled = yes;
+
+		if ((!yes) && (this->head_graphlet != nullptr)) {
+			IGraphlet* child = this->head_graphlet;
+
+			do {
+				GraphletInfo* info = GRAPHLET_INFO(child);
+
+				info->commands = nullptr;
+				info->dirty = true;
+				child = info->next;
+			} while (child != this->head_graphlet);
+		}
+
+		this->notify_graphlet_updated(nullptr);
+	}
+}
+
+void Planet::fill_display_list_changes(std::vector<IGraphlet*>* recorded) {
+	if (recorded != nullptr) {
+		recorded->assign(this->recorded_graphlets.begin(), this->recorded_graphlets.end());
+	}
+}
+
 void Planet::cellophane(IGraphlet* g, float opacity) {
 	GraphletInfo* info = planet_graphlet_info(this, g);
 
@@ -524,6 +664,7 @@ void Planet::cellophane(IGraphlet* g, float opacity) {
 }
 
 IGraphlet* Planet::find_graphlet(float x, float y) {
+	ProfileScope profiling(this->get_profiler(), ProfilePhase::HitTest, this);
     IGraphlet* found = nullptr;
 
     if (this->head_graphlet != nullptr) {
@@ -1142,6 +1283,8 @@ void Planet::on_elapse(long long count, long long interval, long long uptime) {
 			GraphletInfo* info = GRAPHLET_INFO(child);
 
 			if (unsafe_graphlet_unmasked(info, this->mode)) {
+				ProfileScope profiling(this->get_profiler(), ProfilePhase::Update, child);
+
 				child->update(count, interval, uptime);
 			}
 			
@@ -1150,6 +1293,8 @@ void Planet::on_elapse(long long count, long long interval, long long uptime) {
     }
 
 	for (IPlanetDecorator* decorator : this->decorators) {
+		ProfileScope profiling(this->get_profiler(), ProfilePhase::Decorator, decorator);
+
 		decorator->update(count, interval, uptime);
 	}
 
@@ -1166,6 +1311,8 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 	float dsWidth = Width - max(transformX, 0.0F);
 	float dsHeight = Height - max(transformY, 0.0F);
 
+	this->recorded_graphlets.clear();
+
 	if (this->background != nullptr) {
 		ds->FillRoundedRectangle(0.0F, 0.0F, Width, Height,
 			this->background_corner_radius, this->background_corner_radius,
@@ -1173,6 +1320,8 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 	}
 
 	for (IPlanetDecorator* decorator : this->decorators) {
+		ProfileScope profiling(this->get_profiler(), ProfilePhase::Decorator, decorator);
+
 #ifdef _DEBUG
 		try {
 #endif
@@ -1187,6 +1336,7 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 	if (this->head_graphlet != nullptr) {
 		IGraphlet* child = this->head_graphlet;
 		float width, height;
+		bool visible;
 
 		do {
 			GraphletInfo* info = GRAPHLET_INFO(child);
@@ -1194,7 +1344,18 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 			if (unsafe_graphlet_unmasked(info, this->mode)) {
 				child->fill_extent(info->x, info->y, &width, &height);
 
-				if (((info->x < dsWidth) || ((info->x + width) > dsX)) && ((info->y < dsHeight) || ((info->y + height) > dsY))) {
+				info->painted_x = info->x;
+				info->painted_y = info->y;
+				info->painted_width = width;
+				info->painted_height = height;
+
+				visible = (((info->x < dsWidth) || ((info->x + width) > dsX)) && ((info->y < dsHeight) || ((info->y + height) > dsY)));
+
+				if (visible && this->culling) { // the rest of the cached surface is still valid
+					visible = !unsafe_graphlet_culled(info, width, height, this->cull_left, this->cull_top, this->cull_right, this->cull_bottom);
+				}
+
+				if (visible) {
 					if (info->rotation == 0.0F) {
 						layer = ds->CreateLayer(info->alpha, Rect(info->x, info->y, width, height));
 					} else {
@@ -1206,6 +1367,8 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 					}
 
 					for (IPlanetDecorator* decorator : this->decorators) {
+						ProfileScope profiling(this->get_profiler(), ProfilePhase::Decorator, decorator);
+
 #ifdef _DEBUG
 						try {
 #endif
@@ -1222,7 +1385,13 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 					try {
 #endif
 						if (child->ready()) {
-							child->draw(ds, info->x, info->y, width, height);
+							ProfileScope profiling(this->get_profiler(), ProfilePhase::Draw, child);
+
+							if (!this->display_lists_enabled) {
+								child->draw(ds, info->x, info->y, width, height);
+							} else if (unsafe_draw_graphlet_via_display_list(child, info, ds, width, height)) {
+								this->recorded_graphlets.push_back(child);
+							}
 						} else {
 							child->draw_progress(ds, info->x, info->y, width, height);
 						}
@@ -1234,6 +1403,8 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 #endif	
 
 					for (IPlanetDecorator* decorator : this->decorators) {
+						ProfileScope profiling(this->get_profiler(), ProfilePhase::Decorator, decorator);
+
 #ifdef _DEBUG
 						try {
 #endif
@@ -1266,6 +1437,8 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 #endif
 
 	for (IPlanetDecorator* decorator : this->decorators) {
+		ProfileScope profiling(this->get_profiler(), ProfilePhase::Decorator, decorator);
+
 #ifdef _DEBUG
 		try {
 #endif
@@ -1285,6 +1458,82 @@ void Planet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
 	}
 }
 
+bool Planet::take_damage(float* x, float* y, float* width, float* height) {
+	bool damaged = (this->damaged_all || (this->damage_right > this->damage_left));
+
+	if (this->damaged_all) {
+		SET_VALUES(x, 0.0F, y, 0.0F);
+		SET_VALUES(width, this->actual_width(), height, this->actual_height());
+	} else {
+		SET_VALUES(x, this->damage_left, y, this->damage_top);
+		SET_VALUES(width, this->damage_right - this->damage_left, height, this->damage_bottom - this->damage_top);
+	}
+
+	this->damaged_all = false;
+	this->damage_left = 0.0F;
+	this->damage_top = 0.0F;
+	this->damage_right = 0.0F;
+	this->damage_bottom = 0.0F;
+
+	return damaged;
+}
+
+void Planet::draw_damage(CanvasDrawingSession^ ds, float x, float y, float width, float height, float Width, float Height) {
+	// NOTE: the caller clips the session, graphlets out of the damage are just skipped
+	this->culling = true;
+	this->cull_left = x;
+	this->cull_top = y;
+	this->cull_right = x + width;
+	this->cull_bottom = y + height;
+
+	this->draw(ds, Width, Height);
+
+	this->culling = false;
+}
+
+void Planet::render(IDrawingContext* dc, float Width, float Height) {
+	/** NOTE
+	 * The portable counterpart of `Planet::draw()`, the planet only collects its graphlets,
+	 *  and the scene renders them with the same rules, see "drawing/scene.hpp".
+	 *
+	 * Graphlets that have not implemented `ISprite::render()` leave holes, so does the screen keyboard.
+	 */
+	DrawingScene scene;
+
+	if (this->background != nullptr) {
+		scene.set_background(drawing_color(this->background), this->background_corner_radius);
+	}
+
+	if (this->culling) {
+		scene.set_viewport(this->cull_left, this->cull_top, this->cull_right - this->cull_left, this->cull_bottom - this->cull_top);
+	}
+
+	scene.set_selection_color(drawing_color(Colours::Highlight));
+
+	for (IPlanetDecorator* decorator : this->decorators) {
+		scene.push_decorator(decorator);
+	}
+
+	if (this->head_graphlet != nullptr) {
+		IGraphlet* child = this->head_graphlet;
+		float width, height;
+
+		do {
+			GraphletInfo* info = GRAPHLET_INFO(child);
+
+			if (unsafe_graphlet_unmasked(info, this->mode)) {
+				child->fill_extent(info->x, info->y, &width, &height);
+				scene.push_item(DrawingSceneItem{ child, info->x, info->y, width, height,
+					info->rotation, info->alpha, child->ready(), info->selected });
+			}
+
+			child = info->next;
+		} while (child != this->head_graphlet);
+	}
+
+	scene.render(dc, Width, Height);
+}
+
 void Planet::draw_visible_selection(CanvasDrawingSession^ ds, float x, float y, float width, float height) {
 	static CanvasStrokeStyle^ dash = make_dash_stroke(CanvasDashStyle::Dash);
 
@@ -1292,7 +1541,7 @@ void Planet::draw_visible_selection(CanvasDrawingSession^ ds, float x, float y,
 }
 
 /*************************************************************************************************/
-IPlanet::IPlanet(Platform::String^ name) : caption(name) {}
+IPlanet::IPlanet(Platform::String^ name) : caption(name), profiler(nullptr) {}
 
 IPlanet::~IPlanet() {
 	if (this->info != nullptr) {
@@ -1429,10 +1678,57 @@ void IPlanet::leave_shared_section() {
 	this->section.unlock_shared();
 }
 
+void IPlanet::use_profiler(FrameProfiler* profiler) {
+	this->profiler = profiler;
+}
+
+FrameProfiler* IPlanet::get_profiler() {
+	return this->profiler;
+}
+
+void IPlanet::publish(IStateUpdate* update) {
+	this->publication.publish(update);
+}
+
+unsigned int IPlanet::apply_published_states() {
+	unsigned int count = 0U;
+
+	if (!this->publication.empty()) {
+		// NOTE: painting runs in the UI thread too, only writers that still set states directly may contend here.
+		this->enter_critical_section();
+		this->begin_update_sequence();
+		count = this->publication.apply();
+		this->end_update_sequence();
+		this->leave_critical_section();
+	}
+
+	return count;
+}
+
+void IPlanet::notify_graphlet_removed(IGraphlet* g) {
+	this->publication.purge(g);
+
+	if (this->profiler != nullptr) {
+		this->profiler->forget(g);
+	}
+
+	if (this->info != nullptr) {
+		this->info->master->on_graphlet_removed(this, g);
+	}
+}
+
 void IPlanet::collapse() {
+	this->publication.drop();
 	this->erase();
 }
 
+bool IPlanet::take_damage(float* x, float* y, float* width, float* height) {
+	SET_VALUES(x, 0.0F, y, 0.0F);
+	SET_VALUES(width, this->actual_width(), height, this->actual_height());
+
+	return true;
+}
+
 CanvasRenderTarget^ IPlanet::take_snapshot(float width, float height, CanvasSolidColorBrush^ bgcolor, float dpi) {
 	return this->take_snapshot(0.0F, 0.0F, width, height, bgcolor, dpi);
 }
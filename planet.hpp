@@ -1,10 +1,13 @@
 #pragma once
 
 #include <list>
+#include <vector>
 #include <shared_mutex>
 
 #include "credit.hpp"
+#include "publication.hpp"
 
+#include "arena.hpp"
 #include "universe.hxx"
 #include "decorator/decorator.hpp"
 
@@ -49,7 +52,21 @@ namespace WarGrey::SCADA {
 		virtual void notify_surface_ready() {}
 		virtual void update(long long count, long long interval, long long uptime) {}
 		virtual void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ args, float Width, float Height) {}
+		virtual void render(WarGrey::SCADA::IDrawingContext* dc, float Width, float Height) {}
 		virtual void collapse();
+
+	public: // NOTE: the damage is the region changed since it was taken last time, the whole planet by default.
+		virtual bool take_damage(float* x, float* y, float* width, float* height);
+		virtual void draw_damage(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds,
+			float x, float y, float width, float height, float Width, float Height) {
+			this->draw(ds, Width, Height);
+		}
+
+	public: // NOTE: planets that only build geometries and load assets in `construct()` and `load()` can be constructed in background.
+		virtual bool can_construct_in_background() { return false; }
+
+	public: // NOTE: invoked instead of `on_elapse` when the planet is hidden and its display only syncs data in background.
+		virtual void on_sync(long long count, long long interval, long long uptime) {}
 		
 	public:
 		virtual WarGrey::SCADA::IGraphlet* find_graphlet(float x, float y) = 0;
@@ -143,6 +160,33 @@ namespace WarGrey::SCADA {
 		void leave_critical_section();
 		void leave_shared_section();
 
+	public:
+		void use_profiler(WarGrey::SCADA::FrameProfiler* profiler);
+		WarGrey::SCADA::FrameProfiler* get_profiler();
+
+	public: // NOTE: publishing never waits for painting and can be done in any thread, see `publication.hpp`
+		void publish(WarGrey::SCADA::IStateUpdate* update);
+		unsigned int apply_published_states();
+
+		template<typename T>
+		void publish_value(WarGrey::SCADA::IValuelet<T>* g, T value
+			, WarGrey::SCADA::GraphletAnchor anchor = GraphletAnchor::LT, bool force_update = false) {
+			this->publish(new WarGrey::SCADA::ValueUpdate<T>(g, value, anchor, force_update));
+		}
+
+		template<typename State, typename Style>
+		void publish_state(WarGrey::SCADA::IStatelet<State, Style>* g, State state) {
+			this->publish(new WarGrey::SCADA::StateUpdate<State, Style>(g, state));
+		}
+
+		template<typename F>
+		void publish_action(F action) {
+			this->publish(new WarGrey::SCADA::ActionUpdate<F>(action));
+		}
+
+	protected: // NOTE: implementations should invoke it right before deleting a graphlet, so that no one keeps it after that
+		void notify_graphlet_removed(WarGrey::SCADA::IGraphlet* g);
+
 	public:
 		void save_logo(float logo_width = 0.0F, float logo_height = 0.0F, Platform::String^ path = nullptr, float dpi = 96.0);
 		
@@ -201,6 +245,8 @@ namespace WarGrey::SCADA {
 	private:
 		Platform::String^ caption;
 		std::shared_mutex section;
+		WarGrey::SCADA::StatePublication publication;
+		WarGrey::SCADA::FrameProfiler* profiler;
     };
 
 	private class Planet : public WarGrey::SCADA::IPlanet {
@@ -218,6 +264,16 @@ namespace WarGrey::SCADA {
     public:
         void construct(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float Width, float Height) override;
         void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float Width, float Height) override;
+		void render(WarGrey::SCADA::IDrawingContext* dc, float Width, float Height) override;
+
+	public:
+		/** NOTE
+		 * The damage is the union of where updated graphlets were painted last time and where they are now,
+		 *  planets that draw things other than graphlets should notify `nullptr` to damage the whole planet.
+		 */
+		bool take_damage(float* x, float* y, float* width, float* height) override;
+		void draw_damage(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds,
+			float x, float y, float width, float height, float Width, float Height) override;
 
     public: // learn C++ "Name Hiding"
 		using WarGrey::SCADA::IPlanet::fill_graphlet_location;
@@ -239,6 +295,17 @@ namespace WarGrey::SCADA {
 		void erase() override;
 		void size_cache_invalid();
 
+	public:
+		void fill_graphlets_arena_statistics(WarGrey::SCADA::ArenaStatistics* stats);
+
+	public:
+		/** NOTE
+		 * With display lists enabled, a graphlet is recorded into a command list when it is drawn
+		 *  and the recording is replayed until the graphlet calls `notify_updated()` or is moved or resized.
+		 */
+		void enable_display_lists(bool yes);
+		void fill_display_list_changes(std::vector<WarGrey::SCADA::IGraphlet*>* recorded); // graphlets recorded in the last frame
+
 	public:
 		virtual void set_background(Microsoft::Graphics::Canvas::Brushes::ICanvasBrush^ color, float corner_radius = 0.0F) override;
 		void cellophane(IGraphlet* g, float opacity) override;
@@ -324,11 +391,28 @@ namespace WarGrey::SCADA {
 
     private:
         std::list<WarGrey::SCADA::IPlanetDecorator*> decorators;
+        WarGrey::SCADA::Arena* graphlets_arena;
         WarGrey::SCADA::IGraphlet* head_graphlet;
 		WarGrey::SCADA::IGraphlet* focused_graphlet;
 		WarGrey::SCADA::IGraphlet* hovering_graphlet; // not used when PointerDeviceType::Touch
 		unsigned int mode;
 
+	private:
+		std::vector<WarGrey::SCADA::IGraphlet*> recorded_graphlets;
+		bool display_lists_enabled;
+
+	private:
+		float damage_left;
+		float damage_top;
+		float damage_right;
+		float damage_bottom;
+		bool damaged_all;
+		bool culling;
+		float cull_left;
+		float cull_top;
+		float cull_right;
+		float cull_bottom;
+
 	private:
 		WarGrey::SCADA::IKeyboard* keyboard;
 		WarGrey::SCADA::IKeyboard* numpad;
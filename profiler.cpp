@@ -0,0 +1,276 @@
+#include <ppltasks.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#include "profiler.hpp"
+#include "time.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Concurrency;
+
+using namespace Windows::Storage;
+
+static inline unsigned int histogram_bucket(long long duration) {
+	long long us = duration / 10LL;
+	unsigned int idx = 0U;
+
+	while ((us > 1LL) && (idx < (PROFILE_HISTOGRAM_BUCKETS - 1))) {
+		us >>= 1;
+		idx += 1U;
+	}
+
+	return idx;
+}
+
+static inline void histogram_add(ProfileHistogram& h, long long duration) {
+	h.count += 1ULL;
+	h.total += duration;
+	h.max = std::max(h.max, duration);
+	h.buckets[histogram_bucket(duration)] += 1U;
+}
+
+static void json_escape(std::string& out, const char* src) {
+	for (const char* ch = src; (*ch) != '\0'; ch++) {
+		switch (*ch) {
+		case '"': out.append("\\\""); break;
+		case '\\': out.append("\\\\"); break;
+		default: {
+			if ((unsigned char)(*ch) >= 0x20U) {
+				out.push_back(*ch);
+			}
+		}
+		}
+	}
+}
+
+/*************************************************************************************************/
+FrameProfiler::FrameProfiler(unsigned int trace_frames) : trace_frames(std::max(trace_frames, 1U)), enabled(true) {}
+
+long long FrameProfiler::now() {
+	return current_100nanoseconds();
+}
+
+void FrameProfiler::begin_frame(long long count) {
+	this->prune_forgotten_subjects();
+
+	if (this->enabled) {
+		while (this->frames.size() >= this->trace_frames) {
+			this->frames.pop_front();
+			this->frame_counts.pop_front();
+		}
+
+		this->frames.emplace_back();
+		this->frame_counts.push_back(count);
+	}
+}
+
+void FrameProfiler::record(ProfilePhase phase, const char* kind, const void* subject, long long start, long long duration) {
+	if (this->enabled) {
+		auto ckey = std::make_pair(phase, kind);
+		auto ikey = std::make_pair(phase, subject);
+		auto maybe_class = this->classes.find(ckey);
+		auto maybe_instance = this->instances.find(ikey);
+
+		if (maybe_class == this->classes.end()) {
+			ProfileHistogram h;
+
+			std::memset(&h, 0, sizeof(ProfileHistogram));
+			maybe_class = this->classes.insert(std::make_pair(ckey, h)).first;
+		}
+
+		if (maybe_instance == this->instances.end()) {
+			ProfileHistogram h;
+
+			std::memset(&h, 0, sizeof(ProfileHistogram));
+			maybe_instance = this->instances.insert(std::make_pair(ikey, h)).first;
+		}
+
+		histogram_add(maybe_class->second, duration);
+		histogram_add(maybe_instance->second, duration);
+
+		if (this->frames.empty()) { // samples out of any frame, say, hit tests before the first tick
+			this->begin_frame(0LL);
+		}
+
+		this->frames.back().push_back(ProfileEvent{ phase, kind, subject, start, duration });
+	}
+}
+
+void FrameProfiler::forget(const void* subject) {
+	std::unique_lock<std::mutex> lock(this->forgetting);
+
+	this->forgotten_subjects.push_back(subject);
+}
+
+void FrameProfiler::prune_forgotten_subjects() {
+	std::vector<const void*> subjects;
+
+	{
+		std::unique_lock<std::mutex> lock(this->forgetting);
+
+		subjects.swap(this->forgotten_subjects);
+	}
+
+	for (const void* subject : subjects) {
+		for (unsigned int phase = 0; phase < (unsigned int)ProfilePhase::_; phase++) {
+			this->instances.erase(std::make_pair(ProfilePhase(phase), subject));
+		}
+	}
+}
+
+void FrameProfiler::reset() {
+	this->classes.clear();
+	this->instances.clear();
+	this->frames.clear();
+	this->frame_counts.clear();
+}
+
+void FrameProfiler::fill_class_histogram(ProfilePhase phase, const char* kind, ProfileHistogram* histogram) {
+	auto maybe_class = this->classes.find(std::make_pair(phase, kind));
+
+	if (maybe_class == this->classes.end()) {
+		std::memset(histogram, 0, sizeof(ProfileHistogram));
+	} else {
+		(*histogram) = maybe_class->second;
+	}
+}
+
+void FrameProfiler::fill_instance_histogram(ProfilePhase phase, const void* subject, ProfileHistogram* histogram) {
+	auto maybe_instance = this->instances.find(std::make_pair(phase, subject));
+
+	if (maybe_instance == this->instances.end()) {
+		std::memset(histogram, 0, sizeof(ProfileHistogram));
+	} else {
+		(*histogram) = maybe_instance->second;
+	}
+}
+
+size_t FrameProfiler::fill_hotspots(std::vector<ProfileHotspot>* hotspots, size_t n) {
+	hotspots->clear();
+
+	for (auto it = this->classes.begin(); it != this->classes.end(); it++) {
+		hotspots->push_back(ProfileHotspot{ it->first.first, it->first.second, it->second });
+	}
+
+	std::sort(hotspots->begin(), hotspots->end(), [](const ProfileHotspot& lhs, const ProfileHotspot& rhs) {
+		return lhs.histogram.total > rhs.histogram.total;
+	});
+
+	if (hotspots->size() > n) {
+		hotspots->resize(n);
+	}
+
+	return hotspots->size();
+}
+
+std::string FrameProfiler::export_chrome_trace() {
+	std::string json("{\"traceEvents\":[");
+	char number[256];
+	bool first = true;
+
+	for (size_t idx = 0; idx < this->frames.size(); idx++) {
+		const std::vector<ProfileEvent>& events = this->frames[idx];
+
+		if (!events.empty()) {
+			long long frame_start = events.front().start;
+			long long frame_end = events.front().start + events.front().duration;
+
+			for (auto e = events.begin(); e != events.end(); e++) {
+				frame_start = std::min(frame_start, e->start);
+				frame_end = std::max(frame_end, e->start + e->duration);
+			}
+
+			// NOTE: timestamps of Chrome traces are in microseconds
+			snprintf(number, sizeof(number), "%s{\"name\":\"frame %lld\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":1}",
+				(first ? "" : ","), this->frame_counts[idx], double(frame_start) / 10.0, double(frame_end - frame_start) / 10.0);
+			json.append(number);
+			first = false;
+
+			for (auto e = events.begin(); e != events.end(); e++) {
+				json.append(",{\"name\":\"");
+				json_escape(json, profile_class_name(e->kind));
+				json.append("\",\"cat\":\"");
+				json.append(profile_phase_name(e->phase));
+				snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":1,\"args\":{\"subject\":\"%p\",\"class\":\"",
+					double(e->start) / 10.0, double(e->duration) / 10.0, e->subject);
+				json.append(number);
+				json_escape(json, e->kind);
+				json.append("\"}}");
+			}
+		}
+	}
+
+	json.append("],\"displayTimeUnit\":\"ms\"}");
+
+	return json;
+}
+
+void FrameProfiler::save_chrome_trace(Platform::String^ filename, Syslog* logger) {
+	std::string json = this->export_chrome_trace();
+	std::wstring wjson(json.begin(), json.end()); // NOTE: the trace is pure ASCII
+	Platform::String^ content = ref new Platform::String(wjson.c_str());
+	StorageFolder^ root = ApplicationData::Current->LocalFolder;
+
+	create_task(root->CreateFileAsync(filename, CreationCollisionOption::ReplaceExisting)).then([=](task<StorageFile^> creating) {
+		return create_task(FileIO::WriteTextAsync(creating.get(), content));
+	}).then([=](task<void> saving) {
+		try {
+			saving.get();
+
+			if (logger != nullptr) {
+				logger->log_message(Log::Notice, L"frame trace has been saved to %s\\%s", root->Path->Data(), filename->Data());
+			}
+		} catch (Platform::Exception^ e) {
+			if (logger != nullptr) {
+				logger->log_message(Log::Error, L"failed to save frame trace to %s: %s", filename->Data(), e->Message->Data());
+			}
+		}
+	});
+}
+
+/*************************************************************************************************/
+long long WarGrey::SCADA::profile_histogram_percentile(ProfileHistogram& histogram, double p) {
+	long long bound = 0LL;
+
+	if (histogram.count > 0ULL) {
+		unsigned long long rank = (unsigned long long)(double(histogram.count) * std::min(std::max(p, 0.0), 1.0));
+		unsigned long long seen = 0ULL;
+
+		for (unsigned int idx = 0; idx < PROFILE_HISTOGRAM_BUCKETS; idx++) {
+			seen += histogram.buckets[idx];
+
+			if (seen >= rank) {
+				bound = std::min((2LL << idx) * 10LL, histogram.max);
+				break;
+			}
+		}
+	}
+
+	return bound;
+}
+
+const char* WarGrey::SCADA::profile_class_name(const char* kind) {
+	// NOTE: MSVC names classes as "class WarGrey::SCADA::Labellet", and non-namespaced ones as "class Labellet"
+	const char* name = std::strrchr(kind, ':');
+
+	if (name == nullptr) {
+		name = std::strrchr(kind, ' ');
+	}
+
+	return ((name == nullptr) ? kind : (name + 1));
+}
+
+const char* WarGrey::SCADA::profile_phase_name(ProfilePhase phase) {
+	const char* name = "unknown";
+
+	switch (phase) {
+	case ProfilePhase::Update: name = "update"; break;
+	case ProfilePhase::Draw: name = "draw"; break;
+	case ProfilePhase::HitTest: name = "hit-test"; break;
+	case ProfilePhase::Decorator: name = "decorator"; break;
+	}
+
+	return name;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <typeinfo>
+
+#include "syslog.hpp"
+
+namespace WarGrey::SCADA {
+#define PROFILE_HISTOGRAM_BUCKETS 24
+
+	private enum class ProfilePhase { Update, Draw, HitTest, Decorator, _ };
+
+	/** NOTE
+	 * Durations are in 100ns, as what `current_100nanoseconds()` returns.
+	 * The bucket `i` counts samples in [2^i, 2^(i+1)) microseconds, samples shorter than 1us fall into the bucket `0`.
+	 */
+	private struct ProfileHistogram {
+		unsigned long long count;
+		long long total;
+		long long max;
+		unsigned int buckets[PROFILE_HISTOGRAM_BUCKETS];
+	};
+
+	private struct ProfileEvent {
+		WarGrey::SCADA::ProfilePhase phase;
+		const char* kind;
+		const void* subject;
+		long long start;
+		long long duration;
+	};
+
+	private struct ProfileHotspot {
+		WarGrey::SCADA::ProfilePhase phase;
+		const char* kind;
+		WarGrey::SCADA::ProfileHistogram histogram;
+	};
+
+	/** NOTE
+	 * Subjects are planets, graphlets and decorators, their kinds are the names of their dynamic classes.
+	 *
+	 * The profiler is not thread-safe, it is designed to be fed by the UI thread which updates and draws planets,
+	 *  except that subjects can be forgotten in any thread, they are pruned at the beginning of the next frame.
+	 * Only the last `trace_frames` frames are kept for tracing, histograms keep aggregating until `reset()`.
+	 */
+	private class FrameProfiler {
+	public:
+		FrameProfiler(unsigned int trace_frames = 120U);
+
+	public:
+		void begin_frame(long long count);
+		void record(WarGrey::SCADA::ProfilePhase phase, const char* kind, const void* subject, long long start, long long duration);
+		void forget(const void* subject); // say, the graphlet is removed
+		void reset();
+
+	public:
+		void set_enabled(bool yes) { this->enabled = yes; }
+		bool is_enabled() { return this->enabled; }
+		long long now();
+
+	public:
+		void fill_class_histogram(WarGrey::SCADA::ProfilePhase phase, const char* kind, WarGrey::SCADA::ProfileHistogram* histogram);
+		void fill_instance_histogram(WarGrey::SCADA::ProfilePhase phase, const void* subject, WarGrey::SCADA::ProfileHistogram* histogram);
+		size_t fill_hotspots(std::vector<WarGrey::SCADA::ProfileHotspot>* hotspots, size_t n);
+
+	public:
+		std::string export_chrome_trace();
+		void save_chrome_trace(Platform::String^ filename, WarGrey::SCADA::Syslog* logger = nullptr); // into the local folder
+
+	private:
+		void prune_forgotten_subjects();
+
+	private:
+		std::map<std::pair<WarGrey::SCADA::ProfilePhase, const char*>, WarGrey::SCADA::ProfileHistogram> classes;
+		std::map<std::pair<WarGrey::SCADA::ProfilePhase, const void*>, WarGrey::SCADA::ProfileHistogram> instances;
+		std::deque<std::vector<WarGrey::SCADA::ProfileEvent>> frames;
+		std::deque<long long> frame_counts;
+		std::vector<const void*> forgotten_subjects;
+		std::mutex forgetting;
+		unsigned int trace_frames;
+		bool enabled;
+	};
+
+	private class ProfileScope {
+	public:
+		template<class S>
+		ProfileScope(WarGrey::SCADA::FrameProfiler* profiler, WarGrey::SCADA::ProfilePhase phase, S* subject)
+			: profiler(profiler), phase(phase), kind(nullptr), subject(subject), start(0LL) {
+			if ((this->profiler != nullptr) && this->profiler->is_enabled()) {
+				this->kind = typeid(*subject).name();
+				this->start = this->profiler->now();
+			}
+		}
+
+		~ProfileScope() noexcept {
+			if (this->kind != nullptr) {
+				this->profiler->record(this->phase, this->kind, this->subject, this->start, this->profiler->now() - this->start);
+			}
+		}
+
+	private:
+		WarGrey::SCADA::FrameProfiler* profiler;
+		WarGrey::SCADA::ProfilePhase phase;
+		const char* kind;
+		const void* subject;
+		long long start;
+	};
+
+	long long profile_histogram_percentile(WarGrey::SCADA::ProfileHistogram& histogram, double p);
+	const char* profile_class_name(const char* kind); // without the keyword and namespaces
+	const char* profile_phase_name(WarGrey::SCADA::ProfilePhase phase);
+}
@@ -0,0 +1,103 @@
+#include "publication.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+StatePublication::StatePublication() : pending(0U) {}
+
+StatePublication::~StatePublication() {
+	this->drop();
+}
+
+void StatePublication::publish(IStateUpdate* update) {
+	IGraphlet* target = update->target();
+	IStateUpdate* coalesced = nullptr;
+
+	{
+		std::unique_lock<std::mutex> lock(this->section);
+
+		if (target == nullptr) {
+			this->updates.push_back(update);
+		} else {
+			std::map<std::type_index, size_t>& kinds = this->slots[target];
+			auto maybe_slot = kinds.find(std::type_index(typeid(*update)));
+
+			if (maybe_slot != kinds.end()) {
+				coalesced = this->updates[maybe_slot->second];
+				this->updates[maybe_slot->second] = update;
+			} else {
+				kinds.insert(std::make_pair(std::type_index(typeid(*update)), this->updates.size()));
+				this->updates.push_back(update);
+			}
+		}
+
+		this->pending.store(this->updates.size(), std::memory_order_release);
+	}
+
+	if (coalesced != nullptr) {
+		delete coalesced;
+	}
+}
+
+unsigned int StatePublication::apply() {
+	std::vector<IStateUpdate*> updates;
+	unsigned int count = 0U;
+
+	this->take(&updates);
+
+	for (IStateUpdate* update : updates) {
+		if (update != nullptr) {
+			update->apply();
+			delete update;
+			count += 1U;
+		}
+	}
+
+	return count;
+}
+
+void StatePublication::purge(IGraphlet* target) {
+	std::vector<IStateUpdate*> purged;
+
+	if (this->pending.load(std::memory_order_acquire) > 0U) {
+		std::unique_lock<std::mutex> lock(this->section);
+		auto maybe_kinds = this->slots.find(target);
+
+		if (maybe_kinds != this->slots.end()) {
+			for (auto slot = maybe_kinds->second.begin(); slot != maybe_kinds->second.end(); slot++) {
+				purged.push_back(this->updates[slot->second]);
+				this->updates[slot->second] = nullptr;
+			}
+
+			this->slots.erase(maybe_kinds);
+		}
+	}
+
+	for (IStateUpdate* update : purged) {
+		delete update;
+	}
+}
+
+void StatePublication::drop() {
+	std::vector<IStateUpdate*> updates;
+
+	this->take(&updates);
+
+	for (IStateUpdate* update : updates) {
+		if (update != nullptr) {
+			delete update;
+		}
+	}
+}
+
+bool StatePublication::empty() {
+	return (this->pending.load(std::memory_order_acquire) == 0U);
+}
+
+void StatePublication::take(std::vector<IStateUpdate*>* updates) {
+	std::unique_lock<std::mutex> lock(this->section);
+
+	updates->swap(this->updates);
+	this->slots.clear();
+	this->pending.store(0U, std::memory_order_release);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <typeindex>
+
+#include "graphlet/primitive.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Data sources publish states instead of setting them, the UI thread applies them at the next frame boundary.
+	 *
+	 * Publishing only takes a short lock that is never held while applying, so that it never waits for painting;
+	 *  and the frame boundary takes all pending updates at once, so that painting never sees a half-written state.
+	 *
+	 * Updates are keyed by their graphlets and their kinds, say, `ValueUpdate<T>` or `StateUpdate<T>`,
+	 *  a pending update is replaced by the latest one of the same key, which takes the position of the first one,
+	 *  so that the pending updates are bounded by the number of graphlets no matter how long the timer idles.
+	 * Actions have no target, they are never coalesced.
+	 *
+	 * Keys are applied in the order of their first publishing since the last frame boundary, each with its latest update,
+	 *  and pending updates of a graphlet are purged when it is removed.
+	 */
+	private class IStateUpdate abstract {
+	public:
+		virtual ~IStateUpdate() noexcept {}
+
+	public:
+		virtual void apply() = 0;
+		virtual WarGrey::SCADA::IGraphlet* target() { return nullptr; }
+	};
+
+	template<typename T>
+	private class ValueUpdate : public WarGrey::SCADA::IStateUpdate {
+	public:
+		ValueUpdate(WarGrey::SCADA::IValuelet<T>* target, T value, WarGrey::SCADA::GraphletAnchor anchor, bool force_update)
+			: self(target), value(value), anchor(anchor), force_update(force_update) {}
+
+	public:
+		void apply() override {
+			this->self->set_value(this->value, this->anchor, this->force_update);
+		}
+
+		WarGrey::SCADA::IGraphlet* target() override {
+			return this->self;
+		}
+
+	private:
+		WarGrey::SCADA::IValuelet<T>* self;
+		T value;
+		WarGrey::SCADA::GraphletAnchor anchor;
+		bool force_update;
+	};
+
+	template<typename State, typename Style>
+	private class StateUpdate : public WarGrey::SCADA::IStateUpdate {
+	public:
+		StateUpdate(WarGrey::SCADA::IStatelet<State, Style>* target, State state) : self(target), state(state) {}
+
+	public:
+		void apply() override {
+			this->self->set_state(this->state);
+		}
+
+		WarGrey::SCADA::IGraphlet* target() override {
+			return this->self;
+		}
+
+	private:
+		WarGrey::SCADA::IStatelet<State, Style>* self;
+		State state;
+	};
+
+	template<typename F>
+	private class ActionUpdate : public WarGrey::SCADA::IStateUpdate {
+	public:
+		ActionUpdate(F action) : action(action) {}
+
+	public:
+		void apply() override {
+			this->action();
+		}
+
+	private:
+		F action;
+	};
+
+	private class StatePublication {
+	public:
+		~StatePublication() noexcept;
+		StatePublication();
+
+	public:
+		void publish(WarGrey::SCADA::IStateUpdate* update); // any thread
+		unsigned int apply();                               // the UI thread
+		void purge(WarGrey::SCADA::IGraphlet* target);      // before `target` is deleted
+		void drop();
+		bool empty();
+
+	private:
+		void take(std::vector<WarGrey::SCADA::IStateUpdate*>* updates);
+
+	private:
+		std::vector<WarGrey::SCADA::IStateUpdate*> updates; // purged ones are `nullptr`
+		std::map<WarGrey::SCADA::IGraphlet*, std::map<std::type_index, size_t>> slots; // target => kind => index of `updates`
+		std::atomic<size_t> pending;
+		std::mutex section;
+	};
+}
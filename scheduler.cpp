@@ -0,0 +1,173 @@
+#include <chrono>
+#include <algorithm>
+
+#include "scheduler.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+long long MonotonicFrameClock::now() {
+	auto timepoint = std::chrono::steady_clock::now().time_since_epoch();
+
+	return std::chrono::duration_cast<std::chrono::duration<long long, std::ratio<1, 10000000>>>(timepoint).count();
+}
+
+/*************************************************************************************************/
+FrameScheduler::FrameScheduler(IFrameListener* target, IFrameClock* clock)
+	: target(target), clock(clock), own_clock(clock == nullptr), active(false)
+	, count(0LL), interval(0LL), uptime(0LL), deadline(0LL) {
+	if (this->clock == nullptr) {
+		this->clock = new MonotonicFrameClock();
+	}
+
+	this->reset_statistics();
+}
+
+FrameScheduler::~FrameScheduler() {
+	if (this->own_clock) {
+		delete this->clock;
+	}
+}
+
+void FrameScheduler::start(long long interval) {
+	this->interval = std::max(interval, 1LL);
+	this->count = 1LL;
+	this->uptime = this->interval;
+	this->deadline = this->clock->now() + this->interval;
+	this->active = true;
+}
+
+void FrameScheduler::retune(long long interval) {
+	this->interval = std::max(interval, 1LL);
+
+	if (this->active) {
+		// the pending deadline was planned with the old interval
+		this->deadline = this->clock->now() + this->interval;
+	}
+}
+
+void FrameScheduler::stop() {
+	this->active = false;
+}
+
+bool FrameScheduler::running() {
+	return this->active;
+}
+
+long long FrameScheduler::get_interval() {
+	return this->interval;
+}
+
+long long FrameScheduler::step() {
+	long long now = this->clock->now();
+	long long next_tick = this->interval;
+
+	if (this->active) {
+		if (now >= this->deadline) {
+			long long lateness = now - this->deadline;
+			long long dropped = lateness / this->interval;
+			long long elapsed0, elapsed;
+
+			if (dropped > 0LL) {
+				this->target->on_frame_dropped(this->count, dropped, this->interval, this->uptime);
+
+				this->count += dropped;
+				this->uptime += this->interval * dropped;
+				this->deadline += this->interval * dropped;
+				lateness -= this->interval * dropped;
+				this->statistics.dropped += dropped;
+			}
+
+			elapsed0 = this->clock->now();
+			this->target->on_elapse(this->count, this->interval, this->uptime);
+			elapsed = this->clock->now() - elapsed0;
+			this->target->on_elapse(this->count, this->interval, this->uptime, elapsed);
+
+			this->statistics.frames += 1LL;
+			this->statistics.total_jitter += lateness;
+			this->statistics.max_jitter = std::max(this->statistics.max_jitter, lateness);
+			this->statistics.total_elapsed += elapsed;
+			this->statistics.max_elapsed = std::max(this->statistics.max_elapsed, elapsed);
+
+			if (elapsed > this->interval) {
+				this->statistics.overruns += 1LL;
+			}
+
+			this->count += 1LL;
+			this->uptime += this->interval;
+			this->deadline += this->interval;
+
+			now = this->clock->now();
+		}
+
+		next_tick = std::max(this->deadline - now, 0LL);
+	}
+
+	return next_tick;
+}
+
+void FrameScheduler::fill_statistics(FrameStatistics* stats) {
+	if (stats != nullptr) {
+		(*stats) = this->statistics;
+	}
+}
+
+void FrameScheduler::reset_statistics() {
+	this->statistics = FrameStatistics();
+}
+
+/*************************************************************************************************/
+ManualFrameDriver::ManualFrameDriver(IFrameListener* target, long long timepoint0) {
+	this->manual_clock = new ManualFrameClock(timepoint0);
+	this->frame_scheduler = new FrameScheduler(target, this->manual_clock);
+}
+
+ManualFrameDriver::~ManualFrameDriver() {
+	delete this->frame_scheduler;
+	delete this->manual_clock;
+}
+
+void ManualFrameDriver::start(long long interval) {
+	this->frame_scheduler->start(interval);
+}
+
+void ManualFrameDriver::stall(long long span) {
+	this->manual_clock->advance(span);
+}
+
+void ManualFrameDriver::run_until(long long timepoint) {
+	long long span = 0LL;
+
+	while (this->frame_scheduler->running() && (this->manual_clock->now() + span <= timepoint)) {
+		this->manual_clock->advance(span);
+		span = this->frame_scheduler->step();
+	}
+
+	if (this->manual_clock->now() < timepoint) {
+		this->manual_clock->advance(timepoint - this->manual_clock->now());
+	}
+}
+
+void ManualFrameDriver::run_frames(long long count) {
+	FrameStatistics stats;
+	long long goal, span;
+
+	this->frame_scheduler->fill_statistics(&stats);
+	goal = stats.frames + count;
+	span = 0LL;
+
+	// NOTE: the clock is left where the last frame ends rather than at the next deadline
+	while (this->frame_scheduler->running() && (stats.frames < goal)) {
+		this->manual_clock->advance(span);
+		span = this->frame_scheduler->step();
+		this->frame_scheduler->fill_statistics(&stats);
+	}
+}
+
+FrameScheduler* ManualFrameDriver::scheduler() {
+	return this->frame_scheduler;
+}
+
+ManualFrameClock* ManualFrameDriver::clock() {
+	return this->manual_clock;
+}
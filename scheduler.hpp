@@ -0,0 +1,109 @@
+#pragma once
+
+namespace WarGrey::SCADA {
+	class IFrameListener {
+	public:
+		virtual ~IFrameListener() noexcept {}
+
+	public:
+		virtual void on_elapse(long long count, long long interval, long long uptime) = 0;
+		virtual void on_elapse(long long count, long long interval, long long uptime, long long span) {}
+		virtual void on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) {}
+	};
+
+	class IFrameClock {
+	public:
+		virtual ~IFrameClock() noexcept {}
+
+	public:
+		virtual long long now() = 0; // in 100ns
+	};
+
+	class MonotonicFrameClock : public WarGrey::SCADA::IFrameClock {
+	public:
+		long long now() override;
+	};
+
+	class ManualFrameClock : public WarGrey::SCADA::IFrameClock {
+	public:
+		ManualFrameClock(long long timepoint0 = 0LL) : timepoint(timepoint0) {}
+
+	public:
+		long long now() override { return this->timepoint; }
+		void advance(long long span) { this->timepoint += span; }
+
+	private:
+		long long timepoint;
+	};
+
+	struct FrameStatistics {
+		long long frames;
+		long long dropped;
+		long long overruns;
+		long long max_jitter;    // in 100ns, how late a frame starts after its deadline
+		long long total_jitter;
+		long long max_elapsed;   // in 100ns, how long a frame takes
+		long long total_elapsed;
+	};
+
+	/** NOTE
+	 * The scheduler only decides whether a deadline has been reached and tells how far the next one is,
+	 *  whoever owns it has to call `step()` again after that span, the `Timer` does it with a `DispatcherTimer`.
+	 * Nothing here depends on the Windows Runtime, so that it can be driven headless by the `ManualFrameDriver`.
+	 */
+	class FrameScheduler {
+	public:
+		virtual ~FrameScheduler() noexcept;
+		FrameScheduler(WarGrey::SCADA::IFrameListener* target, WarGrey::SCADA::IFrameClock* clock = nullptr);
+
+	public:
+		void start(long long interval);
+		void retune(long long interval); // keeps the count and uptime
+		void stop();
+		bool running();
+		long long step(); // returns the span to the next deadline
+		long long get_interval();
+
+	public:
+		void fill_statistics(WarGrey::SCADA::FrameStatistics* stats);
+		void reset_statistics();
+
+	private:
+		WarGrey::SCADA::IFrameListener* target;
+		WarGrey::SCADA::IFrameClock* clock;
+		WarGrey::SCADA::FrameStatistics statistics;
+		bool own_clock;
+		bool active;
+
+	private:
+		long long count;
+		long long interval;
+		long long uptime;
+		long long deadline;
+	};
+
+	/** NOTE
+	 * Steps a scheduler on a manual clock, jumping straight to every deadline.
+	 * Listeners may `advance()` the `clock()` inside `on_elapse()` to pretend that frames take time,
+	 *  and `stall()` pretends that the owner did not get the chance to step for a while.
+	 */
+	class ManualFrameDriver {
+	public:
+		virtual ~ManualFrameDriver() noexcept;
+		ManualFrameDriver(WarGrey::SCADA::IFrameListener* target, long long timepoint0 = 0LL);
+
+	public:
+		void start(long long interval);
+		void stall(long long span);
+		void run_until(long long timepoint);
+		void run_frames(long long count);
+
+	public:
+		WarGrey::SCADA::FrameScheduler* scheduler();
+		WarGrey::SCADA::ManualFrameClock* clock();
+
+	private:
+		WarGrey::SCADA::ManualFrameClock* manual_clock;
+		WarGrey::SCADA::FrameScheduler* frame_scheduler;
+	};
+}
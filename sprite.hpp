@@ -3,8 +3,10 @@
 #include "forward.hpp"
 #include "syslog.hpp"
 
+#include "drawing/scene.hpp"
+
 namespace WarGrey::SCADA {
-	private class ISprite abstract {
+	private class ISprite abstract : public WarGrey::SCADA::IDrawingRenderable {
 	public:
 		virtual void sprite() {}           // pseudo constructor for special derived classes before constructing
 		virtual void sprite_construct() {} // pseudo constructor for special derived classes after constructing
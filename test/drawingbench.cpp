@@ -0,0 +1,80 @@
+﻿#include <algorithm>
+
+#include "test/drawingbench.hpp"
+#include "test/drawingload.hpp"
+
+#include "drawing/rasterizer.hpp"
+#include "drawing/win2d.hpp"
+
+#include "graphlet/textlet.hpp"
+
+#include "time.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::UI;
+
+static inline double elapsed_ms(long long start) {
+	return double(current_100nanoseconds() - start) / 10000.0;
+}
+
+/*************************************************************************************************/
+DrawingBenchmark::DrawingBenchmark(unsigned int frames, float width, float height)
+	: Planet("Drawing Benchmark"), frames(std::max(frames, 1U)), frame_width(width), frame_height(height) {}
+
+DrawingBenchmark::~DrawingBenchmark() {}
+
+void DrawingBenchmark::load(CanvasCreateResourcesReason reason, float width, float height) {
+	DrawingWorkload workload(this->frame_width, this->frame_height);
+	CanvasRenderTarget^ target = ref new CanvasRenderTarget(CanvasDevice::GetSharedDevice(), this->frame_width, this->frame_height, 96.0F);
+	SoftwareDrawingContext sdc((unsigned int)(this->frame_width), (unsigned int)(this->frame_height));
+	Win2DDrawingContext wdc;
+	double win2d_cost = 0.0;
+	double win2d_max = 0.0;
+	double software_cost = 0.0;
+	double software_max = 0.0;
+	double flush_cost = 0.0;
+
+	for (unsigned int frame = 0; frame < this->frames; frame++) {
+		long long start = current_100nanoseconds();
+		double cost = 0.0;
+
+		{ // the session is closed at the end of the scope, then the commands are submitted to the device
+			CanvasDrawingSession^ ds = target->CreateDrawingSession();
+
+			wdc.attach(ds);
+			workload.render(&wdc, frame);
+			wdc.attach(nullptr);
+		}
+
+		cost = elapsed_ms(start);
+		win2d_cost += cost;
+		win2d_max = std::max(win2d_max, cost);
+	}
+
+	{ // NOTE: submitted commands are not necessarily executed, reading a pixel back waits for the device to finish
+		long long start = current_100nanoseconds();
+
+		target->GetPixelColors(0, 0, 1, 1);
+		flush_cost = elapsed_ms(start);
+	}
+
+	for (unsigned int frame = 0; frame < this->frames; frame++) {
+		long long start = current_100nanoseconds();
+		double cost = 0.0;
+
+		workload.render(&sdc, frame);
+
+		cost = elapsed_ms(start);
+		software_cost += cost;
+		software_max = std::max(software_max, cost);
+	}
+
+	this->insert(new Labellet(L"Win2D: %.3fms per %.0fx%.0f frame, %.3fms at most, %u frames, %.3fms to wait for the device",
+		win2d_cost / double(this->frames), this->frame_width, this->frame_height, win2d_max, this->frames, flush_cost), 0.0F, 0.0F);
+
+	this->insert(new Labellet(L"Software: %.3fms per %.0fx%.0f frame, %.3fms at most, %.2f times as long as Win2D",
+		software_cost / double(this->frames), this->frame_width, this->frame_height, software_max,
+		software_cost / std::max(win2d_cost + flush_cost, 0.001)), 0.0F, 24.0F);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "planet.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Renders the same `DrawingWorkload` with the Win2D and the software drawing contexts,
+	 *  the software one is also checked off-device, see "test/headless/rasterizer.cpp".
+	 */
+	private class DrawingBenchmark : public WarGrey::SCADA::Planet {
+	public:
+		~DrawingBenchmark() noexcept;
+		DrawingBenchmark(unsigned int frames = 120U, float width = 1280.0F, float height = 720.0F);
+
+	public:
+		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
+
+	private:
+		unsigned int frames;
+		float frame_width;
+		float frame_height;
+	};
+}
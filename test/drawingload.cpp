@@ -0,0 +1,96 @@
+﻿#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "test/drawingload.hpp"
+
+using namespace WarGrey::SCADA;
+
+/*************************************************************************************************/
+DrawingWorkload::DrawingWorkload(float width, float height, unsigned int shapes, unsigned int points)
+	: width(width), height(height) {
+	float trend_height = height * 0.25F;
+	float dx = width / float(std::max(points, 2U) - 1U);
+
+	shapes = std::max(shapes, 1U);
+	this->columns = 1U;
+
+	// NOTE: the grid of shapes is kept above the trend
+	while (float((shapes + this->columns - 1U) / this->columns) * (width / float(this->columns)) > height - trend_height) {
+		this->columns += 1U;
+	}
+
+	this->cell_size = width / float(this->columns);
+
+	for (unsigned int idx = 0; idx < shapes; idx++) {
+		std::shared_ptr<DrawingPath> shape = std::make_shared<DrawingPath>();
+		float inset = this->cell_size * 0.15F;
+		float size = this->cell_size - inset * 2.0F;
+
+		switch (idx % 3) {
+		case 0: shape->add_rounded_rectangle(inset, inset, size, size, size * 0.2F, size * 0.2F); break;
+		case 1: shape->add_ellipse(this->cell_size * 0.5F, this->cell_size * 0.5F, size * 0.5F, size * 0.4F); break;
+		default: {
+			DrawingPoint arrow[] = {
+				DrawingPoint{ inset, inset + size * 0.3F }, DrawingPoint{ inset + size * 0.6F, inset + size * 0.3F },
+				DrawingPoint{ inset + size * 0.6F, inset }, DrawingPoint{ inset + size, inset + size * 0.5F },
+				DrawingPoint{ inset + size * 0.6F, inset + size }, DrawingPoint{ inset + size * 0.6F, inset + size * 0.7F },
+				DrawingPoint{ inset, inset + size * 0.7F } };
+
+			shape->add_polygon(arrow, sizeof(arrow) / sizeof(DrawingPoint));
+		}
+		}
+
+		shape->set_persistent(true);
+		this->shapes.push_back(shape);
+	}
+
+	this->trend = std::make_shared<DrawingPath>();
+	for (unsigned int idx = 0; idx < points; idx++) {
+		float y = height - trend_height * (0.5F + 0.4F * std::sin(float(idx) * 0.05F) * std::cos(float(idx) * 0.003F));
+
+		if (idx == 0) {
+			this->trend->move_to(0.0F, y);
+		} else {
+			this->trend->line_to(dx * float(idx), y);
+		}
+	}
+	this->trend->set_persistent(true);
+
+	this->frame_border = std::make_shared<DrawingPath>();
+	this->frame_border->add_rectangle(0.5F, 0.5F, width - 1.0F, height - 1.0F);
+	this->frame_border->set_persistent(true);
+}
+
+void DrawingWorkload::render(IDrawingContext* dc, unsigned int frame) {
+	DrawingFont font = { L"Consolas", this->cell_size * 0.2F, false };
+	DrawingColor background = drawing_color(0x1E1E1EU);
+	DrawingColor foreground = drawing_color(0xF8F8FFU);
+	DrawingColor border = drawing_color(0x708090U);
+
+	dc->clear(background);
+
+	// NOTE: shapes spin with frames, so that the transforms are not the same in every frame
+	for (size_t idx = 0; idx < this->shapes.size(); idx++) {
+		float x = this->cell_size * float(idx % this->columns);
+		float y = this->cell_size * float(idx / this->columns);
+		float c = this->cell_size * 0.5F;
+		DrawingColor color = drawing_color((unsigned int)(idx * 0x9E3779U) & 0xFFFFFFU, 0.85F);
+		std::wstring label = std::to_wstring(idx);
+
+		dc->push_transform(drawing_multiply(drawing_rotation(float(frame + idx) * 0.02F, c, c), drawing_translation(x, y)));
+		dc->fill_path(*this->shapes[idx], color);
+		dc->stroke_path(*this->shapes[idx], border, 1.0F);
+		dc->pop_transform();
+
+		dc->draw_text(label, x + c - dc->measure_text(label, font).width * 0.5F, y + c, font, foreground);
+	}
+
+	dc->push_layer(DrawingRect{ 0.0F, this->height * 0.75F, this->width, this->height * 0.25F }, 0.8F);
+	dc->push_transform(drawing_translation(-float(frame % 64U), 0.0F));
+	dc->stroke_path(*this->trend, drawing_color(0x32CD32U), 1.5F);
+	dc->pop_transform();
+	dc->pop_layer();
+
+	dc->stroke_path(*this->frame_border, border, 1.0F);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+
+#include "drawing/context.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * A dashboard-like frame made of the primitives that graphlets actually use,
+	 *  it is shared by the Win2D benchmark planet and the headless harness so that both time the same thing.
+	 *
+	 * Paths are built once and marked persistent, as graphlets do.
+	 */
+	class DrawingWorkload {
+	public:
+		DrawingWorkload(float width, float height, unsigned int shapes = 120U, unsigned int points = 1200U);
+
+	public:
+		void render(WarGrey::SCADA::IDrawingContext* dc, unsigned int frame);
+
+	private:
+		std::vector<std::shared_ptr<WarGrey::SCADA::DrawingPath>> shapes;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> trend;
+		std::shared_ptr<WarGrey::SCADA::DrawingPath> frame_border;
+		float width;
+		float height;
+		float cell_size;
+		unsigned int columns;
+	};
+}
@@ -0,0 +1,131 @@
+/** NOTE
+ * Headless check of the `FrameScheduler`, it does not belong to the app and runs off-device:
+ *
+ *   g++ -std=c++17 -I../.. framescheduler.cpp ../../scheduler.cpp -o framescheduler
+ *
+ * Every case runs on a `ManualFrameDriver`, so the results are the same on every run.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const long long interval60 = 166667LL; // 1/60s in 100ns
+
+class FrameRecorder : public IFrameListener {
+public:
+	FrameRecorder(ManualFrameClock* clock = nullptr) : clock(clock), cost(0LL), dropped(0LL) {}
+
+public:
+	void on_elapse(long long count, long long interval, long long uptime) override {
+		this->counts.push_back(count);
+		this->uptimes.push_back(uptime);
+
+		if (this->clock != nullptr) {
+			this->clock->advance(this->cost);
+		}
+	}
+
+	void on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) override {
+		this->dropped += dropped;
+	}
+
+public:
+	ManualFrameClock* clock;
+	std::vector<long long> counts;
+	std::vector<long long> uptimes;
+	long long cost;
+	long long dropped;
+};
+
+static int failures = 0;
+
+static void check(bool okay, const char* what) {
+	if (!okay) {
+		failures += 1;
+	}
+
+	printf("[%s] %s\n", (okay ? "PASS" : "FAIL"), what);
+}
+
+static void check_steady_frames() {
+	FrameRecorder recorder;
+	ManualFrameDriver driver(&recorder);
+	FrameStatistics stats;
+	bool sequential = true;
+
+	driver.start(interval60);
+	driver.run_until(interval60 * 60LL);
+	driver.scheduler()->fill_statistics(&stats);
+
+	for (size_t idx = 0; idx < recorder.counts.size(); idx++) {
+		if ((recorder.counts[idx] != (long long)(idx + 1)) || (recorder.uptimes[idx] != interval60 * (long long)(idx + 1))) {
+			sequential = false;
+		}
+	}
+
+	check(recorder.counts.size() == 60U, "one second at 60fps runs 60 frames");
+	check(sequential, "counts and uptimes follow the deadlines");
+	check((stats.dropped == 0LL) && (stats.max_jitter == 0LL) && (stats.overruns == 0LL), "an idle driver neither drops nor jitters");
+}
+
+static void check_stalled_frames() {
+	FrameRecorder recorder;
+	ManualFrameDriver driver(&recorder);
+	FrameStatistics stats;
+
+	driver.start(interval60);
+	driver.run_frames(10LL);
+	driver.stall(interval60 * 7LL / 2LL);
+	driver.run_frames(1LL);
+	driver.scheduler()->fill_statistics(&stats);
+
+	check(recorder.dropped == 2LL, "stalling past three deadlines drops the first two of them");
+	check(recorder.counts.back() == 13LL, "dropped frames still count");
+	check(stats.max_jitter == interval60 / 2LL, "the third one runs half an interval late");
+}
+
+static void check_overrun_frames() {
+	FrameRecorder recorder;
+	ManualFrameDriver driver(&recorder);
+	FrameStatistics stats;
+
+	recorder.clock = driver.clock();
+
+	driver.start(interval60);
+	driver.run_frames(5LL);
+	recorder.cost = interval60 * 2LL;
+	driver.run_frames(1LL);
+	recorder.cost = 0LL;
+	driver.run_frames(1LL);
+	driver.scheduler()->fill_statistics(&stats);
+
+	check(stats.overruns == 1LL, "a frame that takes two intervals overruns");
+	check(stats.max_elapsed == interval60 * 2LL, "the frame cost is measured on the injected clock");
+	check(recorder.dropped == 1LL, "the frame that the overrun covers is dropped");
+}
+
+static void check_retuned_frames() {
+	FrameRecorder recorder;
+	ManualFrameDriver driver(&recorder);
+
+	driver.start(interval60);
+	driver.run_until(interval60 * 30LL);
+	driver.scheduler()->retune(interval60 * 2LL);
+	driver.run_until(interval60 * 90LL);
+
+	check(recorder.counts.size() == 60U, "retuning to 30fps halves the rate but keeps the count");
+	check(recorder.counts.back() == 60LL, "the count goes on after retuning");
+}
+
+int main(int argc, char* argv[]) {
+	check_steady_frames();
+	check_stalled_frames();
+	check_overrun_frames();
+	check_retuned_frames();
+
+	return ((failures == 0) ? 0 : 1);
+}
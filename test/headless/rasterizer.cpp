@@ -0,0 +1,185 @@
+/** NOTE
+ * Headless checks of the `SoftwareDrawingContext`, it does not belong to the app and runs off-device:
+ *
+ *   g++ -std=c++17 -O2 -I../.. rasterizer.cpp ../drawingload.cpp ../../drawing/context.cpp ../../drawing/rasterizer.cpp -o rasterizer
+ *   ./rasterizer [frames] [last-frame.ppm]
+ *
+ * Golden pixels are worked out by hand from the geometry rather than captured from a previous run,
+ *  channels may be off by one since coverage is accumulated in floats.
+ * The timing part renders the same `DrawingWorkload` as the `DrawingBenchmark` planet does with Win2D.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+
+#include "drawing/rasterizer.hpp"
+#include "test/drawingload.hpp"
+
+using namespace WarGrey::SCADA;
+
+static const unsigned int black = 0xFF000000U;
+static const unsigned int red = 0xFFFF0000U;
+static const unsigned int white = 0xFFFFFFFFU;
+
+static int failures = 0;
+
+static bool same_pixel(unsigned int px, unsigned int golden) {
+	bool okay = true;
+
+	for (unsigned int shift = 0; shift < 32U; shift += 8U) {
+		int a = int((px >> shift) & 0xFFU);
+		int b = int((golden >> shift) & 0xFFU);
+
+		if (std::abs(a - b) > 1) {
+			okay = false;
+		}
+	}
+
+	return okay;
+}
+
+static void check_pixel(SoftwareDrawingContext* dc, unsigned int x, unsigned int y, unsigned int golden, const char* what) {
+	unsigned int px = dc->pixel(x, y);
+	bool okay = same_pixel(px, golden);
+
+	if (!okay) {
+		failures += 1;
+	}
+
+	printf("[%s] %s: (%u, %u) is 0x%08X, expected 0x%08X\n", (okay ? "PASS" : "FAIL"), what, x, y, px, golden);
+}
+
+static void check_fill_path() {
+	SoftwareDrawingContext dc(64U, 64U);
+	DrawingPath ring(DrawingFillRule::EvenOdd);
+
+	dc.clear(drawing_color(0x000000U));
+	dc.fill_rectangle(10.0F, 10.0F, 20.0F, 10.0F, drawing_color(0xFF0000U));
+	dc.fill_rectangle(40.5F, 10.0F, 10.0F, 10.0F, drawing_color(0xFF0000U));
+
+	ring.add_rectangle(10.0F, 30.0F, 30.0F, 30.0F);
+	ring.add_rectangle(20.0F, 40.0F, 10.0F, 10.0F);
+	dc.fill_path(ring, drawing_color(0xFFFFFFU));
+
+	check_pixel(&dc, 10U, 10U, red, "fill: the top-left pixel of a rectangle");
+	check_pixel(&dc, 29U, 19U, red, "fill: the bottom-right pixel of a rectangle");
+	check_pixel(&dc, 30U, 15U, black, "fill: the pixel right after a rectangle");
+	check_pixel(&dc, 40U, 15U, 0xFF800000U, "fill: a pixel half covered by an edge");
+	check_pixel(&dc, 15U, 35U, white, "fill: the even-odd ring");
+	check_pixel(&dc, 25U, 45U, black, "fill: the hole of the even-odd ring");
+}
+
+static void check_stroke_path() {
+	SoftwareDrawingContext dc(64U, 64U);
+
+	dc.clear(drawing_color(0x000000U));
+	dc.draw_line(10.0F, 50.0F, 50.0F, 50.0F, drawing_color(0xFFFFFFU), 2.0F);
+
+	check_pixel(&dc, 30U, 49U, white, "stroke: the upper half of a 2px line");
+	check_pixel(&dc, 30U, 50U, white, "stroke: the lower half of a 2px line");
+	check_pixel(&dc, 30U, 51U, black, "stroke: the pixel below a 2px line");
+	check_pixel(&dc, 9U, 50U, black, "stroke: caps are flat");
+}
+
+static void check_transforms() {
+	SoftwareDrawingContext dc(64U, 64U);
+
+	dc.clear(drawing_color(0x000000U));
+
+	dc.push_transform(drawing_translation(32.0F, 0.0F));
+	dc.fill_rectangle(0.0F, 0.0F, 4.0F, 4.0F, drawing_color(0xFF0000U));
+	dc.pop_transform();
+
+	dc.push_transform(drawing_scale(2.0F, 2.0F));
+	dc.fill_rectangle(5.0F, 5.0F, 5.0F, 5.0F, drawing_color(0xFFFFFFU));
+	dc.pop_transform();
+
+	// NOTE: a quarter turn maps (x, y) to (-y, x) around the center, a horizontal bar becomes a vertical one
+	dc.push_transform(drawing_rotation(3.14159265F * 0.5F, 48.0F, 40.0F));
+	dc.fill_rectangle(48.0F, 38.0F, 10.0F, 2.0F, drawing_color(0xFF0000U));
+	dc.pop_transform();
+
+	check_pixel(&dc, 33U, 1U, red, "transform: translation");
+	check_pixel(&dc, 1U, 1U, black, "transform: nothing is left at the origin");
+	check_pixel(&dc, 10U, 10U, white, "transform: the scaled top-left corner");
+	check_pixel(&dc, 19U, 19U, white, "transform: the scaled bottom-right corner");
+	check_pixel(&dc, 20U, 20U, black, "transform: the pixel right after the scaled rectangle");
+	check_pixel(&dc, 49U, 45U, red, "transform: the rotated bar runs down");
+	check_pixel(&dc, 52U, 39U, black, "transform: the rotated bar no longer runs right");
+	check_pixel(&dc, 32U, 0U, red, "transform: popping does not undo drawn pixels");
+}
+
+static void check_text_fallback() {
+	SoftwareDrawingContext dc(64U, 32U);
+	DrawingFont font = { L"Consolas", 10.0F, false };
+	DrawingRect box = dc.measure_text(L"ab c", font);
+
+	// NOTE: glyphs are greeked into cells of 5px advances, cells start at 0.1 advance and 0.3 size
+	dc.clear(drawing_color(0x000000U));
+	dc.draw_text(L"ab c", 4.0F, 4.0F, font, drawing_color(0xFFFFFFU));
+
+	check_pixel(&dc, 6U, 10U, white, "text: the cell of 'a'");
+	check_pixel(&dc, 11U, 10U, white, "text: the cell of 'b'");
+	check_pixel(&dc, 16U, 10U, black, "text: spaces have no cells");
+	check_pixel(&dc, 21U, 10U, white, "text: the cell of 'c'");
+	check_pixel(&dc, 6U, 5U, black, "text: the cell starts below the top of the line");
+
+	if ((box.width != 20.0F) || (box.height != 12.0F)) {
+		failures += 1;
+		printf("[FAIL] text: measured %.2fx%.2f, expected 20.00x12.00\n", box.width, box.height);
+	} else {
+		printf("[PASS] text: measured %.2fx%.2f\n", box.width, box.height);
+	}
+}
+
+static void check_layers() {
+	SoftwareDrawingContext dc(64U, 64U);
+
+	dc.clear(drawing_color(0x000000U));
+	dc.push_layer(DrawingRect{ 8.0F, 8.0F, 16.0F, 16.0F }, 0.5F);
+	dc.fill_rectangle(0.0F, 0.0F, 64.0F, 64.0F, drawing_color(0xFFFFFFU));
+	dc.pop_layer();
+
+	check_pixel(&dc, 12U, 12U, 0xFF808080U, "layer: half opacity over black");
+	check_pixel(&dc, 30U, 30U, black, "layer: nothing escapes the clip");
+}
+
+static void time_workload(unsigned int frames, const char* ppm) {
+	SoftwareDrawingContext dc(1280U, 720U);
+	DrawingWorkload workload(1280.0F, 720.0F);
+	double total = 0.0;
+	double worst = 0.0;
+
+	for (unsigned int frame = 0; frame < frames; frame++) {
+		auto start = std::chrono::steady_clock::now();
+
+		workload.render(&dc, frame);
+
+		double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		total += cost;
+		worst = std::max(worst, cost);
+	}
+
+	printf("software: %.3fms per 1280x720 frame, %.3fms at most, %u frames\n", total / double(std::max(frames, 1U)), worst, frames);
+
+	if (ppm != nullptr) {
+		dc.save_ppm(ppm);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	unsigned int frames = ((argc > 1) ? (unsigned int)(std::atoi(argv[1])) : 60U);
+
+	check_fill_path();
+	check_stroke_path();
+	check_transforms();
+	check_text_fallback();
+	check_layers();
+
+	time_workload(frames, ((argc > 2) ? argv[2] : nullptr));
+
+	return ((failures == 0) ? 0 : 1);
+}
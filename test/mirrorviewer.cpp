@@ -0,0 +1,38 @@
+﻿#include "test/mirrorviewer.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::UI;
+
+/*************************************************************************************************/
+MirrorViewerPlanet::MirrorViewerPlanet(Platform::String^ port) : Planet("Mirror Viewer"), listener(nullptr), port(port) {}
+
+MirrorViewerPlanet::~MirrorViewerPlanet() {
+	if (this->listener != nullptr) {
+		delete this->listener; // NOTE: it closes the sockets, and the pending receiving task stops
+	}
+}
+
+void MirrorViewerPlanet::load(CanvasCreateResourcesReason reason, float width, float height) {
+	if (this->listener == nullptr) {
+		this->listener = ref new MirrorListener(this->get_logger());
+		this->listener->listen(this->port);
+	}
+}
+
+void MirrorViewerPlanet::update(long long count, long long interval, long long uptime) {
+	if ((this->listener != nullptr) && this->listener->has_fresh_frame()) {
+		this->notify_graphlet_updated(nullptr);
+	}
+}
+
+void MirrorViewerPlanet::draw(CanvasDrawingSession^ ds, float Width, float Height) {
+	Planet::draw(ds, Width, Height);
+
+	if (this->listener != nullptr) {
+		Win2DDrawingContext dc(ds); // NOTE: received paths are one-shot, there is nothing to cache across frames
+
+		this->listener->replay(&dc);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "planet.hpp"
+#include "drawing/mirrorsocket.hpp"
+#include "drawing/win2d.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * The viewer side of mirroring, run it in another process or on another machine,
+	 *  and point the `SocketMirrorChannel` of the mirrored display to this host and `port`.
+	 *
+	 * Frames are replayed as they are, so the viewer should be as large as the mirrored display.
+	 */
+	private class MirrorViewerPlanet : public WarGrey::SCADA::Planet {
+	public:
+		~MirrorViewerPlanet() noexcept;
+		MirrorViewerPlanet(Platform::String^ port = "9330");
+
+	public:
+		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
+		void update(long long count, long long interval, long long uptime) override;
+		void draw(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float Width, float Height) override;
+
+	private:
+		WarGrey::SCADA::MirrorListener^ listener;
+		Platform::String^ port;
+	};
+}
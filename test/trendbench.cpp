@@ -0,0 +1,80 @@
+﻿#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "test/trendbench.hpp"
+
+#include "graphlet/time/projection.hpp"
+#include "graphlet/textlet.hpp"
+
+#include "time.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::UI;
+
+/*************************************************************************************************/
+TrendBenchmark::TrendBenchmark(unsigned int count, unsigned int rounds)
+	: Planet("Trend Benchmark"), count(std::max(count, 1U)), rounds(std::max(rounds, 1U)) {}
+
+TrendBenchmark::~TrendBenchmark() {}
+
+void TrendBenchmark::load(CanvasCreateResourcesReason reason, float width, float height) {
+	std::vector<long long> timepoints(this->count);
+	std::vector<double> values(this->count);
+	std::vector<float> xs(this->count);
+	std::vector<float> ys(this->count);
+	std::vector<unsigned int> kept(this->count);
+	std::vector<unsigned int> scalar_kept;
+	ProjectionISA preferred = projection_isa();
+	long long origin = current_milliseconds() - (long long)(this->count) * 10LL;
+	double scalar_cost = 0.0;
+	size_t scalar_n = 0U;
+	float y = 0.0F;
+
+	// NOTE: a slowly changing series sampled every 10ms, as dense as a day-long history drawn on a 1200px wide chart
+	for (unsigned int idx = 0; idx < this->count; idx++) {
+		timepoints[idx] = origin + (long long)(idx) * 10LL;
+		values[idx] = std::sin(double(idx) * 0.0001) * 50.0 + double(idx % 7) * 0.001;
+	}
+
+	for (unsigned int i = 0; i <= (unsigned int)(ProjectionISA::AVX2); i++) {
+		ProjectionISA isa = projection_use_isa((ProjectionISA)(i));
+
+		if ((unsigned int)(isa) == i) {
+			long long start = current_100nanoseconds();
+			size_t n = 0U;
+			double cost = 0.0;
+			ProjectionScan scan;
+
+			for (unsigned int r = 0; r < this->rounds; r++) {
+				project_timepoints(timepoints.data(), this->count, origin, 0.0, 1200.0 / (double(this->count) * 10.0), xs.data());
+				project_values(values.data(), this->count, 300.0, -4.0, ys.data());
+				projection_scan_begin(&scan, 0.0F, 1200.0F, 1.0F, 600.0F, 0.5F);
+				n = projection_scan(&scan, xs.data(), ys.data(), this->count, kept.data());
+			}
+
+			cost = double(current_100nanoseconds() - start) / double(this->rounds) / 10000.0;
+
+			if (isa == ProjectionISA::Scalar) {
+				scalar_cost = cost;
+				scalar_n = n;
+				scalar_kept.assign(kept.begin(), kept.begin() + n);
+			}
+
+			// NOTE: a kernel that disagrees with the scalar one is wrong, how fast it is does not matter
+			if ((n == scalar_n) && std::equal(scalar_kept.begin(), scalar_kept.end(), kept.begin())) {
+				this->insert(new Labellet(L"%s: %.3fms per %u points, %u kept, x%.2f", projection_isa_name(isa), cost,
+					this->count, (unsigned int)(n), ((cost > 0.0) ? (scalar_cost / cost) : 0.0)), 0.0F, y);
+			} else {
+				this->insert(new Labellet(L"%s: MISMATCH, %u kept, but the scalar kernel keeps %u", projection_isa_name(isa),
+					(unsigned int)(n), (unsigned int)(scalar_n)), 0.0F, y);
+			}
+
+			y += 24.0F;
+		}
+	}
+
+	projection_use_isa(preferred);
+}
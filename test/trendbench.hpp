@@ -0,0 +1,22 @@
+#pragma once
+
+#include "planet.hpp"
+
+namespace WarGrey::SCADA {
+	/** NOTE
+	 * Projects a 1M-point series with every supported instruction set,
+	 *  as what `ITimeSerieslet::draw()` does for a line of raw values.
+	 */
+	private class TrendBenchmark : public WarGrey::SCADA::Planet {
+	public:
+		~TrendBenchmark() noexcept;
+		TrendBenchmark(unsigned int count = 1000000U, unsigned int rounds = 16U);
+
+	public:
+		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
+
+	private:
+		unsigned int count;
+		unsigned int rounds;
+	};
+}
@@ -0,0 +1,274 @@
+﻿#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "test/trendstress.hpp"
+
+#include "graphlet/time/timeserieslet.hpp"
+#include "graphlet/textlet.hpp"
+
+#include "string.hpp"
+#include "system.hpp"
+#include "time.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Windows::System;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::UI;
+
+static const float stress_chart_width = 1200.0F;
+static const float stress_chart_height = 400.0F;
+static const long long stress_frame_ms = 16LL;
+
+static inline void synthesize(double* values, unsigned int count, long long timepoint) {
+	for (unsigned int idx = 0; idx < count; idx++) {
+		values[idx] = std::sin(double(timepoint) * 0.0001 * double(idx + 1)) * 50.0 + double(idx);
+	}
+}
+
+static inline double elapsed_ms(long long start) {
+	return double(current_100nanoseconds() - start) / 10000.0;
+}
+
+/*************************************************************************************************/
+private class StressDataSource : public ITimeSeriesDataSource {
+public:
+	StressDataSource(unsigned int count, long long period_ms) : count(count), period_ms(period_ms), rows(0ULL) {}
+
+public:
+	bool ready() override { return true; }
+	bool loading() override { return false; }
+	void cancel(ITimeSeriesDataReceiver* receiver) override {}
+
+public:
+	void load(ITimeSeriesDataReceiver* receiver, long long open_s, long long close_s) override {
+		// NOTE: rows are synthesized in the order of time descending, as stores grow backward
+		std::vector<double> values(this->count);
+		long long close_ms = close_s * 1000LL;
+
+		receiver->begin_maniplation_sequence();
+		for (long long t = (open_s * 1000LL / this->period_ms) * this->period_ms; t > close_ms; t -= this->period_ms) {
+			synthesize(values.data(), this->count, t);
+			receiver->on_datum_values(open_s, t, values.data(), this->count);
+			this->rows += 1ULL;
+		}
+		receiver->end_maniplation_sequence();
+
+		receiver->on_maniplation_complete(open_s, close_s);
+	}
+
+	void save(long long timepoint, double* values, unsigned int n) override {}
+
+public:
+	unsigned long long rows;
+
+protected:
+	~StressDataSource() noexcept {}
+
+private:
+	unsigned int count;
+	long long period_ms;
+};
+
+private class StressSerieslet : public ITimeSerieslet {
+public:
+	StressSerieslet(ITimeSeriesDataSource* src, TimeSeries& ts, unsigned int count, long long history_s)
+		: ITimeSerieslet(src, -64.0, 64.0 + double(count), ts, count,
+			stress_chart_width, stress_chart_height, 0U, 2U, history_s), lines(count) {}
+
+public:
+	void construct() override {
+		for (unsigned int idx = 0; idx < this->lines; idx++) {
+			this->construct_line(idx, make_wstring(L"line%u", idx));
+		}
+	}
+
+public:
+	using ITimeSerieslet::push_value;
+
+private:
+	unsigned int lines;
+};
+
+/*************************************************************************************************/
+private struct WarGrey::SCADA::tsstress {
+	unsigned int lines;
+	unsigned int rate;
+	long long history_s;
+	float y;
+
+	StressDataSource* source = nullptr;
+	StressSerieslet* chart = nullptr;
+	std::vector<double> values;
+	long long period_ms = 0LL;
+	long long timepoint = 0LL;
+	long long close_ms = 0LL;
+	unsigned int frame = 0U;
+
+	unsigned long long memory0 = 0ULL;
+	unsigned long long pushes = 0ULL;
+	double load_cost = 0.0;
+	double push_cost = 0.0;
+	double push_max = 0.0;
+	double draw_cost = 0.0;
+	double draw_max = 0.0;
+};
+
+/*************************************************************************************************/
+TrendStress::TrendStress(unsigned int max_lines, unsigned int max_rate, unsigned int push_s, bool per_line)
+	: Planet("Trend Stress"), target(nullptr), max_lines(std::max(max_lines, 1U)), max_rate(std::max(max_rate, 1U))
+	, push_s(std::max(push_s, 1U)), per_line(per_line) {}
+
+TrendStress::~TrendStress() {
+	// NOTE: charts of unfinished combinations are owned by the planet
+	for (auto stress : this->stresses) {
+		delete stress;
+	}
+}
+
+void TrendStress::load(CanvasCreateResourcesReason reason, float width, float height) {
+	// NOTE: charts are drawn into the offscreen target, so that the cost of the screen is not counted
+	long long histories[] = { hour_span_s, day_span_s };
+	float y = 0.0F;
+
+	this->target = ref new CanvasRenderTarget(CanvasDevice::GetSharedDevice(), stress_chart_width, stress_chart_height, 96.0F);
+
+	for (unsigned int lines = 4U; lines <= this->max_lines; lines *= 4U) {
+		for (unsigned int rate = 10U; rate <= this->max_rate; rate *= 10U) {
+			for (long long history_s : histories) {
+				tsstress* stress = new tsstress();
+
+				stress->lines = lines;
+				stress->rate = rate;
+				stress->history_s = history_s;
+				stress->y = y;
+				this->stresses.push_back(stress);
+
+				y += 24.0F;
+			}
+		}
+	}
+}
+
+void TrendStress::update(long long count, long long interval, long long uptime) {
+	if (!this->stresses.empty()) {
+		tsstress* stress = this->stresses.front();
+
+		if (stress->chart == nullptr) {
+			this->begin_stress(stress);
+		} else if (stress->timepoint < stress->close_ms) {
+			this->stress_frame(stress);
+		} else {
+			this->end_stress(stress);
+			this->stresses.pop_front();
+			delete stress;
+		}
+	}
+}
+
+void TrendStress::begin_stress(tsstress* stress) {
+	TimeSeries ts = make_minute_series(1U);
+	AppMemoryUsageLevel level;
+	unsigned long long app_usage = 0ULL;
+
+	stress->period_ms = std::max(1000LL / (long long)(stress->rate), 1LL);
+	stress->values.resize(stress->lines);
+	stress->memory0 = system_physical_memory_usage(&app_usage, &level);
+	stress->source = new StressDataSource(stress->lines, stress->period_ms);
+	stress->chart = new StressSerieslet(stress->source, ts, stress->lines, stress->history_s);
+
+	this->insert(stress->chart);
+
+	{ // load the history, one window for each update
+		long long start = current_100nanoseconds();
+
+		for (unsigned int idx = 0; idx <= ts.step * 2U + 2U; idx++) {
+			stress->chart->update(idx, stress_frame_ms, idx * stress_frame_ms);
+		}
+
+		stress->load_cost = elapsed_ms(start);
+	}
+
+	// NOTE: samples are stamped with the wall clock, so they are pushed as fast as a live source would push them
+	stress->timepoint = (current_milliseconds() / stress->period_ms + 1LL) * stress->period_ms;
+	stress->close_ms = stress->timepoint + (long long)(this->push_s) * 1000LL;
+}
+
+void TrendStress::stress_frame(tsstress* stress) {
+	long long frame_end = std::min(current_milliseconds(), stress->close_ms);
+	long long start = 0LL;
+	double cost = 0.0;
+
+	while (stress->timepoint <= frame_end) {
+		synthesize(stress->values.data(), stress->lines, stress->timepoint);
+
+		start = current_100nanoseconds();
+		if (this->per_line) {
+			for (unsigned int idx = 0; idx < stress->lines; idx++) {
+				stress->chart->push_value(idx, stress->values[idx], stress->timepoint);
+			}
+		} else {
+			stress->chart->set_values(stress->values.data(), false, stress->timepoint);
+		}
+		cost = elapsed_ms(start);
+
+		stress->push_cost += cost;
+		stress->push_max = std::max(stress->push_max, cost);
+		stress->pushes += 1ULL;
+		stress->timepoint += stress->period_ms;
+	}
+
+	stress->chart->update(stress->frame, stress_frame_ms, stress->frame * stress_frame_ms);
+
+	start = current_100nanoseconds();
+	{ // commands are flushed when the session is closed at the end of the scope
+		CanvasDrawingSession^ ds = this->target->CreateDrawingSession();
+
+		stress->chart->draw(ds, 0.0F, 0.0F, stress_chart_width, stress_chart_height);
+	}
+	cost = elapsed_ms(start);
+
+	stress->draw_cost += cost;
+	stress->draw_max = std::max(stress->draw_max, cost);
+	stress->frame += 1U;
+}
+
+void TrendStress::end_stress(tsstress* stress) {
+	AppMemoryUsageLevel level;
+	TimeSeriesStatistics kept;
+	unsigned long long app_usage = 0ULL;
+	unsigned long long rows = stress->source->rows + stress->pushes;
+	double sample_bytes = 0.0;
+	double push_cost = stress->push_cost / double(std::max(stress->pushes, 1ULL));
+	double draw_cost = stress->draw_cost / double(std::max(stress->frame, 1U));
+	double frame_cost = stress->push_cost / double(std::max(stress->frame, 1U)) + draw_cost;
+
+	{ // the working set is coarse, but it tells the cost of storage changes when there are enough samples
+		unsigned long long memory1 = system_physical_memory_usage(&app_usage, &level);
+		unsigned long long samples = rows * stress->lines;
+
+		if ((memory1 > stress->memory0) && (samples > 0ULL)) {
+			sample_bytes = double(memory1 - stress->memory0) / double(samples);
+		}
+	}
+
+	{ // NOTE: rows denser than the store keeps are coalesced, and rows older than the history span are dropped
+		stress->chart->set_recent_window(stress->history_s);
+		stress->chart->update(stress->frame, stress_frame_ms, stress->frame * stress_frame_ms);
+
+		if (!stress->chart->fill_recent_statistics(0U, &kept)) {
+			kept.count = 0ULL;
+		}
+	}
+
+	this->insert(new Labellet(L"%u lines@%uHz, %llds: load %.1fms/%llu rows, push%s %.3fms(max %.3fms), %.2fB/sample, draw %.2fms(max %.2fms)/%u frames, kept %llu/%llu rows(%.1f%%)%s",
+		stress->lines, stress->rate, stress->history_s, stress->load_cost, stress->source->rows,
+		(this->per_line ? L" by line" : L""), push_cost, stress->push_max, sample_bytes, draw_cost, stress->draw_max, stress->frame,
+		kept.count, rows, double(kept.count) * 100.0 / double(std::max(rows, 1ULL)),
+		((frame_cost > double(stress_frame_ms)) ? L", frames drop" : L"")),
+		0.0F, stress->y);
+
+	this->remove(stress->chart);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <deque>
+
+#include "planet.hpp"
+
+namespace WarGrey::SCADA {
+	struct tsstress;
+
+	/** NOTE
+	 * Drives synthetic signals through `ITimeSerieslet` with every combination of line counts, sample rates and history spans,
+	 *  the history is loaded through a mock data source at the sample rate, and frames are drawn into an offscreen target,
+	 *  then reports the cost of loading, the latency of pushing, the memory per sample, the time of drawing a frame,
+	 *  and how many of the loaded and pushed rows are kept by the chart.
+	 *
+	 * Combinations run one after another in `update`, each for `push_s` seconds of wall-clock time,
+	 *  every frame pushes the samples that are due by then, as whole rows, or line by line if `per_line` is set.
+	 */
+	private class TrendStress : public WarGrey::SCADA::Planet {
+	public:
+		~TrendStress() noexcept;
+		TrendStress(unsigned int max_lines = 64U, unsigned int max_rate = 1000U, unsigned int push_s = 10U, bool per_line = false);
+
+	public:
+		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
+		void update(long long count, long long interval, long long uptime) override;
+
+	private:
+		void begin_stress(WarGrey::SCADA::tsstress* stress);
+		void stress_frame(WarGrey::SCADA::tsstress* stress);
+		void end_stress(WarGrey::SCADA::tsstress* stress);
+
+	private:
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ target;
+		std::deque<WarGrey::SCADA::tsstress*> stresses;
+		unsigned int max_lines;
+		unsigned int max_rate;
+		unsigned int push_s;
+		bool per_line;
+	};
+}
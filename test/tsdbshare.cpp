@@ -0,0 +1,140 @@
+﻿#include <set>
+#include <cmath>
+#include <algorithm>
+
+#include "test/tsdbshare.hpp"
+
+#include "graphlet/time/timeseriesdb.hpp"
+#include "graphlet/textlet.hpp"
+
+#include "string.hpp"
+#include "time.hpp"
+
+using namespace WarGrey::SCADA;
+
+using namespace Microsoft::Graphics::Canvas;
+using namespace Microsoft::Graphics::Canvas::UI;
+
+static const unsigned int share_line_count = 2U;
+static const long long share_history_s = hour_span_s;
+
+// NOTE: addresses of destroyed probes, the removed chart is not touched when values are delivered to it by mistake
+static std::set<ITimeSeriesDataReceiver*> destroyed_probes;
+static unsigned long long stray_rows = 0ULL;
+
+static inline void synthesize(double* values, long long timepoint) {
+	for (unsigned int idx = 0; idx < share_line_count; idx++) {
+		values[idx] = std::sin(double(timepoint) * 0.0001 * double(idx + 1)) * 50.0;
+	}
+}
+
+/*************************************************************************************************/
+private class ProbeSerieslet : public ITimeSerieslet {
+public:
+	ProbeSerieslet(ITimeSeriesDataSource* src, TimeSeries& ts)
+		: ITimeSerieslet(src, -64.0, 64.0, ts, share_line_count, 600.0F, 200.0F, 0U, 2U, share_history_s), rows(0ULL), windows(0U) {
+		destroyed_probes.erase(this); // NOTE: the address might be reused
+	}
+
+	~ProbeSerieslet() noexcept {
+		destroyed_probes.insert(this);
+	}
+
+public:
+	void construct() override {
+		for (unsigned int idx = 0; idx < share_line_count; idx++) {
+			this->construct_line(idx, make_wstring(L"line%u", idx));
+		}
+	}
+
+	void on_datum_values(long long open_s, long long timepoint_ms, double* values, unsigned int n) override {
+		if (destroyed_probes.find(this) != destroyed_probes.end()) {
+			stray_rows += 1ULL;
+		} else {
+			this->rows += 1ULL;
+			ITimeSerieslet::on_datum_values(open_s, timepoint_ms, values, n);
+		}
+	}
+
+	void on_maniplation_complete(long long open_s, long long close_s) override {
+		if (destroyed_probes.find(this) != destroyed_probes.end()) {
+			stray_rows += 1ULL;
+		} else {
+			this->windows += 1U;
+			ITimeSerieslet::on_maniplation_complete(open_s, close_s);
+		}
+	}
+
+public:
+	unsigned long long rows;
+	unsigned int windows;
+};
+
+/*************************************************************************************************/
+TimeSeriesDBSharing::TimeSeriesDBSharing(unsigned int timeout_frames)
+	: Planet("Time Series DB Sharing"), db(nullptr), survivor(nullptr), victim(nullptr)
+	, timeout_frames(std::max(timeout_frames, 1U)), frames_since_removed(0U), reported(false) {}
+
+TimeSeriesDBSharing::~TimeSeriesDBSharing() {}
+
+void TimeSeriesDBSharing::load(CanvasCreateResourcesReason reason, float width, float height) {
+	if (this->db == nullptr) {
+		TimeSeries ts = make_minute_series(share_line_count);
+		long long now = current_milliseconds();
+		double values[share_line_count];
+
+		// NOTE: the database is referenced by both charts, and it is destroyed with the last one
+		this->db = new TimeSeriesDB("tsdbshare", share_line_count, share_history_s * 2LL, 0ULL, hour_span_s, this->get_logger());
+
+		// NOTE: rows saved before the recovery are appended along with the first row saved after it
+		for (long long t = now - share_history_s * 1000LL; t < now; t += 1000LL) {
+			synthesize(values, t);
+			this->db->save(t, values, share_line_count);
+		}
+
+		stray_rows = 0ULL;
+		this->survivor = new ProbeSerieslet(this->db, ts);
+		this->victim = new ProbeSerieslet(this->db, ts);
+		this->insert(this->survivor, 0.0F, 0.0F);
+		this->insert(this->victim, 0.0F, 220.0F);
+	}
+}
+
+void TimeSeriesDBSharing::update(long long count, long long interval, long long uptime) {
+	if ((this->db != nullptr) && (!this->reported)) {
+		long long now = current_milliseconds();
+		double values[share_line_count];
+
+		synthesize(values, now);
+		this->db->save(now, values, share_line_count);
+
+		if (this->victim != nullptr) {
+			// NOTE: children are updated before the planet, both of them have asked for their windows by now
+			if (this->db->ready() && this->db->loading()) {
+				this->remove(this->victim);
+				this->victim = nullptr;
+			}
+		} else {
+			ProbeSerieslet* survivor = static_cast<ProbeSerieslet*>(this->survivor);
+
+			this->frames_since_removed += 1U;
+
+			if ((survivor->windows > 0U) && (!this->db->loading())) {
+				this->report(false);
+			} else if (this->frames_since_removed >= this->timeout_frames) {
+				this->report(true);
+			}
+		}
+	}
+}
+
+void TimeSeriesDBSharing::report(bool timeout) {
+	ProbeSerieslet* survivor = static_cast<ProbeSerieslet*>(this->survivor);
+	bool okay = ((!timeout) && (stray_rows == 0ULL));
+
+	this->insert(new Labellet(L"%s: the survivor loaded %llu rows in %u windows within %u frames, %llu rows went to the removed chart%s",
+		(okay ? L"PASS" : L"FAIL"), survivor->rows, survivor->windows, this->frames_since_removed, stray_rows,
+		(timeout ? L", timeout" : L"")), 0.0F, 440.0F);
+
+	this->reported = true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "planet.hpp"
+
+namespace WarGrey::SCADA {
+	class TimeSeriesDB;
+	class ITimeSerieslet;
+
+	/** NOTE
+	 * Two charts load the history from one `TimeSeriesDB`, and one of them is removed while its windows are still loading,
+	 *  then the other one should keep loading, and no value should be delivered to the removed one.
+	 */
+	private class TimeSeriesDBSharing : public WarGrey::SCADA::Planet {
+	public:
+		~TimeSeriesDBSharing() noexcept;
+		TimeSeriesDBSharing(unsigned int timeout_frames = 600U);
+
+	public:
+		void load(Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason reason, float width, float height) override;
+		void update(long long count, long long interval, long long uptime) override;
+
+	private:
+		void report(bool timeout);
+
+	private:
+		WarGrey::SCADA::TimeSeriesDB* db;
+		WarGrey::SCADA::ITimeSerieslet* survivor;
+		WarGrey::SCADA::ITimeSerieslet* victim;
+		unsigned int timeout_frames;
+		unsigned int frames_since_removed;
+		bool reported;
+	};
+}
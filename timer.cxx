@@ -7,8 +7,10 @@ using namespace Windows::Foundation;
 
 using namespace Windows::UI::Xaml;
 
-Timer::Timer(ITimerListener^ callback, int rate, unsigned int shift) : target(callback), interval(0LL) {
+Timer::Timer(ITimerListener^ callback, int rate, unsigned int shift) {
 	this->timer = ref new DispatcherTimer();
+	this->target = new TimerListenerAdapter(callback);
+	this->scheduler = new FrameScheduler(this->target);
 
 	this->timer->Tick += ref new EventHandler<Platform::Object^>(this, &Timer::notify);
 
@@ -20,51 +22,61 @@ Timer::Timer(ITimerListener^ callback, int rate, unsigned int shift) : target(ca
 
 Timer::~Timer() {
 	this->stop();
+
+	delete this->scheduler;
+	delete this->target;
 }
 
 void Timer::start(int rate, unsigned int shift) {
-	if (rate != 0) {
-		this->set_frame_rate(rate, shift);
-	} else if (this->interval == 0LL) {
-		this->set_frame_rate(60, shift);
+	long long interval = this->scheduler->get_interval();
+
+	if ((rate != 0) || (interval == 0LL)) {
+		interval = make_timespan_from_rate(((rate == 0) ? 60 : rate), shift).Duration;
 	}
 
+	this->scheduler->start(interval);
+	this->timer->Interval = TimeSpan{ interval };
 	this->timer->Start();
-
-	this->count = 1;
-	this->uptime = this->interval;
 }
 
 void Timer::stop() {
 	this->timer->Stop();
+	this->scheduler->stop();
 }
 
-void Timer::notify(Platform::Object^ whocares, Platform::Object^ useless) {
-	// TODO: meanwhile the next round will elapse after this one finished. 
-	long long elapsed0 = current_100nanoseconds();
-	long long elapsed, next_tick;
-
-	this->target->on_elapse(this->count, this->interval, this->uptime);
-	elapsed = current_100nanoseconds() - elapsed0;
-	next_tick = this->interval - elapsed;
-	this->target->on_elapse(this->count, this->interval, this->uptime, elapsed);
-	
-	this->count += 1;
-	this->uptime += this->interval;
-
-	while (next_tick < 0) {
-		next_tick += this->interval;
-
-		this->count += 1;
-		this->uptime += this->interval;
+void Timer::set_frame_rate(int rate, unsigned int shift) {
+	long long interval = make_timespan_from_rate(rate, shift).Duration;
+
+	if (interval != this->scheduler->get_interval()) {
+		this->scheduler->retune(interval);
+		this->timer->Interval = TimeSpan{ interval };
 	}
+}
 
-	this->timer->Interval = TimeSpan{ next_tick }; // don't worry, it's Visual Studio's fault
+void Timer::notify(Platform::Object^ whocares, Platform::Object^ useless) {
+	/** NOTE
+	 * The `DispatcherTimer` is driven by the UI thread, so rounds never overlap,
+	 *  the scheduler just tells when the next deadline is.
+	 */
+
+	this->timer->Interval = TimeSpan{ this->scheduler->step() }; // don't worry, it's Visual Studio's fault
 }
 
-void Timer::set_frame_rate(int rate, unsigned int shift) {
-	this->timer->Interval = make_timespan_from_rate(rate, shift);
-	this->interval = this->timer->Interval.Duration;
+void Timer::fill_statistics(FrameStatistics* stats) {
+	this->scheduler->fill_statistics(stats);
+}
+
+/*************************************************************************************************/
+void TimerListenerAdapter::on_elapse(long long count, long long interval, long long uptime) {
+	this->target->on_elapse(count, interval, uptime);
+}
+
+void TimerListenerAdapter::on_elapse(long long count, long long interval, long long uptime, long long span) {
+	this->target->on_elapse(count, interval, uptime, span);
+}
+
+void TimerListenerAdapter::on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) {
+	this->target->on_frame_dropped(count, dropped, interval, uptime);
 }
 
 /*************************************************************************************************/
@@ -80,6 +92,12 @@ void CompositeTimerListener::on_elapse(long long count, long long interval, long
 	}
 }
 
+void CompositeTimerListener::on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) {
+	for (auto action : this->listeners) {
+		action->on_frame_dropped(count, dropped, interval, uptime);
+	}
+}
+
 void CompositeTimerListener::push_timer_listener(ITimerListener^ action) {
 	this->listeners.push_back(action);
 }
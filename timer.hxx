@@ -3,17 +3,33 @@
 #include <list>
 
 #include "syslog.hpp"
+#include "scheduler.hpp"
 
 namespace WarGrey::SCADA {
 	private ref class ITimerListener abstract {
 	public:
 		virtual void on_elapse(long long count, long long interval, long long uptime) = 0;
 		virtual void on_elapse(long long count, long long interval, long long uptime, long long span) {}
+		virtual void on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) {}
 
 	internal:
 		virtual WarGrey::SCADA::Syslog* get_logger() = 0;
 	};
 
+	/************************************************************************************************/
+	private class TimerListenerAdapter : public WarGrey::SCADA::IFrameListener {
+	public:
+		TimerListenerAdapter(WarGrey::SCADA::ITimerListener^ target) : target(target) {}
+
+	public:
+		void on_elapse(long long count, long long interval, long long uptime) override;
+		void on_elapse(long long count, long long interval, long long uptime, long long span) override;
+		void on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) override;
+
+	private:
+		WarGrey::SCADA::ITimerListener^ target;
+	};
+
 	private ref class Timer sealed {
 	public:
 		virtual ~Timer();
@@ -23,24 +39,26 @@ namespace WarGrey::SCADA {
 		void start(int rate = 0, unsigned int shift = 1U);
 		void stop();
 
+	public:
+		void set_frame_rate(int rate, unsigned int shift = 1U);
+
+	internal:
+		void fill_statistics(WarGrey::SCADA::FrameStatistics* stats);
+
 	private:
-		void set_frame_rate(int rate, unsigned int shift);
 		void notify(Platform::Object^ whocares, Platform::Object^ useless);
 
 	private:
 		Windows::UI::Xaml::DispatcherTimer^ timer;
-		WarGrey::SCADA::ITimerListener^ target;
-
-	private:
-		long long count;
-		long long interval;
-		long long uptime;
+		WarGrey::SCADA::TimerListenerAdapter* target;
+		WarGrey::SCADA::FrameScheduler* scheduler;
 	};
 
 	private ref class CompositeTimerListener : public WarGrey::SCADA::ITimerListener {
 	public:
 		void on_elapse(long long count, long long interval, long long uptime) override;
 		void on_elapse(long long count, long long interval, long long uptime, long long span) override;
+		void on_frame_dropped(long long count, long long dropped, long long interval, long long uptime) override;
 
 	public:
 		void push_timer_listener(WarGrey::SCADA::ITimerListener^ receiver);
@@ -1,4 +1,6 @@
 #include <ppltasks.h>
+#include <algorithm>
+#include <cstring>
 
 #include "universe.hxx"
 #include "planet.hpp"
@@ -15,6 +17,9 @@
 #include "colorspace.hpp"
 #include "transformation.hpp"
 
+#include "drawing/mirror.hpp"
+#include "profiler.hpp"
+
 using namespace WarGrey::SCADA;
 
 using namespace Concurrency;
@@ -57,13 +62,30 @@ static Platform::String^ mask_setting_key = "Mask_Alpha";
 
 static CanvasSolidColorBrush^ global_mask_color;
 
+enum class PlanetConstruction { Pending, Constructing, Constructed };
+
 class PlanetInfo : public WarGrey::SCADA::IPlanetInfo {
 public:
-	PlanetInfo(IDisplay^ master) : IPlanetInfo(master) {};
+	PlanetInfo(IDisplay^ master) : IPlanetInfo(master), last_count(0LL), last_uptime(0LL), tick(), construction(PlanetConstruction::Pending)
+		, index(0U), standby_surface(nullptr), standby_stale(false) {};
 
 public:
 	IPlanet* next;
 	IPlanet* prev;
+	size_t index;
+
+public:
+	long long last_count;
+	long long last_uptime;
+	PlanetTickStatistics tick;
+
+public:
+	std::atomic<PlanetConstruction> construction;
+
+public: // for warm standby
+	std::map<IPlanet*, unsigned int> followers; // how many times the user went there from this planet
+	CanvasRenderTarget^ standby_surface;
+	std::atomic<bool> standby_stale;
 };
 
 static inline PlanetInfo* bind_planet_owership(IDisplay^ master, IPlanet* planet) {
@@ -74,7 +96,19 @@ static inline PlanetInfo* bind_planet_owership(IDisplay^ master, IPlanet* planet
 	return info;
 }
 
-static void construct_planet(IPlanet* planet, Platform::String^ type, Syslog* logger, CanvasCreateResourcesReason reason, float width, float height) {
+static inline bool planet_constructed(IPlanet* planet) {
+	return ((planet != nullptr) && (PLANET_INFO(planet)->construction == PlanetConstruction::Constructed));
+}
+
+static inline bool claim_planet_construction(IPlanet* planet) {
+	PlanetConstruction pending = PlanetConstruction::Pending;
+
+	return PLANET_INFO(planet)->construction.compare_exchange_strong(pending, PlanetConstruction::Constructing);
+}
+
+static long long construct_planet(IPlanet* planet, Platform::String^ type, Syslog* logger, CanvasCreateResourcesReason reason, float width, float height) {
+	long long start = current_100nanoseconds();
+
 	planet->begin_update_sequence();
 
 	try {
@@ -89,26 +123,151 @@ static void construct_planet(IPlanet* planet, Platform::String^ type, Syslog* lo
 	}
 
 	planet->end_update_sequence();
+
+	return current_100nanoseconds() - start;
+}
+
+static void elapse_planet(IPlanet* planet, long long count, long long interval, long long uptime, bool sequence) {
+	ProfileScope profiling(planet->get_profiler(), ProfilePhase::Update, planet);
+	PlanetInfo* info = PLANET_INFO(planet);
+	long long elapsed0 = current_100nanoseconds();
+
+	if (info->construction == PlanetConstruction::Constructed) {
+		if ((info->last_count > 0LL) && ((info->last_count + 1LL) < count)) {
+			// catching up after being hidden, let the animations know the actual interval.
+			interval = uptime - info->last_uptime;
+		}
+
+		if (sequence) {
+			planet->begin_update_sequence();
+		}
+
+		planet->on_elapse(count, interval, uptime);
+
+		if (sequence) {
+			planet->end_update_sequence();
+		}
+
+		info->last_count = count;
+		info->last_uptime = uptime;
+		info->tick.ticks += 1LL;
+		info->tick.last_cost = current_100nanoseconds() - elapsed0;
+		info->tick.total_cost += info->tick.last_cost;
+		info->tick.max_cost = std::max(info->tick.max_cost, info->tick.last_cost);
+	}
+}
+
+static void sync_planet(IPlanet* planet, long long count, long long interval, long long uptime) {
+	PlanetInfo* info = PLANET_INFO(planet);
+	long long elapsed0 = current_100nanoseconds();
+
+	if (info->construction == PlanetConstruction::Constructed) {
+		planet->on_sync(count, interval, uptime);
+
+		info->tick.syncs += 1LL;
+		info->tick.last_cost = current_100nanoseconds() - elapsed0;
+		info->tick.total_cost += info->tick.last_cost;
+		info->tick.max_cost = std::max(info->tick.max_cost, info->tick.last_cost);
+	}
 }
 
 static inline void reflow_planet(IPlanet* planet, float width, float height) {
-	if (planet->surface_ready()) {
+	if (planet->surface_ready() && planet_constructed(planet)) {
 		planet->enter_critical_section();
 		planet->reflow(width, height);
 		planet->leave_critical_section();
 	}
 }
 
-static void draw_planet(CanvasDrawingSession^ ds, Platform::String^ type, IPlanet* planet, float width, float height, Syslog* logger) {
-	planet->enter_shared_section();
+static void draw_planet(CanvasDrawingSession^ ds, Platform::String^ type, IPlanet* planet, float width, float height, Syslog* logger
+	, Rect* damage = nullptr) {
+	ProfileScope profiling(planet->get_profiler(), ProfilePhase::Draw, planet);
+
+	if (planet_constructed(planet)) { // otherwise, it is still being constructed in background
+		planet->enter_shared_section();
 	
-	try {
-		planet->draw(ds, width, height);
-	} catch (Platform::Exception^ wte) {
-		logger->log_message(Log::Warning, L"%s[%s]: rendering: %s", type->Data(), planet->name()->Data(), wte->Message->Data());
+		try {
+			if (damage == nullptr) {
+				planet->draw(ds, width, height);
+			} else {
+				planet->draw_damage(ds, damage->X, damage->Y, damage->Width, damage->Height, width, height);
+			}
+		} catch (Platform::Exception^ wte) {
+			logger->log_message(Log::Warning, L"%s[%s]: rendering: %s", type->Data(), planet->name()->Data(), wte->Message->Data());
+		}
+
+		planet->leave_shared_section();
 	}
+}
+
+static void render_planet(IDrawingContext* dc, Platform::String^ type, IPlanet* planet, float x, float y, float width, float height, Syslog* logger) {
+	if (planet_constructed(planet)) {
+		dc->push_transform(drawing_translation(x, y));
+		planet->enter_shared_section();
+
+		try {
+			planet->render(dc, width, height);
+		} catch (Platform::Exception^ wte) {
+			logger->log_message(Log::Warning, L"%s[%s]: mirroring: %s", type->Data(), planet->name()->Data(), wte->Message->Data());
+		}
+
+		planet->leave_shared_section();
+		dc->pop_transform();
+	}
+}
+
+static void take_planet_damage(IPlanet* planet, float xoff, float yoff, float* left, float* top, float* right, float* bottom) {
+	float x, y, width, height;
 
-	planet->leave_shared_section();
+	if (planet_constructed(planet) && planet->take_damage(&x, &y, &width, &height)) {
+		(*left) = std::fminf((*left), x + xoff);
+		(*top) = std::fminf((*top), y + yoff);
+		(*right) = std::fmaxf((*right), x + xoff + width);
+		(*bottom) = std::fmaxf((*bottom), y + yoff + height);
+	}
+}
+
+static CanvasRenderTarget^ cache_planet_surface(IPlanet* planet, float width, float height, float dpi, Syslog* logger) {
+	CanvasRenderTarget^ surface = nullptr;
+
+	if (planet_constructed(planet)) {
+		try {
+			surface = planet->take_snapshot(width, height, nullptr, dpi);
+		} catch (Platform::Exception^ wte) {
+			logger->log_message(Log::Warning, L"planet[%s]: caching surface: %s", planet->name()->Data(), wte->Message->Data());
+		}
+	}
+
+	return surface;
+}
+
+static void draw_transferring_planet(CanvasDrawingSession^ ds, IPlanet* planet, CanvasRenderTarget^ surface
+	, float x, float y, float width, float height, Syslog* logger) {
+	if (surface != nullptr) {
+		ds->DrawImage(surface, x, y);
+	} else {
+		float3x2 identity = ds->Transform;
+
+		ds->Transform = make_translation_matrix(x, y);
+		draw_planet(ds, "planet", planet, width, height, logger);
+		ds->Transform = identity;
+	}
+}
+
+static float transfer_ease(TransferEasing easing, float t) {
+	float eased = t;
+
+	switch (easing) {
+	case TransferEasing::EaseIn: eased = t * t * t; break;
+	case TransferEasing::EaseOut: eased = 1.0F - (1.0F - t) * (1.0F - t) * (1.0F - t); break;
+	case TransferEasing::EaseInOut: {
+		float u = 2.0F - 2.0F * t;
+
+		eased = ((t < 0.5F) ? (4.0F * t * t * t) : (1.0F - u * u * u * 0.5F));
+	}; break;
+	}
+
+	return eased;
 }
 
 static inline float display_contain_mode_scale(float to_width, float to_height, float from_width, float from_height) {
@@ -133,7 +292,7 @@ static inline void load_mask_alpha(ApplicationDataContainer^ container, CanvasSo
 IDisplay::IDisplay(Syslog* logger, DisplayFit mode, float dest_width, float dest_height, float src_width, float src_height)
 	: logger((logger == nullptr) ? make_silent_logger("IDisplay") : logger), mode(mode)
 	, target_width(std::fmaxf(dest_width, 0.0F)), target_height(std::fmaxf(dest_height, 0.0F))
-	, source_width(src_width), source_height(src_height) {
+	, source_width(src_width), source_height(src_height), source_resolution(false) {
 	this->logger->reference();
 
 	if (this->source_width <= 0.0F) {
@@ -231,11 +390,36 @@ float IDisplay::planet_actual_height(IPlanet* p) {
 }
 
 void IDisplay::apply_source_size(float src_width, float src_height) {
-	this->width = this->sketch_to_application_width(src_width);
-	this->height = this->sketch_to_application_height(src_height);
+	this->width = this->fit_width(src_width);
+	this->height = this->fit_height(src_height);
 }
 
 float IDisplay::sketch_to_application_width(float sketch_width) {
+	return (this->source_resolution ? sketch_width : this->fit_width(sketch_width));
+}
+
+float IDisplay::sketch_to_application_height(float sketch_height) {
+	return (this->source_resolution ? sketch_height : this->fit_height(sketch_height));
+}
+
+void IDisplay::use_source_resolution(bool yes) {
+	this->source_resolution = (yes && (this->mode != DisplayFit::None));
+}
+
+bool IDisplay::source_resolution_used() {
+	return this->source_resolution;
+}
+
+DisplayFit IDisplay::fit_mode() {
+	return this->mode;
+}
+
+void IDisplay::fill_source_size(float* width, float* height) {
+	SET_BOX(width, this->source_width);
+	SET_BOX(height, this->source_height);
+}
+
+float IDisplay::fit_width(float sketch_width) {
 	static Size screen = system_screen_size();
 	float width = sketch_width;
 
@@ -253,7 +437,7 @@ float IDisplay::sketch_to_application_width(float sketch_width) {
 	return width;
 }
 
-float IDisplay::sketch_to_application_height(float sketch_height) {
+float IDisplay::fit_height(float sketch_height) {
 	static Size screen = system_screen_size();
 	float height = sketch_height;
 
@@ -340,7 +524,18 @@ UniverseDisplay::UniverseDisplay(DisplayFit mode, float dwidth, float dheight, f
 	, Syslog* logger, Platform::String^ setting_name, IUniverseNavigator* navigator, IHeadUpPlanet* heads_up_planet)
 	: IDisplay(((logger == nullptr) ? make_silent_logger("UniverseDisplay") : logger), mode, dwidth, dheight, swidth, sheight)
 	, figure_x0(std::nanf("swipe")), shortcuts_enabled(true), universe_settings(nullptr), follow_global_mask_setting(true)
-	, hup_top_margin(0.0F), hup_right_margin(0.0F), hup_bottom_margin(0.0F), hup_left_margin(0.0F) {
+	, hup_top_margin(0.0F), hup_right_margin(0.0F), hup_bottom_margin(0.0F), hup_left_margin(0.0F)
+	, background_ticking(BackgroundTicking::Always), background_divisor(1U), last_count(0LL), last_interval(0LL), last_uptime(0LL)
+	, governor(nullptr), governor_active_rate(0), governor_idle_rate(0), governor_idle_frames(0U), quiet_frames(0U), idling(false)
+	, mirror_channel(nullptr), mirror_worker(nullptr), mirror_frame(nullptr), profiler(nullptr)
+	, construction_generation(0U), lazy_construction(false), lazy_workers(2U), resources_constructed(false), startup_origin(0LL), startup_pending(0U)
+	, standby_capacity(0U), standby_frames(60U), standby_scheduled(false)
+	, standby_anchor(nullptr), standby_width(0.0F), standby_height(0.0F), standby_primed_count(0LL)
+	, redraw_pending(false), refresh_requests(0LL), pending_ticks(0U), ticking(false), needs_redraw(false)
+	, from_planet(nullptr), transfer_easing(TransferEasing::Linear), transfer_step(0U), transfer_steps(0U)
+	, transfer_direction(0.0F), transferX(0.0F), transferY(0.0F)
+	, from_surface(nullptr), to_surface(nullptr), from_surface_stale(false), to_surface_stale(false)
+	, source_surface(nullptr), source_damaged(true) {
 	this->transfer_clock = ref new DispatcherTimer();
 	this->transfer_clock->Tick += ref new EventHandler<Platform::Object^>(this, &UniverseDisplay::do_refresh);
 
@@ -378,6 +573,7 @@ UniverseDisplay::UniverseDisplay(DisplayFit mode, float dwidth, float dheight, f
 		this->display->SizeChanged += ref new SizeChangedEventHandler(this, &UniverseDisplay::do_resize);
 		this->display->CreateResources += ref new UniverseLoadHandler(this, &UniverseDisplay::do_construct);
 		this->display->Draw += ref new UniverseDrawHandler(this, &UniverseDisplay::do_paint);
+		this->display->Loaded += ref new RoutedEventHandler(this, &UniverseDisplay::do_loaded);
 
 		this->display->PointerPressed += ref new PointerEventHandler(this, &UniverseDisplay::on_pointer_pressed);
 		this->display->PointerMoved += ref new PointerEventHandler(this, &UniverseDisplay::on_pointer_moved);
@@ -386,6 +582,8 @@ UniverseDisplay::UniverseDisplay(DisplayFit mode, float dwidth, float dheight, f
 
 		CoreWindow::GetForCurrentThread()->CharacterReceived +=
 			ref new TypedEventHandler<CoreWindow^, CharacterReceivedEventArgs^>(this, &UniverseDisplay::on_character);
+		CoreWindow::GetForCurrentThread()->VisibilityChanged +=
+			ref new TypedEventHandler<CoreWindow^, VisibilityChangedEventArgs^>(this, &UniverseDisplay::do_visibility_changed);
 	}
 
 	{ // initialize masks
@@ -409,6 +607,7 @@ void UniverseDisplay::register_virtual_keydown_event_handler(UIElement^ target)
 
 UniverseDisplay::~UniverseDisplay() {
 	this->transfer_clock->Stop();
+	this->mirror_to(nullptr);
 	this->collapse();
 	
 	if (this->headup_planet != nullptr) {
@@ -445,11 +644,21 @@ CanvasDevice^ UniverseDisplay::device::get() {
 }
 
 float UniverseDisplay::actual_width::get() {
-	return float(this->display->Size.Width);
+	return this->region_size().Width;
 }
 
 float UniverseDisplay::actual_height::get() {
-	return float(this->display->Size.Height);
+	return this->region_size().Height;
+}
+
+Size UniverseDisplay::region_size() {
+	Size region = this->display->Size;
+
+	if (this->source_resolution_used()) {
+		this->fill_source_size(&region.Width, &region.Height);
+	}
+
+	return region;
 }
 
 void UniverseDisplay::global_mask_alpha::set(double v) {
@@ -482,12 +691,172 @@ bool UniverseDisplay::surface_ready() {
 }
 
 void UniverseDisplay::refresh(IPlanet* which) {
-	if ((this->headup_planet == which) || (this->recent_planet == which)) {
+	// NOTE: planets being constructed are refreshed when they are done
+
+	if (which != nullptr) { // the snapshot taken for standby is outdated
+		PLANET_INFO(which)->standby_stale = true;
+	}
+
+	if (this->from_planet != nullptr) { // transferring, fallback to live drawing for planets that are still changing
+		if (which == this->from_planet) {
+			this->from_surface_stale = true;
+		} else if (which == this->recent_planet) {
+			this->to_surface_stale = true;
+		}
+	}
+
+	if (((this->headup_planet == which) || (this->recent_planet == which)) && planet_constructed(which)) {
+		this->refresh_requests += 1LL;
+
+		if (this->ticking && this->ui_thread_ready()) {
+			// repaints requested by the planets in the same round are coalesced into one
+			this->needs_redraw = true;
+		} else {
+			this->invalidate();
+		}
+	}
+}
+
+void UniverseDisplay::invalidate() {
+	if (!this->redraw_pending.exchange(true)) {
 		this->display->Invalidate();
 	}
 }
 
+void UniverseDisplay::rearm_redraw() {
+	/** NOTE
+	 * The latch is only cleared by `do_paint`, but the control silently drops the `Draw`
+	 *  when the device is lost, when it is not in the visual tree, or when the window is hidden,
+	 *  then every later `invalidate` would be swallowed forever.
+	 */
+	this->pending_ticks = 0U;
+	this->redraw_pending = false;
+	this->invalidate();
+}
+
+void UniverseDisplay::use_frame_governor(Timer^ timer, int active_rate, int idle_rate, unsigned int idle_frames) {
+	this->governor = timer;
+	this->governor_active_rate = active_rate;
+	this->governor_idle_rate = std::min(idle_rate, active_rate);
+	this->governor_idle_frames = std::max(idle_frames, 1U);
+	this->quiet_frames = 0U;
+	this->idling = false;
+
+	if (this->governor != nullptr) {
+		this->governor->set_frame_rate(this->governor_active_rate);
+	}
+}
+
+void UniverseDisplay::use_profiler(FrameProfiler* profiler) {
+	this->profiler = profiler;
+
+	if (this->headup_planet != nullptr) {
+		this->headup_planet->use_profiler(profiler);
+	}
+
+	if (this->head_planet != nullptr) {
+		IPlanet* child = this->head_planet;
+
+		do {
+			child->use_profiler(profiler);
+			child = PLANET_INFO(child)->next;
+		} while (child != this->head_planet);
+	}
+}
+
+void UniverseDisplay::mirror_to(IMirrorChannel* channel, unsigned int keyframe_interval, size_t queue_capacity) {
+	if (this->mirror_worker != nullptr) {
+		delete this->mirror_worker; // NOTE: it waits for the frame being sent
+		delete this->mirror_frame;
+	}
+
+	this->mirror_channel = channel;
+
+	if (this->mirror_channel != nullptr) {
+		this->mirror_worker = new MirrorWorker(channel, keyframe_interval, queue_capacity);
+		this->mirror_frame = new DisplayList();
+		this->invalidate();
+	} else {
+		this->mirror_worker = nullptr;
+		this->mirror_frame = nullptr;
+	}
+}
+
+void UniverseDisplay::fill_mirror_statistics(MirrorStatistics* stats) {
+	if (this->mirror_worker != nullptr) {
+		this->mirror_worker->fill_statistics(stats);
+	} else if (stats != nullptr) {
+		std::memset(stats, 0, sizeof(MirrorStatistics));
+	}
+}
+
+void UniverseDisplay::on_graphlet_removed(IPlanet* master, IGraphlet* g) {
+	if (this->mirror_worker != nullptr) {
+		// NOTE: scenes tag groups with renderables, see `DrawingScene`
+		this->mirror_worker->forget(static_cast<IDrawingRenderable*>(g));
+	}
+}
+
+void UniverseDisplay::mirror(float width, float height, float region_width, float region_height) {
+	// NOTE: the caller is inside the critical section, transferring frames are not mirrored.
+	//  Only recording happens here, the worker encodes and sends the frame in its own thread.
+	this->mirror_frame->reset();
+	this->mirror_frame->clear(drawing_color(0x000000, 0.0F));
+
+	if (this->recent_planet != nullptr) {
+		render_planet(this->mirror_frame, "planet", this->recent_planet,
+			this->hup_left_margin, this->hup_top_margin, width, height, this->get_logger());
+	}
+
+	if (this->headup_planet != nullptr) {
+		render_planet(this->mirror_frame, "heads-up", this->headup_planet, 0.0F, 0.0F, region_width, region_height, this->get_logger());
+	}
+
+	this->mirror_frame = this->mirror_worker->post(this->mirror_frame);
+}
+
+void UniverseDisplay::govern_frame_rate() {
+	if (this->governor != nullptr) {
+		bool busy = ((this->refresh_requests.exchange(0LL) > 0LL)
+			|| (this->from_planet != nullptr)
+			|| (this->figures.size() > 0));
+
+		if (busy) {
+			this->wake_up();
+		} else if (!this->idling) {
+			this->quiet_frames += 1U;
+
+			if (this->quiet_frames >= this->governor_idle_frames) {
+				this->get_logger()->log_message(Log::Debug, L"idle after %u quiet frames, slow down to %d fps",
+					this->quiet_frames, this->governor_idle_rate);
+
+				this->governor->set_frame_rate(this->governor_idle_rate);
+				this->idling = true;
+			}
+		}
+	}
+}
+
+void UniverseDisplay::wake_up() {
+	this->quiet_frames = 0U;
+
+	if (this->idling && (this->governor != nullptr)) {
+		this->get_logger()->log_message(Log::Debug, L"wake up, speed up to %d fps", this->governor_active_rate);
+
+		this->governor->set_frame_rate(this->governor_active_rate);
+		this->idling = false;
+	}
+}
+
 void UniverseDisplay::on_elapse(long long count, long long interval, long long uptime) {
+	this->ticking = true;
+
+	if (this->profiler != nullptr) {
+		this->profiler->begin_frame(count);
+	}
+
+	this->apply_published_states();
+
 	if (this->headup_planet != nullptr) {
 		this->headup_planet->begin_update_sequence();
 		this->headup_planet->on_elapse(count, interval, uptime);
@@ -497,17 +866,48 @@ void UniverseDisplay::on_elapse(long long count, long long interval, long long u
 	if (this->head_planet != nullptr) {
 		IPlanet* child = PLANET_INFO(this->recent_planet)->next;
 		
-		this->recent_planet->begin_update_sequence();
-		this->recent_planet->on_elapse(count, interval, uptime);
-		this->recent_planet->end_update_sequence();
+		elapse_planet(this->recent_planet, count, interval, uptime, true);
 
 		while (child != this->recent_planet) {
-			child->on_elapse(count, interval, uptime);
+			if (child == this->from_planet) { // it is still visible during the transferring
+				elapse_planet(child, count, interval, uptime, false);
+			} else {
+				this->elapse_hidden_planet(child, count, interval, uptime);
+			}
+
 			child = PLANET_INFO(child)->next;
 		}
 	}
 
+	this->last_count = count;
+	this->last_interval = interval;
+	this->last_uptime = uptime;
+
+	if ((this->standby_capacity > 0U) && (this->from_planet == nullptr)) {
+		// NOTE: hidden planets may refresh every tick, their snapshots are taken again at most once every `standby_frames` ticks
+		if ((count - this->standby_primed_count) >= (long long)(this->standby_frames)) {
+			this->prepare_standby();
+		}
+	}
+
 	this->update(count, interval, uptime);
+
+	this->ticking = false;
+	if (this->needs_redraw) {
+		this->needs_redraw = false;
+		this->invalidate();
+	}
+
+	if (this->redraw_pending) {
+		// NOTE: the Draw should have come within a couple of frames, otherwise it has been dropped
+		this->pending_ticks += 1U;
+
+		if (this->pending_ticks > 2U) {
+			this->rearm_redraw();
+		}
+	}
+
+	this->govern_frame_rate();
 }
 
 void UniverseDisplay::on_elapse(long long count, long long interval, long long uptime, long long elapsed) {
@@ -520,23 +920,92 @@ void UniverseDisplay::on_elapse(long long count, long long interval, long long u
 	if (this->head_planet != nullptr) {
 		IPlanet* child = PLANET_INFO(this->recent_planet)->next;
 
-		this->recent_planet->begin_update_sequence();
-		this->recent_planet->on_elapse(count, interval, uptime, elapsed);
-		this->recent_planet->end_update_sequence();
+		if (planet_constructed(this->recent_planet)) {
+			this->recent_planet->begin_update_sequence();
+			this->recent_planet->on_elapse(count, interval, uptime, elapsed);
+			this->recent_planet->end_update_sequence();
+		}
 
 		while (child != this->recent_planet) {
-			child->on_elapse(count, interval, uptime, elapsed);
+			if (PLANET_INFO(child)->last_count == count) { // only the ones elapsed in this round
+				child->on_elapse(count, interval, uptime, elapsed);
+			}
+
 			child = PLANET_INFO(child)->next;
 		}
 	}
 }
 
+void UniverseDisplay::apply_published_states() {
+	// NOTE: this is the frame boundary, states published since the previous frame become visible all together.
+
+	if (this->headup_planet != nullptr) {
+		this->headup_planet->apply_published_states();
+	}
+
+	if (this->head_planet != nullptr) {
+		IPlanet* child = this->head_planet;
+
+		do {
+			if (planet_constructed(child)) {
+				child->apply_published_states();
+			}
+
+			child = PLANET_INFO(child)->next;
+		} while (child != this->head_planet);
+	}
+}
+
+void UniverseDisplay::elapse_hidden_planet(IPlanet* planet, long long count, long long interval, long long uptime) {
+	PlanetInfo* info = PLANET_INFO(planet);
+
+	switch (this->background_ticking) {
+	case BackgroundTicking::Always: elapse_planet(planet, count, interval, uptime, false); break;
+	case BackgroundTicking::SyncOnly: sync_planet(planet, count, interval, uptime); break;
+	case BackgroundTicking::Throttled: {
+		if ((count - info->last_count) >= this->background_divisor) {
+			elapse_planet(planet, count, interval, uptime, false);
+		} else {
+			info->tick.skips += 1LL;
+		}
+	}; break;
+	}
+}
+
+void UniverseDisplay::catch_up(IPlanet* planet) {
+	if ((planet != nullptr) && (this->last_count > 0LL)) {
+		PlanetInfo* info = PLANET_INFO(planet);
+
+		if (info->last_count < this->last_count) {
+			// NOTE: planets that have never been elapsed (say, under `SyncOnly`) have been missing the whole uptime
+			long long gap = ((info->last_count > 0LL) ? (this->last_uptime - info->last_uptime) : this->last_uptime);
+
+			elapse_planet(planet, this->last_count, gap, this->last_uptime, true);
+		}
+	}
+}
+
+void UniverseDisplay::set_background_ticking(BackgroundTicking policy, unsigned int divisor) {
+	this->background_ticking = policy;
+	this->background_divisor = std::max(divisor, 1U);
+}
+
+void UniverseDisplay::fill_planet_tick_statistics(IPlanet* planet, PlanetTickStatistics* stats) {
+	if ((planet != nullptr) && (stats != nullptr) && (planet->info != nullptr)) {
+		if (planet->info->master == this) {
+			(*stats) = PLANET_INFO(planet)->tick;
+		}
+	}
+}
+
 void UniverseDisplay::push_planet(IPlanet* planet) {
 	// NOTE: this method is designed to be invoked before CreateResources event
 
 	if (planet->info == nullptr) {
 		PlanetInfo* info = bind_planet_owership(this, planet);
 		
+		planet->use_profiler(this->profiler);
+
 		if (this->head_planet == nullptr) {
 			this->head_planet = planet;
 			this->recent_planet = planet;
@@ -560,6 +1029,11 @@ void UniverseDisplay::push_planet(IPlanet* planet) {
 		}
 
 		info->next = this->head_planet;
+		info->index = this->planets.size();
+		this->planets.push_back(planet);
+
+		// NOTE: the first one wins if names are duplicate, as the linear search did
+		this->planet_indices.insert(std::make_pair(std::wstring(planet->name()->Data()), info->index));
 
 		if (this->universe_settings != nullptr) {
 			if (!this->universe_settings->Values->HasKey(page_setting_key)) {
@@ -572,24 +1046,24 @@ void UniverseDisplay::push_planet(IPlanet* planet) {
 void UniverseDisplay::transfer(int delta_idx, unsigned int ms, unsigned int count) {
 	if ((this->recent_planet != nullptr) && (delta_idx != 0) && (!this->transfer_clock->IsEnabled)) {
 		bool animating = ((ms * count) > 0);
+		IPlanet* departure = this->recent_planet;
+		int total = int(this->planets.size());
+		int idx = ((int(PLANET_INFO(departure)->index) + delta_idx % total) + total) % total;
 
 		if (this->from_planet == nullptr) {
 			this->from_planet = this->recent_planet;
 		}
 
 		this->enter_critical_section();
-		if (delta_idx > 0) {
-			for (int i = 0; i < delta_idx; i++) {
-				this->recent_planet = PLANET_INFO(this->recent_planet)->next;
-			}
-		} else {
-			for (int i = 0; i > delta_idx; i--) {
-				this->recent_planet = PLANET_INFO(this->recent_planet)->prev;
-			}
-		}
+		this->recent_planet = this->planets[idx];
 		this->leave_critical_section();
 
 		{ // trigger point
+			PLANET_INFO(departure)->followers[this->recent_planet] += 1U;
+
+			this->wake_up();
+			this->construct_on_demand(this->recent_planet, "on-demand");
+			this->catch_up(this->recent_planet);
 			this->_navigator->select(this->recent_planet);
 
 			if (this->universe_settings != nullptr) {
@@ -601,44 +1075,48 @@ void UniverseDisplay::transfer(int delta_idx, unsigned int ms, unsigned int coun
 
 		if (animating) {
 			TimeSpan ts = make_timespan_from_milliseconds(ms);
-			float width = this->display->Size.Width - this->hup_left_margin - this->hup_right_margin;
+			float width = this->actual_width - this->hup_left_margin - this->hup_right_margin;
+			float height = this->actual_height - this->hup_top_margin - this->hup_bottom_margin;
+			float dpi = (this->source_resolution_used() ? 96.0F : this->display->Dpi);
+
+			this->from_surface = cache_planet_surface(this->from_planet, width, height, dpi, this->get_logger());
+			this->to_surface = this->take_standby_surface(this->recent_planet, width, height, dpi);
 
-			ts.Duration = ms / count;
+			if (this->to_surface == nullptr) {
+				this->to_surface = cache_planet_surface(this->recent_planet, width, height, dpi, this->get_logger());
+			}
+
+			this->from_surface_stale = false;
+			this->to_surface_stale = false;
+
+			ts.Duration /= count;
 			this->transfer_clock->Interval = ts;
-			this->transfer_delta = width / float(count) * ((delta_idx > 0) ? -1.0F : 1.0F);
-			this->transferX = this->transfer_delta;
+			this->transfer_direction = ((delta_idx > 0) ? -1.0F : 1.0F);
+			this->transfer_steps = count;
+			this->transfer_step = 1U;
+			this->transferX = this->transfer_direction * width * transfer_ease(this->transfer_easing, 1.0F / float(count));
 			this->transfer_clock->Start();
 		} else {
 			this->get_logger()->log_message(Log::Debug, L"transferred immediately: %s ==> %s",
 				this->from_planet->name()->Data(), this->recent_planet->name()->Data());
 			this->from_planet = nullptr;
 			this->refresh(this->recent_planet);
+			this->prepare_standby();
 		}
 	}
 }
 
-void UniverseDisplay::transfer_to(Platform::String^ name, unsigned int ms, unsigned int count) {
-	int index = -1;
-	
-	if ((this->head_planet != nullptr) && (name != nullptr)) {
-		IPlanet* child = this->head_planet;
-		int idx = 0;
-
-		do {
-			PlanetInfo* info = PLANET_INFO(child);
-
-			if (child->name()->Equals(name)) {
-				index = idx;
-				break;
-			}
+void UniverseDisplay::set_transfer_easing(TransferEasing easing) {
+	this->transfer_easing = easing;
+}
 
-			idx += 1;
-			child = info->next;
-		} while (child != this->head_planet);
-	}
+void UniverseDisplay::transfer_to(Platform::String^ name, unsigned int ms, unsigned int count) {
+	if (name != nullptr) {
+		auto maybe_index = this->planet_indices.find(std::wstring(name->Data()));
 
-	if (index >= 0) {
-		this->transfer_to(index, ms, count);
+		if (maybe_index != this->planet_indices.end()) {
+			this->transfer_to(int(maybe_index->second), ms, count);
+		}
 	}
 }
 
@@ -669,6 +1147,8 @@ void UniverseDisplay::on_navigate(int from_index, int to_index) {
 }
 
 void UniverseDisplay::collapse() {
+	this->abandon_background_construction();
+
 	if (this->head_planet != nullptr) {
 		IPlanet* temp_head = this->head_planet;
 		PlanetInfo* temp_info = PLANET_INFO(temp_head);
@@ -678,12 +1158,23 @@ void UniverseDisplay::collapse() {
 		this->recent_planet = nullptr;
 		prev_info->next = nullptr;
 
+		this->planets.clear();
+		this->planet_indices.clear();
+		this->standby_planets.clear();
+		this->standby_primings.clear();
+		this->standby_anchor = nullptr;
+
 		do {
 			IPlanet* child = temp_head;
 
 			temp_head = PLANET_INFO(temp_head)->next;
 
-			delete child; // planet's destructor will delete the associated info object
+			if (PLANET_INFO(child)->construction == PlanetConstruction::Constructing) {
+				// NOTE: a worker is still constructing it, it is deleted when the worker is done, see `on_planet_constructed()`
+				this->abandoned_planets.push_back(child);
+			} else {
+				delete child; // planet's destructor will delete the associated info object
+			}
 		} while (temp_head != nullptr);
 	}
 }
@@ -695,7 +1186,9 @@ void UniverseDisplay::do_resize(Platform::Object^ sender, SizeChangedEventArgs^
 		float pwidth = args->PreviousSize.Width;
 		float pheight = args->PreviousSize.Height;
 
-		if ((nwidth > 0.0F) && (nheight > 0.0F) && ((nwidth != pwidth) || (nheight != pheight))) {
+		if (this->source_resolution_used()) { // planets keep their source size, only the scaling changes
+			this->invalidate();
+		} else if ((nwidth > 0.0F) && (nheight > 0.0F) && ((nwidth != pwidth) || (nheight != pheight))) {
 			this->get_logger()->log_message(Log::Debug, L"resize(%f, %f)", nwidth, nheight);
 
 			if (this->headup_planet != nullptr) {
@@ -719,109 +1212,621 @@ void UniverseDisplay::do_resize(Platform::Object^ sender, SizeChangedEventArgs^
 }
 
 void UniverseDisplay::do_construct(CanvasControl^ sender, CanvasCreateResourcesEventArgs^ args) {
-	Size region = this->display->Size;
+	Size region = this->region_size();
+	bool lazy = (this->lazy_construction && (args->Reason == CanvasCreateResourcesReason::FirstTime));
 	
 	this->get_logger()->log_message(Log::Debug, L"construct planets because of %s", args->Reason.ToString()->Data());
+	this->abandon_background_construction(); // NOTE: planets are about to be constructed here, say, after the device is lost
+	this->construction_reason = args->Reason;
+	this->source_surface = nullptr;
+
+	for (IPlanet* planet : this->standby_planets) { // snapshots of the lost device are useless
+		PLANET_INFO(planet)->standby_surface = nullptr;
+	}
+	this->startup_origin = current_100nanoseconds();
+	this->startup_pending = 0U;
+	this->pending_ticks = 0U;
+	this->redraw_pending = false;
 
 	if (this->headup_planet != nullptr) {
-		construct_planet(this->headup_planet, "heads-up", this->get_logger(), args->Reason, region.Width, region.Height);
+		long long start = current_100nanoseconds();
+		long long cost = construct_planet(this->headup_planet, "heads-up", this->get_logger(), args->Reason, region.Width, region.Height);
+
+		PLANET_INFO(this->headup_planet)->construction = PlanetConstruction::Constructed;
+		this->log_construction(this->headup_planet, start, cost, "heads-up");
 	}
 
 	this->construct(args->Reason);
+	this->resources_constructed = true;
 
 	if (this->head_planet != nullptr) {
 		IPlanet* child = this->head_planet;
-		Platform::String^ last_page = nullptr;
 		float width = region.Width - this->hup_left_margin - this->hup_right_margin;
 		float height = region.Height - this->hup_top_margin - this->hup_bottom_margin;
 
-		do {
-			PlanetInfo* info = PLANET_INFO(child);
+		if (!lazy) {
+			do {
+				PlanetInfo* info = PLANET_INFO(child);
 
-			construct_planet(child, "planet", this->get_logger(), args->Reason, width, height);
-			child = info->next;
-		} while (child != this->head_planet);
+				if (info->construction == PlanetConstruction::Constructing) {
+					// NOTE: a worker is still constructing it with former resources, it is constructed again when the worker is done
+				} else {
+					long long start = current_100nanoseconds();
+					long long cost = construct_planet(child, "planet", this->get_logger(), args->Reason, width, height);
+
+					info->construction = PlanetConstruction::Constructed;
+					this->log_construction(child, start, cost, "planet");
+				}
 
+				child = info->next;
+			} while (child != this->head_planet);
+		}
 
+		// NOTE: with lazy construction, the persisted page is constructed on demand here
 		if (this->universe_settings != nullptr) {
 			this->transfer_to(this->universe_settings->Values->Lookup(page_setting_key)->ToString());
 		}
 
 		if ((this->recent_planet == this->head_planet) && (this->recent_planet != nullptr)) {
+			this->construct_on_demand(this->recent_planet, "first");
 			this->notify_transfer(nullptr, this->recent_planet);
 		}
+
+		if (lazy) {
+			this->schedule_lazy_construction();
+		}
+
+		this->prepare_standby();
+	}
+
+	this->get_logger()->log_message(Log::Info, L"startup[+%.1lfms]: the first page[%s] is ready, %u planet(s) are deferred",
+		double(current_100nanoseconds() - this->startup_origin) / 10000.0,
+		((this->recent_planet == nullptr) ? L"" : this->recent_planet->name()->Data()),
+		this->startup_pending);
+}
+
+void UniverseDisplay::use_lazy_construction(bool yes, unsigned int background_workers) {
+	this->lazy_construction = yes;
+	this->lazy_workers = background_workers;
+}
+
+void UniverseDisplay::schedule_lazy_construction() {
+	IPlanet* next = PLANET_INFO(this->recent_planet)->next;
+	IPlanet* prev = PLANET_INFO(this->recent_planet)->prev;
+	std::deque<IPlanet*> backgrounds;
+
+	// NOTE: neighbours first, in the order of their distances to the current page
+	while (true) {
+		IPlanet* candidates[] = { next, prev };
+
+		for (unsigned int idx = 0; idx < (sizeof(candidates) / sizeof(IPlanet*)); idx++) {
+			IPlanet* p = candidates[idx];
+
+			if ((PLANET_INFO(p)->construction == PlanetConstruction::Pending)
+				&& (std::find(backgrounds.begin(), backgrounds.end(), p) == backgrounds.end())
+				&& (std::find(this->idle_constructions.begin(), this->idle_constructions.end(), p) == this->idle_constructions.end())) {
+				if ((this->lazy_workers > 0U) && p->can_construct_in_background()) {
+					backgrounds.push_back(p);
+				} else {
+					this->idle_constructions.push_back(p);
+				}
+
+				this->startup_pending += 1U;
+			}
+		}
+
+		if ((next == prev) || (PLANET_INFO(next)->next == prev)) {
+			break;
+		}
+
+		next = PLANET_INFO(next)->next;
+		prev = PLANET_INFO(prev)->prev;
+	}
+
+	if (!backgrounds.empty()) {
+		UniverseDisplay^ self = this; // NOTE: lambdas capture `this` as a raw pointer, the handle keeps the display alive
+		CoreDispatcher^ dispatcher = this->display->Dispatcher;
+		CanvasCreateResourcesReason reason = this->construction_reason;
+		Size region = this->region_size();
+		float width = region.Width - this->hup_left_margin - this->hup_right_margin;
+		float height = region.Height - this->hup_top_margin - this->hup_bottom_margin;
+		Syslog* logger = this->get_logger();
+		unsigned int workers = std::min(this->lazy_workers, (unsigned int)(backgrounds.size()));
+		unsigned int generation = 0U;
+
+		this->construction_section.lock();
+		this->background_constructions.swap(backgrounds);
+		generation = this->construction_generation;
+		this->construction_section.unlock();
+
+		for (unsigned int idx = 0; idx < workers; idx++) {
+			create_task([=]() {
+				IPlanet* planet = nullptr;
+
+				while ((planet = self->take_background_construction()) != nullptr) {
+					long long start = current_100nanoseconds();
+					long long cost = construct_planet(planet, "planet", logger, reason, width, height);
+
+					dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([=]() {
+						self->on_planet_constructed(planet, start, cost, generation);
+					}));
+				}
+			});
+		}
+	}
+
+	if (!this->idle_constructions.empty()) {
+		this->display->Dispatcher->RunIdleAsync(ref new IdleDispatchedHandler([=](IdleDispatchedHandlerArgs^ args) {
+			this->construct_idle_planet();
+		}));
+	}
+}
+
+IPlanet* UniverseDisplay::take_background_construction() {
+	IPlanet* planet = nullptr;
+
+	this->construction_section.lock();
+
+	while ((planet == nullptr) && (!this->background_constructions.empty())) {
+		planet = this->background_constructions.front();
+		this->background_constructions.pop_front();
+
+		if (!claim_planet_construction(planet)) { // it has been constructed on demand
+			planet = nullptr;
+		}
+	}
+
+	this->construction_section.unlock();
+
+	return planet;
+}
+
+void UniverseDisplay::abandon_background_construction() {
+	/** NOTE
+	 * Queued planets are left pending, and the UI thread never waits for workers,
+	 *  planets in the hands of workers stay `Constructing` until their results come back in `on_planet_constructed()`,
+	 *  which constructs them again, or deletes them if they have been collapsed since then.
+	 */
+	std::unique_lock<std::mutex> lock(this->construction_section);
+
+	this->background_constructions.clear();
+	this->construction_generation += 1U;
+	this->idle_constructions.clear();
+}
+
+void UniverseDisplay::construct_idle_planet() {
+	while (!this->idle_constructions.empty()) {
+		IPlanet* planet = this->idle_constructions.front();
+
+		this->idle_constructions.pop_front();
+
+		if (PLANET_INFO(planet)->construction == PlanetConstruction::Pending) {
+			this->construct_on_demand(planet, "idle");
+			break;
+		}
+	}
+
+	if (!this->idle_constructions.empty()) { // one planet per idle slot, so that the UI keeps responsive
+		this->display->Dispatcher->RunIdleAsync(ref new IdleDispatchedHandler([=](IdleDispatchedHandlerArgs^ args) {
+			this->construct_idle_planet();
+		}));
+	}
+}
+
+void UniverseDisplay::construct_on_demand(IPlanet* planet, Platform::String^ how) {
+	if (this->resources_constructed && claim_planet_construction(planet)) {
+		Size region = this->region_size();
+		float width = region.Width - this->hup_left_margin - this->hup_right_margin;
+		float height = region.Height - this->hup_top_margin - this->hup_bottom_margin;
+		long long start = current_100nanoseconds();
+		long long cost = construct_planet(planet, "planet", this->get_logger(), this->construction_reason, width, height);
+
+		PLANET_INFO(planet)->construction = PlanetConstruction::Constructed;
+		this->log_construction(planet, start, cost, how);
+		this->settle_lazy_construction();
+	}
+}
+
+void UniverseDisplay::on_planet_constructed(IPlanet* planet, long long start, long long cost, unsigned int generation) {
+	auto maybe_abandoned = std::find(this->abandoned_planets.begin(), this->abandoned_planets.end(), planet);
+	bool current = false;
+
+	this->construction_section.lock();
+	current = (generation == this->construction_generation);
+	this->construction_section.unlock();
+
+	if (maybe_abandoned != this->abandoned_planets.end()) {
+		this->abandoned_planets.erase(maybe_abandoned);
+		delete planet;
+	} else if (!current) { // constructed with former resources, say, the device has been lost since then
+		PLANET_INFO(planet)->construction = PlanetConstruction::Pending;
+
+		if (this->resources_constructed) {
+			this->idle_constructions.push_back(planet);
+
+			if (this->idle_constructions.size() == 1U) {
+				this->display->Dispatcher->RunIdleAsync(ref new IdleDispatchedHandler([=](IdleDispatchedHandlerArgs^ args) {
+					this->construct_idle_planet();
+				}));
+			}
+		}
+	} else {
+		Size region = this->region_size();
+
+		PLANET_INFO(planet)->construction = PlanetConstruction::Constructed;
+		this->log_construction(planet, start, cost, "background");
+
+		// NOTE: the region may have changed during the construction
+		reflow_planet(planet,
+			region.Width - this->hup_left_margin - this->hup_right_margin,
+			region.Height - this->hup_top_margin - this->hup_bottom_margin);
+
+		if (planet == this->recent_planet) { // it has been transferred to before being ready
+			this->catch_up(planet);
+			planet->on_transfer(nullptr, planet);
+			this->refresh(planet);
+		}
+
+		this->settle_lazy_construction();
+	}
+}
+
+void UniverseDisplay::use_warm_standby(unsigned int capacity, unsigned int standby_frames) {
+	this->standby_capacity = capacity;
+	this->standby_frames = std::max(standby_frames, 1U);
+	this->standby_anchor = nullptr;
+
+	if (this->standby_capacity == 0U) {
+		for (IPlanet* planet : this->standby_planets) {
+			PLANET_INFO(planet)->standby_surface = nullptr;
+		}
+
+		this->standby_planets.clear();
+		this->standby_primings.clear();
+	} else {
+		this->prepare_standby();
+	}
+}
+
+void UniverseDisplay::prepare_standby() {
+	Size region = this->region_size();
+
+	if ((this->standby_capacity > 0U) && (this->recent_planet != nullptr) && this->resources_constructed
+		&& ((this->standby_anchor != this->recent_planet) || (this->standby_width != region.Width) || (this->standby_height != region.Height))) {
+		PlanetInfo* info = PLANET_INFO(this->recent_planet);
+		std::vector<std::pair<IPlanet*, unsigned int>> visited(info->followers.begin(), info->followers.end());
+		std::vector<IPlanet*> standbys;
+		IPlanet* next = info->next;
+		IPlanet* prev = info->prev;
+
+		std::stable_sort(visited.begin(), visited.end(), [](std::pair<IPlanet*, unsigned int> lhs, std::pair<IPlanet*, unsigned int> rhs) {
+			return lhs.second > rhs.second;
+		});
+
+		for (auto it = visited.begin(); (it != visited.end()) && (standbys.size() < this->standby_capacity); it++) {
+			if (it->first != this->recent_planet) {
+				standbys.push_back(it->first);
+			}
+		}
+
+		// NOTE: neighbours fill the rest, in the order of their distances to the current page
+		while ((standbys.size() < this->standby_capacity) && (next != this->recent_planet)) {
+			IPlanet* candidates[] = { next, prev };
+
+			for (IPlanet* candidate : candidates) {
+				if ((standbys.size() < this->standby_capacity) && (candidate != this->recent_planet)) {
+					if (std::find(standbys.begin(), standbys.end(), candidate) == standbys.end()) {
+						standbys.push_back(candidate);
+					}
+				}
+			}
+
+			if ((next == prev) || (PLANET_INFO(next)->next == prev)) {
+				break;
+			}
+
+			next = PLANET_INFO(next)->next;
+			prev = PLANET_INFO(prev)->prev;
+		}
+
+		for (IPlanet* planet : this->standby_planets) {
+			if (std::find(standbys.begin(), standbys.end(), planet) == standbys.end()) {
+				PLANET_INFO(planet)->standby_surface = nullptr;
+			}
+		}
+
+		this->standby_planets.swap(standbys);
+		this->standby_primings.clear();
+		this->standby_anchor = this->recent_planet;
+		this->standby_width = region.Width;
+		this->standby_height = region.Height;
+	}
+
+	this->schedule_standby_priming();
+}
+
+void UniverseDisplay::schedule_standby_priming() {
+	this->standby_primed_count = this->last_count;
+
+	for (IPlanet* planet : this->standby_planets) {
+		PlanetInfo* info = PLANET_INFO(planet);
+
+		// NOTE: pages that are already waiting for being primed are not queued twice
+		if ((info->standby_surface == nullptr) || info->standby_stale) {
+			if (std::find(this->standby_primings.begin(), this->standby_primings.end(), planet) == this->standby_primings.end()) {
+				this->standby_primings.push_back(planet);
+			}
+		}
+	}
+
+	if ((!this->standby_primings.empty()) && (!this->standby_scheduled)) {
+		this->standby_scheduled = true;
+		this->display->Dispatcher->RunIdleAsync(ref new IdleDispatchedHandler([=](IdleDispatchedHandlerArgs^ args) {
+			this->prime_standby_planet();
+		}));
+	}
+}
+
+void UniverseDisplay::prime_standby_planet() {
+	this->standby_scheduled = false;
+
+	// NOTE: transfers prepare the standby set again when they are done
+	if ((!this->standby_primings.empty()) && (this->from_planet == nullptr)) {
+		IPlanet* planet = this->standby_primings.front();
+		PlanetInfo* info = PLANET_INFO(planet);
+
+		this->standby_primings.pop_front();
+
+		if (planet != this->recent_planet) {
+			this->construct_on_demand(planet, "standby");
+
+			if (planet_constructed(planet) && ((info->standby_surface == nullptr) || info->standby_stale)) {
+				Size region = this->region_size();
+				float width = region.Width - this->hup_left_margin - this->hup_right_margin;
+				float height = region.Height - this->hup_top_margin - this->hup_bottom_margin;
+				float dpi = (this->source_resolution_used() ? 96.0F : this->display->Dpi);
+
+				this->catch_up(planet);
+				info->standby_stale = false;
+				info->standby_surface = cache_planet_surface(planet, width, height, dpi, this->get_logger());
+			}
+		}
+
+		if (!this->standby_primings.empty()) { // one planet per idle slot, so that the UI keeps responsive
+			this->standby_scheduled = true;
+			this->display->Dispatcher->RunIdleAsync(ref new IdleDispatchedHandler([=](IdleDispatchedHandlerArgs^ args) {
+				this->prime_standby_planet();
+			}));
+		}
+	}
+}
+
+CanvasRenderTarget^ UniverseDisplay::take_standby_surface(IPlanet* planet, float width, float height, float dpi) {
+	PlanetInfo* info = PLANET_INFO(planet);
+	CanvasRenderTarget^ surface = info->standby_surface;
+
+	if (surface != nullptr) {
+		if (info->standby_stale || (surface->Size.Width != width) || (surface->Size.Height != height) || (surface->Dpi != dpi)) {
+			surface = nullptr;
+		}
+	}
+
+	info->standby_surface = nullptr; // the page is no longer standing by once it is visited
+
+	return surface;
+}
+
+void UniverseDisplay::settle_lazy_construction() {
+	if (this->startup_pending > 0U) {
+		this->startup_pending -= 1U;
+
+		if (this->startup_pending == 0U) {
+			this->get_logger()->log_message(Log::Info, L"startup[+%.1lfms]: all planets are ready",
+				double(current_100nanoseconds() - this->startup_origin) / 10000.0);
+		}
+	}
+}
+
+void UniverseDisplay::log_construction(IPlanet* planet, long long start, long long cost, Platform::String^ how) {
+	this->get_logger()->log_message(Log::Info, L"startup[+%.1lfms]: %s[%s] is constructed in %.1lfms",
+		double(start - this->startup_origin) / 10000.0, how->Data(), planet->name()->Data(), double(cost) / 10000.0);
+}
+
+void UniverseDisplay::do_loaded(Platform::Object^ sender, RoutedEventArgs^ args) {
+	this->rearm_redraw();
+}
+
+void UniverseDisplay::do_visibility_changed(CoreWindow^ sender, VisibilityChangedEventArgs^ args) {
+	if (args->Visible) {
+		this->wake_up();
+		this->rearm_redraw();
 	}
 }
 
 void UniverseDisplay::do_paint(CanvasControl^ sender, CanvasDrawEventArgs^ args) {
 	CanvasDrawingSession^ ds = args->DrawingSession;
-	Size region = this->display->Size;
+	Size region = this->region_size();
 
 	// NOTE: only the heads-up planet, current planet and the one transferred from need to be drawn
 
+	this->pending_ticks = 0U;
+	this->redraw_pending = false;
 	this->enter_critical_section();
 
+	if (this->source_resolution_used()) {
+		this->paint_source_surface(ds);
+	} else {
+		this->paint_planets(ds, region.Width, region.Height, nullptr);
+	}
+
+	if ((this->mirror_channel != nullptr) && (this->from_planet == nullptr)) {
+		this->mirror(region.Width - this->hup_left_margin - this->hup_right_margin,
+			region.Height - this->hup_top_margin - this->hup_bottom_margin,
+			region.Width, region.Height);
+	}
+
+	this->leave_critical_section();
+	
+	{ // draw mask to simulate the brightness
+		CanvasSolidColorBrush^ mask_color = (this->follow_global_mask_setting ? global_mask_color : this->mask_color);
+
+		if (mask_color->Color.A != 0) {
+			ds->FillRectangle(0.0F, 0.0F, this->display->Size.Width, this->display->Size.Height, mask_color);
+		}
+	}
+}
+
+void UniverseDisplay::paint_planets(CanvasDrawingSession^ ds, float region_width, float region_height, Rect* damage) {
 	if (this->recent_planet != nullptr) {
-		float width = region.Width - this->hup_left_margin - this->hup_right_margin;
-		float height = region.Height - this->hup_top_margin - this->hup_bottom_margin;
+		float width = region_width - this->hup_left_margin - this->hup_right_margin;
+		float height = region_height - this->hup_top_margin - this->hup_bottom_margin;
 
 		if (this->from_planet == nullptr) {
-			if ((width == region.Width) && (height == region.Height)) {
-				draw_planet(ds, "planet", this->recent_planet, width, height, this->get_logger());
+			Rect local_damage;
+
+			if (damage != nullptr) {
+				local_damage = Rect(damage->X - this->hup_left_margin, damage->Y - this->hup_top_margin, damage->Width, damage->Height);
+			}
+
+			if ((width == region_width) && (height == region_height)) {
+				draw_planet(ds, "planet", this->recent_planet, width, height, this->get_logger(), ((damage == nullptr) ? nullptr : &local_damage));
 			} else {
 				float3x2 identity = ds->Transform;
 
 				ds->Transform = make_translation_matrix(this->hup_left_margin, this->hup_top_margin);
-				draw_planet(ds, "planet", this->recent_planet, width, height, this->get_logger());
+				draw_planet(ds, "planet", this->recent_planet, width, height, this->get_logger(), ((damage == nullptr) ? nullptr : &local_damage));
 				ds->Transform = identity;
 			}
 		} else {
-			float deltaX = ((this->transferX < 0.0F) ? width : -width);
+			CanvasRenderTarget^ from_surface = (this->from_surface_stale ? nullptr : this->from_surface);
+			CanvasRenderTarget^ to_surface = (this->to_surface_stale ? nullptr : this->to_surface);
+			float deltaX = ((this->transfer_direction < 0.0F) ? width : -width);
 			float tx = this->transferX + this->hup_left_margin;
 			float ty = this->hup_top_margin;
-			float3x2 identity = ds->Transform;
 
-			ds->Transform = make_translation_matrix(tx, ty);
-			draw_planet(ds, "planet", this->from_planet, width, height, this->get_logger());
+			draw_transferring_planet(ds, this->from_planet, from_surface, tx, ty, width, height, this->get_logger());
+			draw_transferring_planet(ds, this->recent_planet, to_surface, tx + deltaX, ty, width, height, this->get_logger());
+		}
+	}
 
-			ds->Transform = make_translation_matrix(tx + deltaX, ty);
-			draw_planet(ds, "planet", this->recent_planet, width, height, this->get_logger());
+	if (this->headup_planet != nullptr) {
+		draw_planet(ds, "heads-up", this->headup_planet, region_width, region_height, this->get_logger(), damage);
+	}
+}
 
-			ds->Transform = identity;
-		}
+void UniverseDisplay::paint_source_surface(CanvasDrawingSession^ ds) {
+	Size region = this->region_size();
+	float left = region.Width;
+	float top = region.Height;
+	float right = 0.0F;
+	float bottom = 0.0F;
+
+	if ((this->source_surface == nullptr) || (this->source_surface->Device != ds->Device)) {
+		this->source_surface = ref new CanvasRenderTarget(ds, region.Width, region.Height, 96.0F);
+		this->source_damaged = true;
+	}
+
+	// NOTE: damages are taken even if the whole surface is going to be redrawn, or they would leak into the next frame
+	if (this->recent_planet != nullptr) {
+		take_planet_damage(this->recent_planet, this->hup_left_margin, this->hup_top_margin, &left, &top, &right, &bottom);
 	}
 
 	if (this->headup_planet != nullptr) {
-		draw_planet(ds, "heads-up", this->headup_planet, region.Width, region.Height, this->get_logger());
+		take_planet_damage(this->headup_planet, 0.0F, 0.0F, &left, &top, &right, &bottom);
 	}
 
-	this->leave_critical_section();
-	
-	{ // draw mask to simulate the brightness
-		CanvasSolidColorBrush^ mask_color = (this->follow_global_mask_setting ? global_mask_color : this->mask_color);
+	if (this->source_damaged || (this->from_planet != nullptr)) {
+		left = 0.0F;
+		top = 0.0F;
+		right = region.Width;
+		bottom = region.Height;
 
-		if (mask_color->Color.A != 0) {
-			ds->FillRectangle(0.0F, 0.0F, region.Width, region.Height, mask_color);
+		// the frame after the transfer redraws the whole surface since planets' damages are meaningless during the transfer
+		this->source_damaged = (this->from_planet != nullptr);
+	} else {
+		left = std::fmaxf(left, 0.0F);
+		top = std::fmaxf(top, 0.0F);
+		right = std::fminf(right, region.Width);
+		bottom = std::fminf(bottom, region.Height);
+	}
+
+	if ((right > left) && (bottom > top)) {
+		CanvasDrawingSession^ sds = this->source_surface->CreateDrawingSession();
+		Rect damage(left, top, right - left, bottom - top);
+		CanvasActiveLayer^ clip = sds->CreateLayer(1.0F, damage);
+
+		sds->Blend = CanvasBlend::Copy;
+		sds->FillRectangle(damage, Colours::Transparent);
+		sds->Blend = CanvasBlend::SourceOver;
+
+		this->paint_planets(sds, region.Width, region.Height, &damage);
+
+		delete clip; // Must Close the Layer Explicitly, it is C++/CX's quirk.
+		delete sds;
+	}
+
+	ds->DrawImage(this->source_surface, this->source_destination(), Rect(0.0F, 0.0F, region.Width, region.Height));
+}
+
+Rect UniverseDisplay::source_destination() {
+	Size region = this->region_size();
+	Size canvas = this->display->Size;
+	Rect destination(0.0F, 0.0F, canvas.Width, canvas.Height);
+
+	if (this->source_resolution_used() && (this->fit_mode() == DisplayFit::Contain)) { // keep the aspect ratio
+		float scale = std::fminf(canvas.Width / region.Width, canvas.Height / region.Height);
+
+		destination.Width = region.Width * scale;
+		destination.Height = region.Height * scale;
+		destination.X = (canvas.Width - destination.Width) * 0.5F;
+		destination.Y = (canvas.Height - destination.Height) * 0.5F;
+	}
+
+	return destination;
+}
+
+Point UniverseDisplay::source_point(Point position) {
+	Point point = position;
+
+	if (this->source_resolution_used()) {
+		Size region = this->region_size();
+		Rect destination = this->source_destination();
+
+		if ((destination.Width > 0.0F) && (destination.Height > 0.0F)) {
+			point.X = (position.X - destination.X) * region.Width / destination.Width;
+			point.Y = (position.Y - destination.Y) * region.Height / destination.Height;
 		}
 	}
+
+	return point;
 }
 
 void UniverseDisplay::do_refresh(Platform::Object^ sender, Platform::Object^ args) {
 	const wchar_t* from = this->from_planet->name()->Data();
 	const wchar_t* to = this->recent_planet->name()->Data();
-	float width = this->display->Size.Width - this->hup_left_margin - this->hup_right_margin;
-	float percentage = abs(this->transferX) / width;
+	float width = this->actual_width - this->hup_left_margin - this->hup_right_margin;
+	float percentage = float(this->transfer_step) / float(this->transfer_steps);
 
-	if (percentage < 1.0F) {
+	if (this->transfer_step < this->transfer_steps) {
 		this->get_logger()->log_message(Log::Debug, L"transferring[%.2f%%]: %s ==> %s", percentage * 100.0F, from, to);
-		this->display->Invalidate();
-		this->transferX += this->transfer_delta;
+		this->invalidate();
+		this->transfer_step += 1U;
+		this->transferX = this->transfer_direction * width
+			* transfer_ease(this->transfer_easing, float(this->transfer_step) / float(this->transfer_steps));
 	} else {
 		this->get_logger()->log_message(Log::Debug, L"transferred[%.2f%%]: %s ==> %s", percentage * 100.0F, from, to);
-		this->transfer_delta = 0.0F;
+		this->transfer_clock->Stop();
+
+		this->enter_critical_section();
+		this->transfer_direction = 0.0F;
 		this->transferX = 0.0F;
 		this->from_planet = nullptr;
-		this->transfer_clock->Stop();
+		this->from_surface = nullptr;
+		this->to_surface = nullptr;
+		this->leave_critical_section();
+
+		this->invalidate();
+		this->prepare_standby();
 	}
 }
 
@@ -858,6 +1863,8 @@ float UniverseDisplay::planet_actual_height(IPlanet* p) {
 }
 
 void UniverseDisplay::on_pointer_pressed(Platform::Object^ sender, PointerRoutedEventArgs^ args) {
+	this->wake_up();
+
 	if (this->canvas->CapturePointer(args->Pointer)) {
 		this->enter_critical_section();
 
@@ -867,8 +1874,9 @@ void UniverseDisplay::on_pointer_pressed(Platform::Object^ sender, PointerRouted
 			PointerPoint^ pp = args->GetCurrentPoint(this->canvas);
 			PointerDeviceType pdt = args->Pointer->PointerDeviceType;
 			PointerUpdateKind puk = pp->Properties->PointerUpdateKind;
-			float px = pp->Position.X - this->hup_left_margin;
-			float py = pp->Position.Y - this->hup_top_margin;
+			Point position = this->source_point(pp->Position);
+			float px = position.X - this->hup_left_margin;
+			float py = position.Y - this->hup_top_margin;
 
 			this->figures.insert(std::pair<unsigned int, PointerUpdateKind>(id, puk));
 
@@ -881,10 +1889,10 @@ void UniverseDisplay::on_pointer_pressed(Platform::Object^ sender, PointerRouted
 				this->figure_x0 = std::nanf("swipe");
 
 				if (this->headup_planet != nullptr) {
-					handled = this->headup_planet->on_pointer_pressed(pp->Position.X, pp->Position.Y, pdt, puk);
+					handled = this->headup_planet->on_pointer_pressed(position.X, position.Y, pdt, puk);
 				}
 
-				if ((!handled) && (this->recent_planet != nullptr)) {
+				if ((!handled) && planet_constructed(this->recent_planet)) {
 					handled = this->recent_planet->on_pointer_pressed(px, py, pdt, puk);
 				}
 
@@ -902,9 +1910,15 @@ void UniverseDisplay::on_pointer_moved(Platform::Object^ sender, PointerRoutedEv
 	if ((this->headup_planet != nullptr) || (this->recent_planet != nullptr)) {
 		PointerPoint^ pp = args->GetCurrentPoint(this->canvas);
 		PointerDeviceType pdt = args->Pointer->PointerDeviceType;
-		float px = pp->Position.X - this->hup_left_margin;
-		float py = pp->Position.Y - this->hup_top_margin;
+		Point position = this->source_point(pp->Position);
+		float px = position.X - this->hup_left_margin;
+		float py = position.Y - this->hup_top_margin;
 		
+		if (pp->IsInContact || (this->figure_x0 >= 0.0F)) {
+			// NOTE: plain hovering is not an activity, otherwise resting the mouse on the display never lets it idle
+			this->wake_up();
+		}
+
 		if (this->figure_x0 >= 0.0F) {
 			this->figure_x = px;
 			args->Handled = true;
@@ -912,10 +1926,10 @@ void UniverseDisplay::on_pointer_moved(Platform::Object^ sender, PointerRoutedEv
 			bool handled = false;
 
 			if (this->headup_planet != nullptr) {
-				handled = this->headup_planet->on_pointer_moved(pp->Position.X, pp->Position.Y, pdt, pp->Properties->PointerUpdateKind);
+				handled = this->headup_planet->on_pointer_moved(position.X, position.Y, pdt, pp->Properties->PointerUpdateKind);
 			}
 
-			if ((!handled) && (this->recent_planet != nullptr)) {
+			if ((!handled) && planet_constructed(this->recent_planet)) {
 				handled = this->recent_planet->on_pointer_moved(px, py, pdt, pp->Properties->PointerUpdateKind);
 			}
 
@@ -935,8 +1949,9 @@ void UniverseDisplay::on_pointer_released(Platform::Object^ sender, PointerRoute
 		if ((this->headup_planet != nullptr) || (this->recent_planet != nullptr)) {
 			PointerPoint^ pp = args->GetCurrentPoint(this->canvas);
 			PointerDeviceType pdt = args->Pointer->PointerDeviceType;
-			float px = pp->Position.X - this->hup_left_margin;
-			float py = pp->Position.Y - this->hup_top_margin;
+			Point position = this->source_point(pp->Position);
+			float px = position.X - this->hup_left_margin;
+			float py = position.Y - this->hup_top_margin;
 
 			if (std::isnan(this->figure_x0)) {
 				bool handled = false;
@@ -944,10 +1959,10 @@ void UniverseDisplay::on_pointer_released(Platform::Object^ sender, PointerRoute
 				this->enter_critical_section();
 
 				if (this->headup_planet != nullptr) {
-					handled = this->headup_planet->on_pointer_released(pp->Position.X, pp->Position.Y, pdt, it->second);
+					handled = this->headup_planet->on_pointer_released(position.X, position.Y, pdt, it->second);
 				}
 
-				if ((!handled) && (this->recent_planet != nullptr)) {
+				if ((!handled) && planet_constructed(this->recent_planet)) {
 					handled = this->recent_planet->on_pointer_released(px, py, pdt, it->second);
 				}
 
@@ -981,17 +1996,18 @@ void UniverseDisplay::on_pointer_moveout(Platform::Object^ sender, PointerRouted
 	if ((this->headup_planet != nullptr) || (this->recent_planet != nullptr)) {
 		PointerPoint^ pp = args->GetCurrentPoint(this->canvas);
 		PointerDeviceType pdt = args->Pointer->PointerDeviceType;
-		float px = pp->Position.X - this->hup_left_margin;
-		float py = pp->Position.Y - this->hup_top_margin;
+		Point position = this->source_point(pp->Position);
+		float px = position.X - this->hup_left_margin;
+		float py = position.Y - this->hup_top_margin;
 
 		if (this->figures.size() == 0) {
 			bool handled = false;
 
 			if (this->headup_planet != nullptr) {
-				handled = this->headup_planet->on_pointer_moveout(pp->Position.X, pp->Position.Y, pdt, pp->Properties->PointerUpdateKind);
+				handled = this->headup_planet->on_pointer_moveout(position.X, position.Y, pdt, pp->Properties->PointerUpdateKind);
 			} 
 
-			if ((!handled) && (this->recent_planet != nullptr)) {
+			if ((!handled) && planet_constructed(this->recent_planet)) {
 				handled = this->recent_planet->on_pointer_moveout(px, py, pdt, pp->Properties->PointerUpdateKind);
 			}
 
@@ -1003,6 +2019,7 @@ void UniverseDisplay::on_pointer_moveout(Platform::Object^ sender, PointerRouted
 }
 
 void UniverseDisplay::on_key(Platform::Object^ sender, KeyRoutedEventArgs^ args) {
+	this->wake_up();
 	this->enter_critical_section();
 
 	if ((this->headup_planet != nullptr) || (this->recent_planet != nullptr)) {
@@ -1012,7 +2029,7 @@ void UniverseDisplay::on_key(Platform::Object^ sender, KeyRoutedEventArgs^ args)
 			handled = this->headup_planet->on_key(args->Key, false);
 		}
 
-		if ((!handled) && (this->recent_planet != nullptr)) {
+		if ((!handled) && planet_constructed(this->recent_planet)) {
 			handled = this->recent_planet->on_key(args->Key, false);
 		}
 
@@ -1023,6 +2040,7 @@ void UniverseDisplay::on_key(Platform::Object^ sender, KeyRoutedEventArgs^ args)
 }
 
 void UniverseDisplay::on_character(CoreWindow^ sender, CharacterReceivedEventArgs^ args) {
+	this->wake_up();
 	this->enter_critical_section();
 
 	if ((this->headup_planet != nullptr) || (this->recent_planet != nullptr)) {
@@ -1033,7 +2051,7 @@ void UniverseDisplay::on_character(CoreWindow^ sender, CharacterReceivedEventArg
 			handled = this->headup_planet->on_character(keycode);
 		}
 
-		if ((!handled) && (this->recent_planet != nullptr)) {
+		if ((!handled) && planet_constructed(this->recent_planet)) {
 			handled = this->recent_planet->on_character(keycode);
 
 			if (this->shortcuts_enabled) { // take temporary snapshot
@@ -1092,7 +2110,10 @@ void UniverseDisplay::notify_transfer(IPlanet* from, IPlanet* to) {
 		do {
 			PlanetInfo* info = PLANET_INFO(child);
 
-			child->on_transfer(from, to);
+			if (info->construction == PlanetConstruction::Constructed) {
+				child->on_transfer(from, to);
+			}
+
 			child = info->next;
 		} while (child != this->head_planet);
 	}
@@ -1100,7 +2121,7 @@ void UniverseDisplay::notify_transfer(IPlanet* from, IPlanet* to) {
 
 /*************************************************************************************************/
 CanvasRenderTarget^ UniverseDisplay::take_snapshot(float dpi) {
-	Size region = this->display->Size;
+	Size region = this->region_size();
 	CanvasDevice^ shared_dc = CanvasDevice::GetSharedDevice();
 	CanvasRenderTarget^ snapshot = ref new CanvasRenderTarget(shared_dc, region.Width, region.Height, dpi);
 	CanvasDrawingSession^ ds = snapshot->CreateDrawingSession();
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <unordered_map>
 #include <mutex>
+#include <atomic>
 
 #include "navigator/navigator.hpp"
 #include "timer.hxx"
@@ -28,6 +33,26 @@ namespace WarGrey::SCADA {
 
 	private enum class DisplayFit { Fill, Contain, None };
 
+	/** NOTE
+	 * `Always`: hidden planets are elapsed as the visible ones;
+	 * `Throttled`: hidden planets are elapsed once every `divisor` ticks;
+	 * `SyncOnly`: hidden planets only receive `IPlanet::on_sync` every tick.
+	 *
+	 * Either way, a planet catches up with the latest tick as soon as it is transferred to.
+	 */
+	private enum class BackgroundTicking { Always, Throttled, SyncOnly };
+
+	private enum class TransferEasing { Linear, EaseIn, EaseOut, EaseInOut };
+
+	private struct PlanetTickStatistics {
+		long long ticks;
+		long long syncs;
+		long long skips;
+		long long total_cost; // in 100ns
+		long long max_cost;
+		long long last_cost;
+	};
+
 	private ref class IDisplay abstract : public WarGrey::SCADA::ITimerListener, public WarGrey::SCADA::IUniverseNavigatorListener {
 	public:
 		virtual ~IDisplay();
@@ -69,6 +94,19 @@ namespace WarGrey::SCADA {
 		float sketch_to_application_width(float sketch_width);
 		float sketch_to_application_height(float sketch_height);
 
+	public:
+		/** NOTE
+		 * With source resolution, planets are laid out and drawn in the source size as if the display were not fitted,
+		 *  the display scales the rendering to the target instead, so sketches need no conversion at all.
+		 * It only works with `DisplayFit::Fill` and `DisplayFit::Contain`, and it should be set before planets are constructed.
+		 */
+		void use_source_resolution(bool yes);
+		bool source_resolution_used();
+
+	protected private:
+		void fill_source_size(float* width, float* height);
+		WarGrey::SCADA::DisplayFit fit_mode();
+
 	public:
 		void enter_critical_section();
 		void leave_critical_section();
@@ -81,6 +119,7 @@ namespace WarGrey::SCADA {
 
 	internal:
 		virtual void refresh(WarGrey::SCADA::IPlanet* target) = 0;
+		virtual void on_graphlet_removed(WarGrey::SCADA::IPlanet* master, WarGrey::SCADA::IGraphlet* g) {}
 
 	internal:
 		WarGrey::SCADA::Syslog* get_logger() override;
@@ -89,12 +128,17 @@ namespace WarGrey::SCADA {
 		WarGrey::SCADA::Syslog* logger;
 		std::mutex section;
 
+	private:
+		float fit_width(float sketch_width);
+		float fit_height(float sketch_height);
+
 	private:
 		DisplayFit mode;
 		float target_width;
 		float target_height;
 		float source_width;
 		float source_height;
+		bool source_resolution;
     };
 
 	private ref class UniverseDisplay : public WarGrey::SCADA::IDisplay {
@@ -124,6 +168,7 @@ namespace WarGrey::SCADA {
 		
 	internal:
 		void refresh(WarGrey::SCADA::IPlanet* target) override;
+		void on_graphlet_removed(WarGrey::SCADA::IPlanet* master, WarGrey::SCADA::IGraphlet* g) override;
 		read_only_property(WarGrey::SCADA::IPlanet*, current_planet);
 		read_only_property(WarGrey::SCADA::IHeadUpPlanet*, heads_up_planet);
 		read_only_property(WarGrey::SCADA::IUniverseNavigator*, navigator);
@@ -148,6 +193,55 @@ namespace WarGrey::SCADA {
 		void disable_predefined_shortcuts(bool yes);
 
 	public:
+		/** NOTE
+		 * With lazy construction, only the heads-up planet and the persisted page are constructed before showing,
+		 *  the rest are constructed in the order of their distances to that page, one per idle slot of the UI thread,
+		 *  or by `background_workers` threads if they claim `IPlanet::can_construct_in_background()`.
+		 * A page visited before being ready is constructed on demand, or shown as soon as its background construction is done.
+		 */
+		void use_lazy_construction(bool yes, unsigned int background_workers = 2U);
+
+	public:
+		/** NOTE
+		 * Up to `capacity` pages that are likely to be visited next stand by in idle slots of the UI thread:
+		 *  they are constructed, caught up with the latest tick and drawn once off-screen,
+		 *  so that their assets have been loaded and decoded, their caches have been primed,
+		 *  and animated transfers to them start from the snapshots taken meanwhile.
+		 * Candidates are ranked by how many times the user went there from the current page, then by ring distance.
+		 * The set is chosen again only after transfers and resizes, and outdated snapshots are taken again once every `standby_frames` ticks.
+		 */
+		void use_warm_standby(unsigned int capacity = 2U, unsigned int standby_frames = 60U);
+
+	public:
+		void set_background_ticking(WarGrey::SCADA::BackgroundTicking policy, unsigned int divisor = 15U);
+		void fill_planet_tick_statistics(WarGrey::SCADA::IPlanet* planet, WarGrey::SCADA::PlanetTickStatistics* stats);
+
+	public:
+		/** NOTE
+		 * The display drops the `timer` to `idle_rate` after `idle_frames` quiet ticks,
+		 *  and ramps it back to `active_rate` as soon as planets refresh, transfer, or the user touches the screen.
+		 */
+		void use_frame_governor(WarGrey::SCADA::Timer^ timer, int active_rate, int idle_rate = 2, unsigned int idle_frames = 60U);
+
+	public:
+		/** NOTE
+		 * Frames of the current planet and the heads-up planet are recorded after painting,
+		 *  and then encoded and streamed to `channel` by a `MirrorWorker`, at most `queue_capacity` frames wait for it.
+		 * Only graphlets that render themselves via `IDrawingContext` can be seen by the mirror.
+		 * The `channel` is owned by the caller and used by the worker thread, pass `nullptr` to stop mirroring.
+		 */
+		void mirror_to(WarGrey::SCADA::IMirrorChannel* channel, unsigned int keyframe_interval = 120U, size_t queue_capacity = 2U);
+		void fill_mirror_statistics(WarGrey::SCADA::MirrorStatistics* stats);
+
+	public:
+		/** NOTE
+		 * Planets are timed per phase, graphlet and decorator once a profiler is in use, pass `nullptr` to stop profiling.
+		 * The `profiler` is owned by the caller, and it is fed by the UI thread only.
+		 */
+		void use_profiler(WarGrey::SCADA::FrameProfiler* profiler);
+
+	public:
+		void set_transfer_easing(WarGrey::SCADA::TransferEasing easing);
 		void transfer(int delta_idx, unsigned int timeline_ms = 0, unsigned int frame_count = 4);
 		void transfer_to(Platform::String^ name, unsigned int timeline_ms = 0, unsigned int frame_count = 4);
 		void transfer_to(int idx, unsigned int timeline_ms = 0, unsigned int frame_count = 4);
@@ -185,6 +279,10 @@ namespace WarGrey::SCADA {
 			Microsoft::Graphics::Canvas::UI::Xaml::CanvasControl^ sender,
 			Microsoft::Graphics::Canvas::UI::Xaml::CanvasDrawEventArgs^ args);
 
+		void do_loaded(Platform::Object^ sender, Windows::UI::Xaml::RoutedEventArgs^ args);
+		void do_visibility_changed(Windows::UI::Core::CoreWindow^ sender, Windows::UI::Core::VisibilityChangedEventArgs^ args);
+		void rearm_redraw();
+
 	private:
 		void on_key(Platform::Object^ sender, Windows::UI::Xaml::Input::KeyRoutedEventArgs^ args);
 		void on_character(Windows::UI::Core::CoreWindow^ sender, Windows::UI::Core::CharacterReceivedEventArgs^ args);
@@ -196,6 +294,34 @@ namespace WarGrey::SCADA {
 
 	private:
 		void notify_transfer(WarGrey::SCADA::IPlanet* from, WarGrey::SCADA::IPlanet* to);
+		void elapse_hidden_planet(WarGrey::SCADA::IPlanet* planet, long long count, long long interval, long long uptime);
+		void catch_up(WarGrey::SCADA::IPlanet* planet);
+		void apply_published_states();
+
+	private:
+		void schedule_lazy_construction();
+		void construct_idle_planet();
+		void construct_on_demand(WarGrey::SCADA::IPlanet* planet, Platform::String^ how);
+		void on_planet_constructed(WarGrey::SCADA::IPlanet* planet, long long start, long long cost, unsigned int generation);
+		void settle_lazy_construction();
+		void log_construction(WarGrey::SCADA::IPlanet* planet, long long start, long long cost, Platform::String^ how);
+		WarGrey::SCADA::IPlanet* take_background_construction();
+		void abandon_background_construction();
+		void prepare_standby();
+		void schedule_standby_priming();
+		void prime_standby_planet();
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ take_standby_surface(WarGrey::SCADA::IPlanet* planet, float width, float height, float dpi);
+		void govern_frame_rate();
+		void wake_up();
+		void invalidate();
+		void mirror(float width, float height, float region_width, float region_height);
+
+	private:
+		void paint_planets(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds, float width, float height, Windows::Foundation::Rect* damage);
+		void paint_source_surface(Microsoft::Graphics::Canvas::CanvasDrawingSession^ ds);
+		Windows::Foundation::Size region_size();
+		Windows::Foundation::Rect source_destination();
+		Windows::Foundation::Point source_point(Windows::Foundation::Point position);
 
 	private:
 		Microsoft::Graphics::Canvas::UI::Xaml::CanvasControl^ display;
@@ -203,6 +329,10 @@ namespace WarGrey::SCADA {
 		WarGrey::SCADA::IPlanet* head_planet;
 		WarGrey::SCADA::IPlanet* recent_planet;
 
+	private: // NOTE: planets are indexed in the order of pushing, which is also the order of navigators
+		std::vector<WarGrey::SCADA::IPlanet*> planets;
+		std::unordered_map<std::wstring, size_t> planet_indices;
+
 	private:
 		WarGrey::SCADA::IHeadUpPlanet* headup_planet;
 		float hup_top_margin;
@@ -219,10 +349,77 @@ namespace WarGrey::SCADA {
 		Windows::Storage::ApplicationDataContainer^ universe_settings;
 		Windows::UI::Xaml::DispatcherTimer^ transfer_clock;
 		WarGrey::SCADA::IPlanet* from_planet;
-		float transfer_delta;
+		WarGrey::SCADA::TransferEasing transfer_easing;
+		unsigned int transfer_step;
+		unsigned int transfer_steps;
+		float transfer_direction;
 		float transferX;
 		float transferY;
 
+	private: // NOTE: planets are rendered once and then translated during the transfer unless they refresh meanwhile
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ from_surface;
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ to_surface;
+		std::atomic<bool> from_surface_stale;
+		std::atomic<bool> to_surface_stale;
+
+	private: // NOTE: with source resolution, planets are drawn into this surface and only their damaged regions are redrawn
+		Microsoft::Graphics::Canvas::CanvasRenderTarget^ source_surface;
+		bool source_damaged;
+
+	private:
+		WarGrey::SCADA::BackgroundTicking background_ticking;
+		unsigned int background_divisor;
+		long long last_count;
+		long long last_interval;
+		long long last_uptime;
+
+	private:
+		WarGrey::SCADA::Timer^ governor;
+		int governor_active_rate;
+		int governor_idle_rate;
+		unsigned int governor_idle_frames;
+		unsigned int quiet_frames;
+		bool idling;
+
+	private:
+		WarGrey::SCADA::IMirrorChannel* mirror_channel;
+		WarGrey::SCADA::MirrorWorker* mirror_worker;
+		WarGrey::SCADA::DisplayList* mirror_frame;
+
+	private:
+		WarGrey::SCADA::FrameProfiler* profiler;
+
+	private:
+		Microsoft::Graphics::Canvas::UI::CanvasCreateResourcesReason construction_reason;
+		std::deque<WarGrey::SCADA::IPlanet*> idle_constructions;
+		std::deque<WarGrey::SCADA::IPlanet*> background_constructions;
+		std::mutex construction_section;
+		std::vector<WarGrey::SCADA::IPlanet*> abandoned_planets; // collapsed while workers were constructing them
+		unsigned int construction_generation; // results of former generations are constructed again
+		bool lazy_construction;
+		unsigned int lazy_workers;
+		bool resources_constructed;
+		long long startup_origin;
+		unsigned int startup_pending;
+
+	private:
+		std::vector<WarGrey::SCADA::IPlanet*> standby_planets;
+		std::deque<WarGrey::SCADA::IPlanet*> standby_primings;
+		unsigned int standby_capacity;
+		unsigned int standby_frames;
+		bool standby_scheduled;
+		WarGrey::SCADA::IPlanet* standby_anchor; // the page that the standby set was chosen for
+		float standby_width;
+		float standby_height;
+		long long standby_primed_count;
+
+	private:
+		std::atomic<bool> redraw_pending;
+		std::atomic<long long> refresh_requests;
+		unsigned int pending_ticks;
+		bool ticking;
+		bool needs_redraw;
+
 	private:
 		Microsoft::Graphics::Canvas::Brushes::CanvasSolidColorBrush^ mask_color;
 		bool follow_global_mask_setting;